@@ -0,0 +1,384 @@
+// ============================================================================
+//  Benchmark_TicTacToe.cpp — Microbenchmarks for the RulEvolution hot paths
+//  Description:
+//     Measures ns/op and heap allocations/op of the board, rules, players,
+//     learning module, weights I/O and a full Game::play, and reports
+//     matches/sec. Results are written as JSON; --baseline compares against
+//     a previously saved result file and flags regressions.
+//  Build: compile with every src/*.cpp except Main_TicTacToe.cpp.
+// ============================================================================
+
+#include "../src/Board_TicTacToe.h"
+#include "../src/RulEvolutionRules.h"
+#include "../src/RulEvolutionPlayer_TicTacToe.h"
+#include "../src/StochasticPlayer_TicTacToe.h"
+#include "../src/LearningModule.h"
+#include "../src/GameHistory.h"
+#include "../src/Game_TicTacToe.h"
+#include "../src/WeightsIO.h"
+#include "../src/PolicyTable.h"
+#include "../src/BatchSimulator.h"
+#include "../src/Trajectory.h"
+#include "../src/Random.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Learner shared by the benchmarks; the engine sources keep no global state.
+static LearningModule learner(0.02);
+
+// ---------------------------------------------------------------------------
+//  Allocation counting: every global operator new bumps a counter.
+// ---------------------------------------------------------------------------
+static std::atomic<unsigned long long> g_allocs{ 0 };
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    volatile long long g_sink = 0;  ///< Defeats dead-code elimination
+
+    struct BenchResult {
+        std::string name;
+        long long iterations = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+    };
+
+    struct BenchOptions {
+        double minSeconds = 0.2;   ///< Minimum measured time per repetition
+        int repetitions = 5;       ///< Repetitions; the median is reported
+        std::string filter;        ///< Substring filter on benchmark names
+    };
+
+    /**
+     * @brief Time a body, growing the iteration count until one repetition
+     *        lasts at least minSeconds; report the median over repetitions.
+     */
+    BenchResult measure(const std::string& name, const BenchOptions& opt,
+        const std::function<void(long long)>& body) {
+        using clock = std::chrono::steady_clock;
+        long long iters = 1;
+        for (;;) {
+            auto t0 = clock::now();
+            body(iters);
+            double s = std::chrono::duration<double>(clock::now() - t0).count();
+            if (s >= opt.minSeconds || iters >= (1LL << 40)) break;
+            double grow = (s > 0.0) ? (opt.minSeconds * 1.2 / s) : 10.0;
+            iters = static_cast<long long>(iters * std::min(10.0, std::max(2.0, grow)));
+        }
+
+        std::vector<double> ns;
+        std::vector<double> allocs;
+        for (int r = 0; r < opt.repetitions; ++r) {
+            unsigned long long a0 = g_allocs.load();
+            auto t0 = clock::now();
+            body(iters);
+            double s = std::chrono::duration<double>(clock::now() - t0).count();
+            unsigned long long a1 = g_allocs.load();
+            ns.push_back(s * 1e9 / iters);
+            allocs.push_back(double(a1 - a0) / iters);
+        }
+        std::sort(ns.begin(), ns.end());
+        std::sort(allocs.begin(), allocs.end());
+
+        BenchResult res;
+        res.name = name;
+        res.iterations = iters;
+        res.nsPerOp = ns[ns.size() / 2];
+        res.allocsPerOp = allocs[allocs.size() / 2];
+        return res;
+    }
+
+    /// A mid-game position with threats for both sides (X to move).
+    Board midGameBoard() {
+        Board b;
+        b.place(0, 'X');
+        b.place(4, 'O');
+        b.place(8, 'X');
+        b.place(2, 'O');
+        return b;
+    }
+
+    /// A typical recorded history: five moves with one to three rules each.
+    GameHistory sampleHistory() {
+        GameHistory h;
+        h.addMove(4, { RULE_CENTER, RULE_PREPARATION });
+        h.addMove(0, {});
+        h.addMove(2, { RULE_CORNER, RULE_PREPARATION });
+        h.addMove(1, {});
+        h.addMove(6, { RULE_BLOCK, RULE_CORNER, RULE_PREPARATION });
+        return h;
+    }
+
+    /**
+     * @brief Parse a result file written by writeJson(): one benchmark per line.
+     */
+    std::map<std::string, BenchResult> readBaseline(const std::string& filename) {
+        std::map<std::string, BenchResult> out;
+        std::ifstream in(filename);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t n = line.find("\"name\":\"");
+            size_t t = line.find("\"nsPerOp\":");
+            size_t a = line.find("\"allocsPerOp\":");
+            if (n == std::string::npos || t == std::string::npos) continue;
+            BenchResult r;
+            size_t start = n + 8;
+            r.name = line.substr(start, line.find('"', start) - start);
+            r.nsPerOp = std::atof(line.c_str() + t + 10);
+            if (a != std::string::npos) r.allocsPerOp = std::atof(line.c_str() + a + 14);
+            out[r.name] = r;
+        }
+        return out;
+    }
+
+    void writeJson(std::ostream& out, const std::vector<BenchResult>& results, double matchesPerSec) {
+        out << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\":\"" << r.name << "\""
+                << ",\"iterations\":" << r.iterations
+                << std::fixed << std::setprecision(2)
+                << ",\"nsPerOp\":" << r.nsPerOp
+                << ",\"allocsPerOp\":" << r.allocsPerOp << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ],\n  \"matchesPerSec\": " << std::fixed << std::setprecision(1)
+            << matchesPerSec << "\n}\n";
+    }
+
+} // namespace
+
+/**
+ * @brief Benchmark entry point.
+ *
+ * Flags: --out <file>, --baseline <file>, --tolerance <pct> (default 5),
+ *        --min-time <seconds>, --reps <n>, --filter <substring>.
+ * Exit code 1 if any benchmark is slower than baseline by more than tolerance.
+ */
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    std::string outPath, baselinePath;
+    double tolerancePct = 5.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--tolerance" && hasValue) tolerancePct = std::atof(argv[++i]);
+        else if (arg == "--min-time" && hasValue) opt.minSeconds = std::atof(argv[++i]);
+        else if (arg == "--reps" && hasValue) opt.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--out file] [--baseline file] [--tolerance pct]"
+                << " [--min-time s] [--reps n] [--filter name]\n";
+            return 2;
+        }
+    }
+
+    Random::seed(12345);
+    learner.setDefaultParameters();
+    learner.recordInitialWeights();
+    learner.setVerbose(false);
+
+    const Board mid = midGameBoard();
+    const std::vector<double> weights = learner.exportPlayerWeights();
+    const GameHistory history = sampleHistory();
+    const std::string weightsFile = "bench_weights.tmp";
+
+    LearningState state;
+    state.weights = weights;
+    RulEvolutionPlayer rulev('X', state, false);
+    StochasticPlayer stoch('O');
+    stoch.setVerbose(false);
+
+    std::vector<BenchResult> results;
+    auto run = [&](const std::string& name, const std::function<void(long long)>& body) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        results.push_back(measure(name, opt, body));
+        std::cerr << std::left << std::setw(40) << name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << results.back().nsPerOp << " ns/op"
+            << std::setw(10) << std::setprecision(2) << results.back().allocsPerOp << " allocs/op\n";
+    };
+
+    run("Board::winner", [&](long long n) {
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += mid.winner();
+        g_sink = g_sink + acc;
+    });
+
+    run("Board::place", [&](long long n) {
+        Board b;
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) {
+            int idx = static_cast<int>(i % 9);
+            if (idx == 0) b.reset();
+            acc += b.place(idx, (i & 1) ? 'O' : 'X');
+        }
+        g_sink = g_sink + acc;
+    });
+
+    run("RulEvolutionRules::evaluate", [&](long long n) {
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i)
+            acc += static_cast<long long>(RulEvolutionRules::evaluate(mid, 'X', weights).size());
+        g_sink = g_sink + acc;
+    });
+
+    run("RulEvolutionPlayer::chooseMove", [&](long long n) {
+        std::vector<RuleType> rulesUsed;
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += rulev.chooseMove(mid, rulesUsed);
+        g_sink = g_sink + acc;
+    });
+
+    PolicyTable table;
+    table.compile(weights);
+    RulEvolutionPlayer compiled('X', state, false);
+    compiled.setPolicyTable(&table);
+
+    run("RulEvolutionPlayer::chooseMove (table)", [&](long long n) {
+        std::vector<RuleType> rulesUsed;
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += compiled.chooseMove(mid, rulesUsed);
+        g_sink = g_sink + acc;
+    });
+
+    run("StochasticPlayer::chooseMove", [&](long long n) {
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += stoch.chooseMove(mid);
+        g_sink = g_sink + acc;
+    });
+
+    run("LearningModule::updateFromGame", [&](long long n) {
+        LearningModule local = learner;
+        for (long long i = 0; i < n; ++i) local.updateFromGame(history, (i & 1) != 0);
+        g_sink = g_sink + static_cast<long long>(local.exportPlayerWeights()[0] * 1000);
+    });
+
+    // Per game; 1024 games per batch, normalized once per batch
+    std::vector<RuleUsage> usageBatch;
+    for (int i = 0; i < 1024; ++i) usageBatch.push_back(RuleUsage::fromHistory(history, (i & 1) != 0));
+    run("LearningModule::updateFromBatch", [&](long long n) {
+        LearningModule local = learner;
+        for (long long done = 0; done < n; done += static_cast<long long>(usageBatch.size()))
+            local.updateFromBatch(usageBatch.data(), static_cast<size_t>(std::min<long long>(n - done, usageBatch.size())));
+        g_sink = g_sink + static_cast<long long>(local.exportPlayerWeights()[0] * 1000);
+    });
+
+    run("LearningModule::normalizeWeights", [&](long long n) {
+        LearningModule local = learner;
+        for (long long i = 0; i < n; ++i) local.normalizeWeights();
+        g_sink = g_sink + static_cast<long long>(local.exportPlayerWeights()[0] * 1000);
+    });
+
+    run("WeightsIO::save", [&](long long n) {
+        for (long long i = 0; i < n; ++i) WeightsIO::save(learner, weightsFile);
+    });
+
+    run("WeightsIO::load", [&](long long n) {
+        WeightsIO::save(learner, weightsFile);
+        LearningModule local = learner;
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += WeightsIO::load(local, weightsFile);
+        g_sink = g_sink + acc;
+    });
+
+    run("Game::play", [&](long long n) {
+        Game g(&rulev, &stoch);
+        long long acc = 0;
+        for (long long i = 0; i < n; ++i) acc += g.play(false);
+        g_sink = g_sink + acc;
+    });
+
+    // Per match; the same pairing as Game::play, played in lockstep lanes
+    run("BatchSimulator::run (per match)", [&](long long n) {
+        BatchSimResult r;
+        BatchSimulator::run(PolicySpec::rulevolution(weights), PolicySpec::stochastic(), n, r);
+        g_sink = g_sink + r.winsX;
+    });
+
+    // Per sample; alternating between two learners one game apart, so every
+    // sample carries counter and weight changes
+    const std::string trajectoryFile = "bench_trajectory.tmp";
+    LearningModule nextLearner = learner;
+    nextLearner.updateFromGame(history, true);
+    run("TrajectoryWriter::sample", [&](long long n) {
+        std::remove(trajectoryFile.c_str());
+        Trajectory trajectory;
+        trajectory.open(trajectoryFile, 1);
+        TrajectoryWriter writer(trajectory, 0);
+        for (long long i = 0; i < n; ++i)
+            writer.sample((i & 1) ? nextLearner : learner, static_cast<std::uint64_t>(i));
+    });
+    std::remove(trajectoryFile.c_str());
+    std::remove(weightsFile.c_str());
+
+    double matchesPerSec = 0.0;
+    for (const BenchResult& r : results)
+        if (r.name == "Game::play" && r.nsPerOp > 0.0) matchesPerSec = 1e9 / r.nsPerOp;
+
+    if (outPath.empty()) {
+        writeJson(std::cout, results, matchesPerSec);
+    }
+    else {
+        std::ofstream out(outPath, std::ios::trunc);
+        writeJson(out, results, matchesPerSec);
+    }
+
+    // === COMPARISON AGAINST BASELINE ===
+    if (baselinePath.empty()) return 0;
+
+    std::map<std::string, BenchResult> baseline = readBaseline(baselinePath);
+    if (baseline.empty()) {
+        std::cerr << "[ERROR] No benchmarks found in baseline " << baselinePath << "\n";
+        return 2;
+    }
+
+    int regressions = 0;
+    std::cerr << "\n=== COMPARISON vs " << baselinePath << " (tolerance "
+        << tolerancePct << "%) ===\n";
+    for (const BenchResult& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second.nsPerOp <= 0.0) {
+            std::cerr << std::left << std::setw(40) << r.name << "  (not in baseline)\n";
+            continue;
+        }
+        double deltaPct = (r.nsPerOp / it->second.nsPerOp - 1.0) * 100.0;
+        const char* verdict = "ok";
+        if (deltaPct > tolerancePct) { verdict = "REGRESSION"; ++regressions; }
+        else if (deltaPct < -tolerancePct) verdict = "improved";
+        std::cerr << std::left << std::setw(40) << r.name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << it->second.nsPerOp << " -> " << std::setw(10) << r.nsPerOp
+            << " ns/op  " << std::showpos << std::setw(7) << deltaPct << std::noshowpos << "%  "
+            << std::setprecision(2) << it->second.allocsPerOp << " -> " << r.allocsPerOp
+            << " allocs/op  " << verdict << "\n";
+    }
+    return regressions > 0 ? 1 : 0;
+}
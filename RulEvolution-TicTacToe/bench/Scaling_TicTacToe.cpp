@@ -0,0 +1,352 @@
+// ============================================================================
+//  Scaling_TicTacToe.cpp — Strong and weak scaling harness
+//  Description:
+//     Runs the Super-Training and Standard-mode workloads over a sweep of
+//     OpenMP thread counts and match counts, several repetitions each, and
+//     reports mean time, standard deviation, speedup and parallel efficiency
+//     as a markdown table and CSV. --readme regenerates the performance
+//     table of README_TicTacToe.md (between the scaling markers).
+//     Strong scaling: fixed match count, more threads.
+//     Weak scaling: fixed matches per thread.
+//  Build: compile with every src/*.cpp except Main_TicTacToe.cpp.
+// ============================================================================
+
+#include "../src/LearningModule.h"
+#include "../src/SuperTraining.h"
+#include "../src/Game_TicTacToe.h"
+#include "../src/StochasticPlayer_TicTacToe.h"
+#include "../src/RulEvolutionPlayer_TicTacToe.h"
+#include "../src/Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    const char* README_BEGIN = "<!-- scaling:begin -->";
+    const char* README_END = "<!-- scaling:end -->";
+
+    struct ScalingOptions {
+        std::vector<int> threads;               ///< Thread counts (default: powers of two up to the cores)
+        std::vector<int> strongMatches{ 20000, 100000 };  ///< Match counts for strong scaling
+        std::vector<int> weakMatches{ 10000 };  ///< Matches per thread for weak scaling
+        std::vector<std::string> workloads{ "super", "standard" };
+        int repetitions = 5;
+        std::uint64_t seed = 12345;
+    };
+
+    /// One cell of the sweep: a workload at one thread count and match count.
+    struct ScalingRow {
+        std::string workload;
+        std::string scaling;     ///< "strong" or "weak"
+        int threads = 1;
+        int matches = 0;
+        int series = 0;          ///< Strong: matches; weak: matches per thread
+        std::vector<double> seconds;
+        double mean = 0.0, stddev = 0.0, best = 0.0;
+        double speedup = 0.0, efficiency = 0.0;
+    };
+
+    bool parseList(const std::string& text, std::vector<int>& out) {
+        out.clear();
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            int v = std::atoi(item.c_str());
+            if (v <= 0) return false;
+            out.push_back(v);
+        }
+        return !out.empty();
+    }
+
+    std::vector<std::string> splitNames(const std::string& text) {
+        std::vector<std::string> out;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) out.push_back(item);
+        return out;
+    }
+
+    const char* workloadLabel(const std::string& workload) {
+        return workload == "super" ? "Super-Training" : "Standard";
+    }
+
+    /**
+     * @brief One timed run from a fresh learner and a fixed seed, so every
+     *        thread count replays the same match stream.
+     */
+    double runOnce(const std::string& workload, int threads, int matches, std::uint64_t seed) {
+#ifdef USE_OMP
+        omp_set_num_threads(threads);
+#else
+        (void)threads;
+#endif
+        Random::seed(seed);
+        LearningModule learner(0.02);
+        learner.setDefaultParameters();
+        learner.setVerbose(false);
+
+        auto start = std::chrono::steady_clock::now();
+        if (workload == "super") {
+            // Scenario 1, one worker learner per thread.
+            SuperTraining::run(learner, 1, matches, false);
+        }
+        else {
+            // Standard mode without console traces: one match at a time,
+            // parallelism only inside the rule evaluation.
+            StochasticPlayer x('X');
+            RulEvolutionPlayer o('O', LearningState(), false);
+            x.setVerbose(false);
+            for (int i = 0; i < matches; ++i) {
+                Game g(&x, &o, &learner);
+                GameHistory history;
+                g.playAndLearn(history, false);
+            }
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void summarize(ScalingRow& row) {
+        double sum = 0.0;
+        for (double s : row.seconds) sum += s;
+        row.mean = sum / row.seconds.size();
+        double sq = 0.0;
+        for (double s : row.seconds) sq += (s - row.mean) * (s - row.mean);
+        row.stddev = row.seconds.size() > 1 ? std::sqrt(sq / (row.seconds.size() - 1)) : 0.0;
+        row.best = *std::min_element(row.seconds.begin(), row.seconds.end());
+    }
+
+    /**
+     * @brief Speedup and efficiency against the smallest thread count of the
+     *        same series (assumed to scale linearly below it).
+     *        Strong: speedup = T(base) / T(p) * base, efficiency = speedup / p.
+     *        Weak: efficiency = T(base) / T(p), scaled speedup = efficiency * p.
+     */
+    void scale(std::vector<ScalingRow>& rows) {
+        for (ScalingRow& r : rows) {
+            const ScalingRow* base = nullptr;
+            for (const ScalingRow& b : rows) {
+                bool sameSeries = b.workload == r.workload && b.scaling == r.scaling
+                    && b.series == r.series;
+                if (sameSeries && (!base || b.threads < base->threads)) base = &b;
+            }
+            if (!base || r.mean <= 0.0) continue;
+            if (r.scaling == "strong") {
+                r.speedup = base->mean / r.mean * base->threads;
+                r.efficiency = r.speedup / r.threads;
+            }
+            else {
+                r.efficiency = base->mean / r.mean;
+                r.speedup = r.efficiency * r.threads;
+            }
+        }
+    }
+
+    void writeCsv(std::ostream& out, const std::vector<ScalingRow>& rows) {
+        out << "workload,scaling,threads,matches,reps,mean_s,stddev_s,min_s,matches_per_sec,speedup,efficiency\n";
+        for (const ScalingRow& r : rows) {
+            out << r.workload << "," << r.scaling << "," << r.threads << "," << r.matches << ","
+                << r.seconds.size() << std::fixed << std::setprecision(6)
+                << "," << r.mean << "," << r.stddev << "," << r.best
+                << std::setprecision(1) << "," << (r.mean > 0.0 ? r.matches / r.mean : 0.0)
+                << std::setprecision(3) << "," << r.speedup << "," << r.efficiency << "\n";
+        }
+    }
+
+    void writeMarkdown(std::ostream& out, const std::vector<ScalingRow>& rows, int repetitions) {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        out << "Generated by `bench/Scaling_TicTacToe.cpp` on " << (cores > 0 ? cores : 1)
+            << " hardware thread" << (cores > 1 ? "s" : "")
+#ifdef USE_OMP
+            << " (OpenMP)"
+#else
+            << " (sequential build)"
+#endif
+            << ", mean of " << repetitions << " repetitions ± standard deviation.\n\n"
+            << "| Mode | Scaling | Threads | Matches | Time (s) | Matches/s | Speedup | Efficiency |\n"
+            << "|------|---------|---------|---------|----------|-----------|---------|------------|\n";
+        for (const ScalingRow& r : rows) {
+            out << "| " << workloadLabel(r.workload) << " | " << r.scaling << " | " << r.threads
+                << " | " << r.matches << std::fixed << std::setprecision(3)
+                << " | " << r.mean << " ± " << r.stddev
+                << std::setprecision(0) << " | " << (r.mean > 0.0 ? r.matches / r.mean : 0.0)
+                << std::setprecision(2) << " | " << r.speedup
+                << std::setprecision(0) << " | " << r.efficiency * 100.0 << "% |\n";
+        }
+    }
+
+    /// Replace the text between the scaling markers of a README.
+    bool updateReadme(const std::string& path, const std::string& table) {
+        std::ifstream in(path);
+        if (!in.good()) return false;
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string text = buffer.str();
+        std::size_t begin = text.find(README_BEGIN), end = text.find(README_END);
+        if (begin == std::string::npos || end == std::string::npos || end < begin) {
+            std::cerr << "[ERROR] " << path << " has no " << README_BEGIN << " / " << README_END << " markers\n";
+            return false;
+        }
+        begin += std::string(README_BEGIN).size();
+        text = text.substr(0, begin) + "\n" + table + text.substr(end);
+        std::ofstream out(path, std::ios::trunc);
+        out << text;
+        return out.good();
+    }
+
+} // namespace
+
+/**
+ * @brief Scaling harness entry point.
+ *
+ * Flags: --threads <list>, --matches <list> (strong scaling),
+ *        --weak <list> (matches per thread), --workloads super,standard,
+ *        --reps <n>, --seed <n>, --csv <file>, --markdown <file>,
+ *        --readme <README_TicTacToe.md>. Lists are comma-separated;
+ *        an empty --matches or --weak list ("0") skips that scaling mode.
+ */
+int main(int argc, char* argv[]) {
+    ScalingOptions opt;
+    std::string csvPath, markdownPath, readmePath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        bool ok = true;
+        if (arg == "--threads" && hasValue) ok = parseList(argv[++i], opt.threads);
+        else if (arg == "--matches" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "0") opt.strongMatches.clear();
+            else ok = parseList(v, opt.strongMatches);
+        }
+        else if (arg == "--weak" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "0") opt.weakMatches.clear();
+            else ok = parseList(v, opt.weakMatches);
+        }
+        else if (arg == "--workloads" && hasValue) opt.workloads = splitNames(argv[++i]);
+        else if (arg == "--reps" && hasValue) opt.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) opt.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+        else if (arg == "--markdown" && hasValue) markdownPath = argv[++i];
+        else if (arg == "--readme" && hasValue) readmePath = argv[++i];
+        else ok = false;
+        if (!ok) {
+            std::cerr << "Usage: " << argv[0]
+                << " [--threads 1,2,4] [--matches 20000,100000] [--weak 10000]"
+                << " [--workloads super,standard] [--reps n] [--seed n]"
+                << " [--csv file] [--markdown file] [--readme file]\n";
+            return 2;
+        }
+    }
+
+    for (const std::string& w : opt.workloads) {
+        if (w != "super" && w != "standard") {
+            std::cerr << "[ERROR] Unknown workload " << w << " (super|standard)\n";
+            return 2;
+        }
+    }
+
+    if (opt.threads.empty()) {
+        int maxThreads = 1;
+#ifdef USE_OMP
+        maxThreads = omp_get_num_procs();
+#endif
+        for (int t = 1; t <= maxThreads; t *= 2) opt.threads.push_back(t);
+        if (opt.threads.back() != maxThreads) opt.threads.push_back(maxThreads);
+    }
+#ifndef USE_OMP
+    if (opt.threads.size() > 1 || opt.threads[0] != 1)
+        std::cerr << "[WARN] Sequential build: every thread count runs on one thread\n";
+#endif
+    std::sort(opt.threads.begin(), opt.threads.end());
+
+    // A table with more threads than cores measures oversubscription, not
+    // scaling: do not let it replace the README's numbers.
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (!readmePath.empty() && cores > 0 && opt.threads.back() > cores) {
+        std::cerr << "[ERROR] --readme needs at least " << opt.threads.back()
+            << " hardware threads (this machine has " << cores << ")\n";
+        return 2;
+    }
+
+    // === SWEEP ===
+    std::vector<ScalingRow> rows;
+    for (const std::string& workload : opt.workloads) {
+        for (int matches : opt.strongMatches) {
+            for (int t : opt.threads) {
+                ScalingRow r;
+                r.workload = workload;
+                r.scaling = "strong";
+                r.threads = t;
+                r.matches = matches;
+                r.series = matches;
+                rows.push_back(r);
+            }
+        }
+        for (int perThread : opt.weakMatches) {
+            for (int t : opt.threads) {
+                ScalingRow r;
+                r.workload = workload;
+                r.scaling = "weak";
+                r.threads = t;
+                r.matches = perThread * t;
+                r.series = perThread;
+                rows.push_back(r);
+            }
+        }
+    }
+    // Repetitions are interleaved over the sweep so slow drifts (thermal,
+    // other load) spread over all rows instead of biasing one.
+    for (int rep = 0; rep < opt.repetitions; ++rep) {
+        for (ScalingRow& r : rows) {
+            r.seconds.push_back(runOnce(r.workload, r.threads, r.matches, opt.seed));
+            std::cerr << "[INFO] " << workloadLabel(r.workload) << " " << r.scaling
+                << " threads=" << r.threads << " matches=" << r.matches
+                << " rep " << (rep + 1) << "/" << opt.repetitions << ": "
+                << r.seconds.back() << " s\n";
+        }
+    }
+    for (ScalingRow& r : rows) summarize(r);
+    scale(rows);
+
+    // === OUTPUT ===
+    std::ostringstream table;
+    writeMarkdown(table, rows, opt.repetitions);
+    std::cout << table.str();
+
+    if (!csvPath.empty()) {
+        std::ofstream out(csvPath, std::ios::trunc);
+        writeCsv(out, rows);
+        if (!out.good()) {
+            std::cerr << "[ERROR] Cannot write " << csvPath << "\n";
+            return 1;
+        }
+    }
+    if (!markdownPath.empty()) {
+        std::ofstream out(markdownPath, std::ios::trunc);
+        out << table.str();
+        if (!out.good()) {
+            std::cerr << "[ERROR] Cannot write " << markdownPath << "\n";
+            return 1;
+        }
+    }
+    if (!readmePath.empty() && !updateReadme(readmePath, table.str())) {
+        std::cerr << "[ERROR] Cannot update " << readmePath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1063 @@
+// ================================================================
+//  BatchRunner.cpp — Headless job runner (OpenMP Optional)
+//  Notes:
+//    - jobs run sequentially; each job parallelizes internally;
+//    - results are JSON lines, diagnostics go to std::cerr.
+// ================================================================
+#include "BatchRunner.h"
+#include "SuperTraining.h"
+#include "MergeStrategy.h"
+#include "EvolutionarySearch.h"
+#include "Game_TicTacToe.h"
+#include "StochasticPlayer_TicTacToe.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "WeightsIO.h"
+#include "Metrics.h"
+#include "ExactEvaluator.h"
+#include "PolicyTable.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include "Checkpoint.h"
+#include "ReplayTrainer.h"
+#include "ConvergenceMonitor.h"
+#include "Tournament.h"
+#include "PairedComparison.h"
+#include "BatchSimulator.h"
+#include "PlayerPool.h"
+#include "MatchArena.h"
+#include "Trace.h"
+#include "SuggestionServer.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <ctime>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    const char* const RULE_LABELS[RULE_COUNT] = { "win", "block", "center", "corner", "side", "preparation" };
+
+    std::string toLower(std::string s) {
+        for (size_t i = 0; i < s.size(); ++i)
+            s[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+        return s;
+    }
+
+    bool parseInt(const std::string& text, int& value) {
+        std::istringstream iss(text);
+        return (iss >> value) && iss.eof();
+    }
+
+    bool parseDouble(const std::string& text, double& value) {
+        std::istringstream iss(text);
+        return (iss >> value) && iss.eof() && value > 0.0;
+    }
+
+    /// Comma-separated list of positive numbers ("0.01,0.02").
+    bool parseDoubleList(const std::string& text, std::vector<double>& values) {
+        values.clear();
+        std::istringstream iss(text);
+        std::string item;
+        double v = 0.0;
+        while (std::getline(iss, item, ','))
+            if (parseDouble(item, v)) values.push_back(v);
+            else return false;
+        return !values.empty();
+    }
+
+    bool parseStep(const std::string& text, std::uint64_t& value) {
+        std::istringstream iss(text);
+        return (iss >> value) && iss.eof();
+    }
+
+    /// Set the learning rate and the threshold of every rule in use.
+    void applyParams(LearningModule& learner, double eta, double threshold) {
+        learner.setLearningRate(eta);
+        for (int r = 0; r < RULE_COUNT; ++r)
+            learner.setThreshold(static_cast<RuleType>(r), threshold);
+    }
+
+    /// Minimal JSON string escaping (quotes, backslashes, control chars).
+    std::string jsonString(const std::string& s) {
+        std::ostringstream oss;
+        oss << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') oss << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20) oss << ' ';
+            else oss << c;
+        }
+        oss << '"';
+        return oss.str();
+    }
+
+    std::string jsonWeights(const LearningModule& learner) {
+        std::vector<double> w = learner.exportPlayerWeights();
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(6) << '{';
+        for (size_t i = 0; i < w.size(); ++i) {
+            if (i) oss << ',';
+            oss << '"' << (i + 1) << "\":" << w[i];
+        }
+        oss << '}';
+        return oss.str();
+    }
+
+    double wallTime() {
+#ifdef USE_OMP
+        return omp_get_wtime();
+#else
+        return double(std::clock()) / CLOCKS_PER_SEC;
+#endif
+    }
+
+} // namespace
+
+BatchRunner::BatchRunner(LearningModule& learner)
+    : learner(learner) {
+}
+
+bool BatchRunner::parseJob(const std::string& line, const std::string& source, BatchJob& job) {
+    std::istringstream iss(line);
+    std::string word;
+    if (!(iss >> word)) return false;
+
+    job.command = toLower(word);
+    job.args.clear();
+    job.source = source;
+    while (iss >> word) job.args.push_back(word);
+
+    int n = 0;
+    if (job.command == "reset")
+        return job.args.empty();
+    if (job.command == "load" || job.command == "save")
+        return job.args.size() == 1;
+    if (job.command == "seed")
+        return job.args.size() == 1 && parseInt(job.args[0], n);
+    if (job.command == "train") {
+        if (job.args.size() < 2 || job.args.size() > 4) return false;
+        if (job.args.size() >= 3) job.args[2] = toLower(job.args[2]);
+        return parseInt(job.args[0], n) && (n == 1 || n == 2)
+            && parseInt(job.args[1], n) && n > 0
+            && (job.args.size() < 3 || MergeStrategy::byName(job.args[2]))
+            && (job.args.size() < 4 || (parseInt(job.args[3], n) && n > 0));
+    }
+    if (job.command == "logstats")
+        return job.args.size() == 1;
+    if (job.command == "trajectory") {
+        std::uint64_t step = 0;
+        return job.args.size() == 1
+            || ((job.args.size() == 3 || job.args.size() == 4)
+                && parseStep(job.args[1], step) && parseStep(job.args[2], step));
+    }
+    if (job.command == "converge") {
+        if (job.args.size() == 1) return toLower(job.args[0]) == "off";
+        double v = 0.0;
+        return job.args.size() >= 2 && job.args.size() <= 5
+            && parseDouble(job.args[0], v) && parseDouble(job.args[1], v)
+            && (job.args.size() < 3 || parseDouble(job.args[2], v))
+            && (job.args.size() < 4 || (parseInt(job.args[3], n) && n > 0))
+            && (job.args.size() < 5 || (parseInt(job.args[4], n) && n > 0));
+    }
+    if (job.command == "params") {
+        double v = 0.0;
+        return job.args.size() == 2 && parseDouble(job.args[0], v) && parseDouble(job.args[1], v);
+    }
+    if (job.command == "replay") {
+        if (job.args.empty() || job.args.size() > 3) return false;
+        if (job.args.size() == 3) job.args[2] = toLower(job.args[2]);
+        return (job.args.size() < 2 || (parseInt(job.args[1], n) && n > 0))
+            && (job.args.size() < 3 || MergeStrategy::byName(job.args[2]));
+    }
+    if (job.command == "sweep") {
+        std::vector<double> v;
+        return job.args.size() == 3 && parseDoubleList(job.args[1], v) && parseDoubleList(job.args[2], v);
+    }
+    if (job.command == "compile")
+        return job.args.size() == 1 || (job.args.size() == 2 && toLower(job.args[1]) == "symmetric");
+    if (job.command == "evaluate") {
+        if (job.args.size() < 2 || job.args.size() > 3 || !parseInt(job.args[1], n) || n <= 0) return false;
+        job.args[0] = toLower(job.args[0]);
+        return job.args[0] == "stochastic" || job.args[0] == "rulevolution";
+    }
+    if (job.command == "evolve") {
+        if (job.args.size() < 3 || job.args.size() > 5) return false;
+        job.args[0] = toLower(job.args[0]);
+        return (job.args[0] == "stochastic" || job.args[0] == "rulevolution" || job.args[0] == "perfect")
+            && parseInt(job.args[1], n) && n > 0
+            && parseInt(job.args[2], n) && n >= 2
+            && (job.args.size() < 4 || (parseInt(job.args[3], n) && n >= 0));
+    }
+    if (job.command == "ab")
+        return (job.args.size() == 4 || job.args.size() == 5) && parseInt(job.args[3], n) && n > 0
+            && (job.args.size() < 5 || (parseInt(job.args[4], n) && n > 0));
+    if (job.command == "tournament")
+        return job.args.size() >= 4 && parseInt(job.args[0], n) && n > 0;
+    if (job.command == "simulate")
+        return (job.args.size() == 3 || job.args.size() == 4) && parseInt(job.args[2], n) && n > 0
+            && (job.args.size() < 4 || (parseInt(job.args[3], n) && n > 0));
+    if (job.command == "exact") {
+        if (job.args.empty()) return false;
+        job.args[0] = toLower(job.args[0]);
+        return job.args[0] == "stochastic" || job.args[0] == "rulevolution"
+            || job.args[0] == "self" || job.args[0] == "perfect";
+    }
+    return false;
+}
+
+bool BatchRunner::addJob(const std::string& line, const std::string& source) {
+    BatchJob job;
+    if (!parseJob(line, source, job)) {
+        std::cerr << "[ERROR] " << source << ": invalid job \"" << line << "\"\n";
+        return false;
+    }
+    jobs.push_back(job);
+    return true;
+}
+
+bool BatchRunner::addJobFile(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.good()) {
+        std::cerr << "[ERROR] Cannot read job file " << filename << "\n";
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+        ok = addJob(line, filename + ":" + std::to_string(lineNo)) && ok;
+    }
+    return ok;
+}
+
+int BatchRunner::run(std::ostream& results, bool verbose) {
+    learner.setVerbose(verbose);
+
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        int index = static_cast<int>(i) + 1;
+        if (static_cast<int>(i) < resumeJob) {
+            // Settings jobs hold no learner state: re-apply them.
+            if (jobs[i].command == "converge") applyConvergence(jobs[i]);
+            results << "{\"job\":" << index
+                << ",\"cmd\":" << jsonString(jobs[i].command)
+                << ",\"source\":" << jsonString(jobs[i].source)
+                << ",\"skipped\":\"checkpoint\"}\n";
+            continue;
+        }
+        if (!runJob(jobs[i], results, index, verbose))
+            ++failed;
+        resumeMatches = 0;
+        submitCheckpoint(index, 0);
+        publishWeights();
+        if (trajectory.isOpen()) {
+            if (trajectory.learnerChanged(learner)) trajectory.recordLearner(learner);
+            trajectory.flush();
+        }
+        results.flush();
+    }
+    return failed;
+}
+
+void BatchRunner::applyConvergence(const BatchJob& job) {
+    earlyStop = !(job.args.size() == 1 && toLower(job.args[0]) == "off");
+    convergence = ConvergenceConfig();
+    if (!earlyStop) return;
+    parseDouble(job.args[0], convergence.weightTolerance);
+    parseDouble(job.args[1], convergence.winMargin);
+    if (job.args.size() >= 3) parseDouble(job.args[2], convergence.crossingTolerance);
+    if (job.args.size() >= 4) parseInt(job.args[3], convergence.patience);
+    if (job.args.size() >= 5) parseInt(job.args[4], convergence.roundMatches);
+}
+
+bool BatchRunner::enablePublish(const std::string& path, int matches) {
+    if (!publishStore.open(path)) return false;
+    publishRound = std::max(1, matches);
+    published.clear();
+    publishWeights();
+    return true;
+}
+
+void BatchRunner::publishWeights() {
+    if (!publishStore.isOpen()) return;
+    std::vector<double> w = learner.exportPlayerWeights();
+    if (w == published) return;
+    publishStore.publish(w);
+    published = w;
+}
+
+void BatchRunner::enableCheckpoints(const std::string& path, double intervalSeconds, int matches) {
+    roundMatches = std::max(1, matches);
+    checkpoints.start(path, intervalSeconds);
+}
+
+bool BatchRunner::resume(const std::string& path) {
+    CheckpointData data;
+    data.learner = learner;
+    if (!Checkpoint::load(path, data)) {
+        std::cerr << "[ERROR] Cannot resume: " << path << " is missing, corrupt or of another version\n";
+        return false;
+    }
+    if (data.jobsHash != jobsHash()) {
+        std::cerr << "[ERROR] Cannot resume: " << path << " was written for a different job list\n";
+        return false;
+    }
+    learner = data.learner;
+    Random::restore(data.random);
+    resumeJob = data.jobIndex;
+    resumeMatches = data.jobMatches;
+    std::cerr << "[INFO] Resuming at job " << (resumeJob + 1) << " after "
+        << resumeMatches << " matches\n";
+    return true;
+}
+
+bool BatchRunner::enableGameLog(const std::string& path) {
+    if (!gameLog.open(path)) {
+        std::cerr << "[ERROR] Cannot open game log " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::enableAnalytics(const std::string& path, double intervalSeconds) {
+    if (!analytics.start(path, intervalSeconds)) {
+        std::cerr << "[ERROR] Cannot write training analytics to " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::enableTrajectory(const std::string& path, int interval) {
+    if (!trajectory.open(path, interval)) {
+        std::cerr << "[ERROR] Cannot open trajectory " << path << "\n";
+        return false;
+    }
+    if (trajectory.learnerChanged(learner)) trajectory.recordLearner(learner);
+    return true;
+}
+
+std::uint64_t BatchRunner::jobsHash() const {
+    std::string text;
+    for (const BatchJob& job : jobs) {
+        text += job.command;
+        for (const std::string& arg : job.args) text += " " + arg;
+        text += "\n";
+    }
+    return Checkpoint::hash(text);
+}
+
+void BatchRunner::submitCheckpoint(int jobIndex, long long jobMatches) {
+    if (!checkpoints.isRunning()) return;
+    CheckpointData data;
+    data.learner = learner;
+    data.random = Random::state();
+    data.jobsHash = jobsHash();
+    data.jobIndex = jobIndex;
+    data.jobMatches = jobMatches;
+    checkpoints.submit(data);
+}
+
+bool BatchRunner::runJob(const BatchJob& job, std::ostream& results, int index, bool verbose) {
+    TraceSpan span(TRACE_JOB, static_cast<std::uint32_t>(index));
+    std::ostringstream out;
+    out << "{\"job\":" << index
+        << ",\"cmd\":" << jsonString(job.command)
+        << ",\"source\":" << jsonString(job.source);
+
+    bool ok = true;
+    double start = wallTime();
+
+    if (job.command == "reset") {
+        learner.setDefaultParameters();
+        learner.resetCounters();
+        learner.recordInitialWeights();
+    }
+    else if (job.command == "load") {
+        ok = WeightsIO::load(learner, job.args[0]);
+        if (ok) learner.recordInitialWeights();
+        out << ",\"path\":" << jsonString(job.args[0]);
+    }
+    else if (job.command == "save") {
+        ok = WeightsIO::save(learner, job.args[0]);
+        out << ",\"path\":" << jsonString(job.args[0]);
+    }
+    else if (job.command == "seed") {
+        int seed = 0;
+        parseInt(job.args[0], seed);
+        Random::seed(static_cast<std::uint64_t>(seed));
+        out << ",\"seed\":" << seed;
+    }
+    else if (job.command == "train") {
+        int scenario = 0, matches = 0;
+        parseInt(job.args[0], scenario);
+        parseInt(job.args[1], matches);
+
+        int workers = 0;
+        const MergeStrategy* merge = &MergeStrategy::defaultStrategy();
+        if (job.args.size() >= 3) merge = MergeStrategy::byName(job.args[2]);
+        if (job.args.size() >= 4) parseInt(job.args[3], workers);
+
+        // With checkpoints the job runs in rounds, each followed by a snapshot;
+        // with early stop every round ends with a convergence check.
+        SuperTrainingResult r;
+        long long done = resumeMatches;
+        if (done > 0) out << ",\"resumedAt\":" << done;
+        int roundSize = roundMatches > 0 ? roundMatches : (earlyStop ? convergence.roundMatches : publishRound);
+        ConvergenceMonitor monitor(convergence);
+        bool converged = false;
+        while (done < matches && !converged) {
+            int round = static_cast<int>(matches - done);
+            if (roundSize > 0) round = std::min(round, roundSize);
+            RuleArray before = learner.weights();
+            SuperTrainingResult part = SuperTraining::run(learner, scenario, round, verbose, merge, workers,
+                gameLog.isOpen() ? &gameLog : nullptr, &analytics, trajectory.isOpen() ? &trajectory : nullptr);
+            r.matches += part.matches;
+            r.workers = part.workers;
+            r.winsX += part.winsX;
+            r.winsO += part.winsO;
+            r.draws += part.draws;
+            r.elapsedSeconds += part.elapsedSeconds;
+            done += round;
+            submitCheckpoint(index - 1, done);
+            publishWeights();
+            if (earlyStop) converged = monitor.observe(before, learner, part, scenario);
+        }
+        out << ",\"scenario\":" << scenario
+            << ",\"merge\":" << jsonString(merge->name())
+            << ",\"workers\":" << r.workers
+            << ",\"matches\":" << r.matches
+            << ",\"winsX\":" << r.winsX
+            << ",\"winsO\":" << r.winsO
+            << ",\"draws\":" << r.draws
+            << ",\"matchesPerSec\":" << (r.elapsedSeconds > 0.0 ? r.matches / r.elapsedSeconds : 0.0);
+        if (earlyStop) {
+            const ConvergenceSample& c = monitor.last();
+            out << ",\"converged\":" << (converged ? "true" : "false")
+                << ",\"matchesSaved\":" << (matches - done)
+                << ",\"weightDelta\":" << c.weightDelta
+                << ",\"crossingRate\":" << c.crossingRate
+                << ",\"winRate\":" << c.winRate;
+        }
+    }
+    else if (job.command == "evaluate") {
+        int matches = 0;
+        parseInt(job.args[1], matches);
+
+        // Learned weights play X without learning; the opponent plays O.
+        LearningState state;
+        state.weights = learner.exportPlayerWeights();
+        RulEvolutionPlayer candidate('X', state, verbose);
+        PolicyTable table;
+        if (job.args.size() == 3) {
+            ok = table.map(job.args[2]);
+            if (ok) candidate.setPolicyTable(&table);
+            else std::cerr << "[ERROR] " << job.source << ": cannot map policy table " << job.args[2] << " (missing or corrupt)\n";
+            out << ",\"table\":" << jsonString(job.args[2]);
+        }
+        Player* opponent = nullptr;
+        if (job.args[0] == "stochastic")
+            opponent = new StochasticPlayer('O');
+        else
+            opponent = new RulEvolutionPlayer('O', LearningState(), verbose);
+        opponent->setVerbose(verbose);
+
+        int wins = 0, losses = 0, draws = 0;
+        int threads = 1;
+#ifdef USE_OMP
+        threads = omp_get_max_threads();
+#endif
+        PlayerPool players(candidate, *opponent, threads);
+        const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel reduction(+:wins,losses,draws)
+#endif
+        {
+            int tid = 0;
+#ifdef USE_OMP
+            tid = omp_get_thread_num();
+#endif
+            ContextBinding bindContext(context);
+            MatchArena arena;
+            ArenaBinding bindArena(arena);
+            Game g(&players.x(tid), &players.o(tid));
+#ifdef USE_OMP
+#pragma omp for
+#endif
+            for (int i = 0; i < matches; ++i) {
+                char winner = g.play(false);
+                arena.reset();
+                if (winner == 'X') wins++;
+                else if (winner == 'O') losses++;
+                else draws++;
+            }
+        }
+        delete opponent;
+
+        out << ",\"opponent\":" << jsonString(job.args[0])
+            << ",\"matches\":" << matches
+            << ",\"wins\":" << wins
+            << ",\"draws\":" << draws
+            << ",\"losses\":" << losses
+            << std::fixed << std::setprecision(6)
+            << ",\"winRate\":" << double(wins) / matches;
+    }
+
+    else if (job.command == "evolve") {
+        EvolutionConfig config;
+        const std::string& opp = job.args[0];
+        if (opp == "perfect") config.opponent = PolicySpec::perfect();
+        else if (opp == "rulevolution") config.opponent = PolicySpec::rulevolution(std::vector<double>(5, 0.5));
+        parseInt(job.args[1], config.generations);
+        parseInt(job.args[2], config.populationSize);
+        if (job.args.size() >= 4) parseInt(job.args[3], config.matchesPerEval);
+        config.seed = static_cast<unsigned>(Random::next());
+
+        // The learner's weights seed the population; the winner replaces them.
+        EvolutionarySearch search(config);
+        search.initialize(learner.exportPlayerWeights());
+        search.run(verbose);
+        const Individual& best = search.best();
+        learner.importPlayerWeights(best.state.weights);
+        learner.normalizeWeights();
+
+        out << ",\"opponent\":" << jsonString(opp)
+            << ",\"generations\":" << search.generation()
+            << ",\"population\":" << config.populationSize
+            << ",\"evaluations\":" << search.evaluations()
+            << std::fixed << std::setprecision(6)
+            << ",\"fitness\":" << best.fitness
+            << ",\"win\":" << best.win
+            << ",\"draw\":" << best.draw
+            << ",\"loss\":" << best.loss;
+        if (job.args.size() == 5) {
+            ok = search.exportElites(job.args[4]);
+            out << ",\"elites\":" << jsonString(job.args[4]);
+        }
+    }
+
+    else if (job.command == "converge") {
+        applyConvergence(job);
+        out << ",\"earlyStop\":" << (earlyStop ? "true" : "false");
+        if (earlyStop)
+            out << ",\"weightTolerance\":" << convergence.weightTolerance
+                << ",\"winMargin\":" << convergence.winMargin
+                << ",\"crossingTolerance\":" << convergence.crossingTolerance
+                << ",\"patience\":" << convergence.patience
+                << ",\"round\":" << convergence.roundMatches;
+    }
+    else if (job.command == "params") {
+        double eta = 0.0, threshold = 0.0;
+        parseDouble(job.args[0], eta);
+        parseDouble(job.args[1], threshold);
+        applyParams(learner, eta, threshold);
+        out << ",\"learningRate\":" << eta << ",\"threshold\":" << threshold;
+    }
+
+    else if (job.command == "replay") {
+        GameLogReader reader;
+        ok = reader.open(job.args[0]);
+        if (!ok) std::cerr << "[ERROR] " << job.source << ": cannot read game log " << job.args[0] << "\n";
+        int shards = 1;
+        const MergeStrategy* merge = &MergeStrategy::defaultStrategy();
+        if (job.args.size() >= 2) parseInt(job.args[1], shards);
+        if (job.args.size() >= 3) merge = MergeStrategy::byName(job.args[2]);
+
+        ReplayResult r;
+        if (ok) r = ReplayTrainer::run(reader, learner, shards, merge);
+        if (ok) trajectory.recordLearner(learner, static_cast<long long>(r.games));
+        out << ",\"path\":" << jsonString(job.args[0])
+            << ",\"games\":" << r.games
+            << ",\"shards\":" << r.shards
+            << ",\"merge\":" << jsonString(r.shards > 1 ? merge->name() : "none")
+            << ",\"gamesPerSec\":" << (r.elapsedSeconds > 0.0 ? r.games / r.elapsedSeconds : 0.0);
+    }
+
+    else if (job.command == "sweep") {
+        GameLogReader reader;
+        ok = reader.open(job.args[0]);
+        if (!ok) std::cerr << "[ERROR] " << job.source << ": cannot read game log " << job.args[0] << "\n";
+        std::vector<double> etas, thresholds;
+        parseDoubleList(job.args[1], etas);
+        parseDoubleList(job.args[2], thresholds);
+
+        // Every combination starts from the current learner; the learner itself is unchanged.
+        std::vector<LearningModule> candidates;
+        ReplayResult r;
+        std::vector<ExactResult> exact;
+        if (ok) {
+            for (double eta : etas)
+                for (double t : thresholds) {
+                    candidates.push_back(learner);
+                    applyParams(candidates.back(), eta, t);
+                }
+            r = ReplayTrainer::runMany(reader, candidates);
+            std::vector<std::vector<double>> weightSets;
+            for (const LearningModule& c : candidates) weightSets.push_back(c.exportPlayerWeights());
+            exact = ExactEvaluator::evaluateMany(weightSets, PolicySpec::stochastic());
+        }
+
+        out << ",\"path\":" << jsonString(job.args[0])
+            << ",\"games\":" << r.games
+            << ",\"results\":[";
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            out << (i ? "," : "")
+                << "{\"learningRate\":" << etas[i / thresholds.size()]
+                << ",\"threshold\":" << thresholds[i % thresholds.size()]
+                << std::fixed << std::setprecision(6)
+                << ",\"winVsStochastic\":" << exact[i].win
+                << ",\"weights\":" << jsonWeights(candidates[i]) << "}";
+            out.unsetf(std::ios::floatfield);
+            out << std::setprecision(6);
+        }
+        out << "]";
+    }
+
+    else if (job.command == "logstats") {
+        GameLogReader reader;
+        ok = reader.open(job.args[0]);
+        if (!ok) std::cerr << "[ERROR] " << job.source << ": cannot read game log " << job.args[0] << "\n";
+
+        // Column scan: outcomes from meta, rule usage straight from the packed masks.
+        double scanStart = wallTime();
+        unsigned long long outcome[4] = {}, ruleUses[RULE_COUNT] = {}, moves = 0;
+        for (size_t b = 0; ok && b < reader.blockCount(); ++b) {
+            GameLogBlock blk = reader.block(b);
+            for (std::uint32_t i = 0; i < blk.count; ++i) {
+                outcome[GameLog::winnerCode(blk.meta[i])]++;
+                moves += GameLog::moveCount(blk.meta[i]);
+                std::uint64_t m = blk.masks[i];
+                for (int r = 0; r < RULE_COUNT; ++r)
+                    ruleUses[r] += GameLog::ruleUses(m, r);
+            }
+        }
+        double scanSeconds = wallTime() - scanStart;
+
+        out << ",\"path\":" << jsonString(job.args[0])
+            << ",\"games\":" << reader.gameCount()
+            << ",\"blocks\":" << reader.blockCount()
+            << ",\"winsX\":" << outcome[1]
+            << ",\"winsO\":" << outcome[2]
+            << ",\"draws\":" << outcome[3]
+            << ",\"moves\":" << moves
+            << ",\"ruleUses\":[";
+        for (int r = 0; r < RULE_COUNT; ++r) out << (r ? "," : "") << ruleUses[r];
+        out << "],\"gamesPerSec\":" << (scanSeconds > 0.0 ? reader.gameCount() / scanSeconds : 0.0);
+    }
+
+    else if (job.command == "trajectory") {
+        trajectory.flush();  // this run's learner samples, if it is the same file
+        TrajectoryReader reader;
+        ok = reader.open(job.args[0]);
+        if (!ok) std::cerr << "[ERROR] " << job.source << ": cannot read trajectory " << job.args[0] << "\n";
+        std::uint64_t from = 0, to = reader.lastStep();
+        if (job.args.size() >= 3) {
+            parseStep(job.args[1], from);
+            parseStep(job.args[2], to);
+        }
+
+        double queryStart = wallTime();
+        std::vector<TrajectorySample> range;
+        if (ok) reader.query(TRAJECTORY_STEP, from, to, range);
+        double querySeconds = wallTime() - queryStart;
+
+        if (ok && job.args.size() == 4) {
+            std::ofstream csv(job.args[3], std::ios::trunc);
+            csv << "step,micros,source";
+            for (int r = 0; r < RULE_COUNT; ++r) csv << ",w_" << RULE_LABELS[r];
+            for (int r = 0; r < RULE_COUNT; ++r) csv << ",c_" << RULE_LABELS[r];
+            csv << ",learning_rate";
+            csv << "\n" << std::setprecision(17);
+            for (const TrajectorySample& s : range) {
+                csv << s.step << ',' << s.micros << ',';
+                if (s.source == Trajectory::LEARNER) csv << "learner";
+                else csv << s.source;
+                for (int r = 0; r < RULE_COUNT; ++r) csv << ',' << s.weight[r];
+                for (int r = 0; r < RULE_COUNT; ++r) csv << ',' << s.counter[r];
+                csv << ',' << s.learningRate << "\n";
+            }
+            ok = csv.good();
+            if (!ok) std::cerr << "[ERROR] " << job.source << ": cannot write " << job.args[3] << "\n";
+            out << ",\"csv\":" << jsonString(job.args[3]);
+        }
+
+        out << ",\"path\":" << jsonString(job.args[0])
+            << ",\"chunks\":" << reader.chunkCount()
+            << ",\"samples\":" << reader.sampleCount()
+            << ",\"bytes\":" << (ok ? reader.byteSize() : 0)
+            << ",\"bytesPerSample\":" << (reader.sampleCount() ? double(reader.byteSize()) / reader.sampleCount() : 0.0)
+            << ",\"from\":" << from
+            << ",\"to\":" << to
+            << ",\"rangeSamples\":" << range.size()
+            << ",\"samplesPerSec\":" << (querySeconds > 0.0 ? range.size() / querySeconds : 0.0);
+    }
+
+    else if (job.command == "compile") {
+        PolicyTable table;
+        table.compile(learner.exportPlayerWeights(), job.args.size() == 2);
+        ok = table.save(job.args[0]);
+        out << ",\"path\":" << jsonString(job.args[0])
+            << ",\"symmetric\":" << (table.isSymmetryReduced() ? "true" : "false")
+            << ",\"entries\":" << table.entryCount()
+            << ",\"bytes\":" << table.byteSize();
+    }
+    else if (job.command == "ab") {
+        TournamentEntrant a, b, opponent;
+        for (int i = 0; i < 3; ++i) {
+            TournamentEntrant& e = (i == 0) ? a : (i == 1 ? b : opponent);
+            if (!Tournament::entrant(job.args[i], learner, e)) {
+                std::cerr << "[ERROR] " << job.source << ": cannot load " << job.args[i] << "\n";
+                ok = false;
+            }
+        }
+        if (ok) {
+            int matches = 0, batch = 0;
+            parseInt(job.args[3], matches);
+            if (job.args.size() == 5) parseInt(job.args[4], batch);
+            PairedConfig config;
+            config.matches = matches;
+            config.batch = batch;
+            config.seed = Random::next();
+            PairedResult p = PairedComparison::run(a.policy, b.policy, opponent.policy, config);
+            ok = p.ok;
+            out << ",\"a\":" << jsonString(a.label)
+                << ",\"b\":" << jsonString(b.label)
+                << ",\"opponent\":" << jsonString(opponent.label)
+                << ",\"matches\":" << p.matches
+                << ",\"winA\":" << double(p.winsA) / p.matches
+                << ",\"winB\":" << double(p.winsB) / p.matches
+                << ",\"diff\":" << p.diff
+                << ",\"ci\":[" << (p.diff - p.ciHalfWidth) << "," << (p.diff + p.ciHalfWidth) << "]"
+                << ",\"ciLevel\":" << (1.0 - p.alpha / p.maxLooks)
+                << ",\"alpha\":" << p.alpha
+                << ",\"maxLooks\":" << p.maxLooks
+                << ",\"stdError\":" << p.stdError
+                << ",\"unpairedStdError\":" << p.unpairedStdError
+                << ",\"discordant\":" << p.discordant
+                << ",\"looks\":" << p.looks
+                << ",\"significant\":" << (p.significant ? "true" : "false")
+                << ",\"stoppedEarly\":" << (p.stoppedEarly ? "true" : "false");
+        }
+    }
+    else if (job.command == "tournament") {
+        int games = 0;
+        parseInt(job.args[0], games);
+        std::string cachePath = (job.args[1] == "-") ? "" : job.args[1];
+
+        std::vector<TournamentEntrant> entrants;
+        for (size_t i = 2; i < job.args.size(); ++i) {
+            TournamentEntrant e;
+            if (!Tournament::entrant(job.args[i], learner, e)) {
+                std::cerr << "[ERROR] " << job.source << ": cannot load " << job.args[i] << "\n";
+                ok = false;
+                continue;
+            }
+            entrants.push_back(e);
+        }
+
+        TournamentResult t = Tournament::run(entrants, games, cachePath);
+        if (!t.ok) ok = false;
+        out << ",\"games\":" << games
+            << ",\"played\":" << t.played
+            << ",\"cached\":" << t.cached
+            << ",\"ratings\":[";
+        for (size_t i = 0; i < t.ratings.size(); ++i) {
+            const TournamentRating& r = t.ratings[i];
+            out << (i ? "," : "") << "{\"entrant\":" << jsonString(entrants[r.entrant].label)
+                << ",\"elo\":" << r.elo
+                << ",\"ci95\":" << r.ci95
+                << ",\"score\":" << r.score
+                << ",\"games\":" << r.games << "}";
+        }
+        out << "],\"pairings\":[";
+        for (size_t i = 0; i < t.pairings.size(); ++i) {
+            const PairingResult& p = t.pairings[i];
+            out << (i ? "," : "") << "{\"a\":" << jsonString(entrants[p.a].label)
+                << ",\"b\":" << jsonString(entrants[p.b].label)
+                << ",\"aFirst\":[" << p.winsFirst << "," << p.drawsFirst << "," << p.lossesFirst << "]"
+                << ",\"bFirst\":[" << p.winsSecond << "," << p.drawsSecond << "," << p.lossesSecond << "]"
+                << ",\"cached\":" << (p.cached ? "true" : "false") << "}";
+        }
+        out << "]";
+    }
+    else if (job.command == "simulate") {
+        TournamentEntrant x, o;
+        for (int i = 0; i < 2; ++i) {
+            if (!Tournament::entrant(job.args[i], learner, i == 0 ? x : o)) {
+                std::cerr << "[ERROR] " << job.source << ": cannot load " << job.args[i] << "\n";
+                ok = false;
+            }
+        }
+        if (ok) {
+            int matches = 0, lanes = BatchSimulator::DEFAULT_LANES;
+            parseInt(job.args[2], matches);
+            if (job.args.size() == 4) parseInt(job.args[3], lanes);
+            BatchSimResult r;
+            ok = BatchSimulator::run(x.policy, o.policy, matches, r, lanes);
+            out << ",\"x\":" << jsonString(x.label)
+                << ",\"o\":" << jsonString(o.label)
+                << ",\"matches\":" << r.matches
+                << ",\"lanes\":" << r.lanes
+                << ",\"winsX\":" << r.winsX
+                << ",\"winsO\":" << r.winsO
+                << ",\"draws\":" << r.draws
+                << ",\"moves\":" << r.moves
+                << ",\"matchesPerSec\":" << (r.elapsedSeconds > 0.0 ? r.matches / r.elapsedSeconds : 0.0);
+        }
+    }
+    else if (job.command == "exact") {
+        const std::string& opp = job.args[0];
+        PolicySpec opponent = PolicySpec::stochastic();
+        if (opp == "perfect") opponent = PolicySpec::perfect();
+        else if (opp == "rulevolution") opponent = PolicySpec::rulevolution(std::vector<double>(5, 0.5));
+
+        // Candidates: the learner itself, or every listed weights file.
+        std::vector<std::string> labels;
+        std::vector<std::vector<double>> weightSets;
+        if (job.args.size() == 1) {
+            labels.push_back("learner");
+            weightSets.push_back(learner.exportPlayerWeights());
+        }
+        for (size_t i = 1; i < job.args.size(); ++i) {
+            LearningModule local = learner;
+            if (!WeightsIO::load(local, job.args[i])) {
+                std::cerr << "[ERROR] " << job.source << ": cannot load " << job.args[i] << "\n";
+                ok = false;
+                continue;
+            }
+            labels.push_back(job.args[i]);
+            weightSets.push_back(local.exportPlayerWeights());
+        }
+
+        std::vector<ExactResult> exact = ExactEvaluator::evaluateMany(weightSets, opponent, opp == "self");
+        out << ",\"opponent\":" << jsonString(opp) << ",\"results\":[" << std::setprecision(9);
+        for (size_t i = 0; i < exact.size(); ++i) {
+            out << (i ? "," : "") << "{\"candidate\":" << jsonString(labels[i])
+                << ",\"win\":" << exact[i].win
+                << ",\"draw\":" << exact[i].draw
+                << ",\"loss\":" << exact[i].loss
+                << ",\"positions\":" << exact[i].positions << "}";
+        }
+        out << "]";
+    }
+
+    out << std::fixed << std::setprecision(6)
+        << ",\"seconds\":" << (wallTime() - start)
+        << ",\"ok\":" << (ok ? "true" : "false")
+        << ",\"weights\":" << jsonWeights(learner) << "}";
+    results << out.str() << "\n";
+
+    if (!ok)
+        std::cerr << "[ERROR] " << job.source << ": job \"" << job.command << "\" failed\n";
+    return ok;
+}
+
+int BatchRunner::runFromArgs(int argc, char* argv[], LearningModule& learner) {
+    BatchRunner runner(learner);
+    std::string resultsPath, metricsPath, checkpointPath, resumePath, gameLogPath, analyticsPath;
+    double metricsInterval = 10.0;
+    double analyticsInterval = 1.0;
+    double checkpointInterval = 60.0;
+    int checkpointRound = 10000;
+    bool metricsStderr = false;
+    bool verbose = false;
+    bool ok = true;
+    SuggestionConfig serve;
+    LoadGeneratorConfig loadgen;
+    std::string publishPath, followPath, watchPath;
+    int publishRound = 10000;
+    std::string trajectoryPath;
+    int trajectoryInterval = 100;
+    std::string tracePath;
+    long long traceBuffer = static_cast<long long>(Trace::DEFAULT_CAPACITY);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose") {
+            verbose = true;
+        }
+        else if (arg == "--metrics-stderr") {
+            metricsStderr = true;
+        }
+        else if (arg == "--metrics" && i + 1 < argc) {
+            metricsPath = argv[++i];
+        }
+        else if (arg == "--metrics-interval" && i + 1 < argc) {
+            metricsInterval = std::atof(argv[++i]);
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            checkpointInterval = std::atof(argv[++i]);
+        }
+        else if (arg == "--checkpoint-round" && i + 1 < argc) {
+            checkpointRound = std::atoi(argv[++i]);
+        }
+        else if (arg == "--resume" && i + 1 < argc) {
+            resumePath = argv[++i];
+        }
+        else if (arg == "--game-log" && i + 1 < argc) {
+            gameLogPath = argv[++i];
+        }
+        else if (arg == "--analytics" && i + 1 < argc) {
+            analyticsPath = argv[++i];
+        }
+        else if (arg == "--analytics-interval" && i + 1 < argc) {
+            analyticsInterval = std::atof(argv[++i]);
+        }
+        else if (arg == "--publish" && i + 1 < argc) {
+            publishPath = argv[++i];
+        }
+        else if (arg == "--publish-round" && i + 1 < argc) {
+            publishRound = std::atoi(argv[++i]);
+        }
+        else if (arg == "--trajectory" && i + 1 < argc) {
+            trajectoryPath = argv[++i];
+        }
+        else if (arg == "--trajectory-interval" && i + 1 < argc) {
+            trajectoryInterval = std::atoi(argv[++i]);
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--trace-buffer" && i + 1 < argc) {
+            traceBuffer = std::atoll(argv[++i]);
+        }
+        else if (arg == "--serve-follow" && i + 1 < argc) {
+            followPath = argv[++i];
+        }
+        else if (arg == "--serve-watch" && i + 1 < argc) {
+            watchPath = argv[++i];
+        }
+        else if (arg == "--serve" && i + 1 < argc) {
+            serve.socketPath = argv[++i];
+        }
+        else if (arg == "--serve-threads" && i + 1 < argc) {
+            serve.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--serve-batch" && i + 1 < argc) {
+            serve.maxBatch = std::atoi(argv[++i]);
+        }
+        else if (arg == "--serve-latency-us" && i + 1 < argc) {
+            serve.latencyMicros = std::atoi(argv[++i]);
+        }
+        else if (arg == "--loadgen" && i + 1 < argc) {
+            loadgen.socketPath = argv[++i];
+        }
+        else if (arg == "--loadgen-requests" && i + 1 < argc) {
+            loadgen.requests = std::atoll(argv[++i]);
+        }
+        else if (arg == "--loadgen-connections" && i + 1 < argc) {
+            loadgen.connections = std::atoi(argv[++i]);
+        }
+        else if (arg == "--loadgen-pipeline" && i + 1 < argc) {
+            loadgen.pipeline = std::atoi(argv[++i]);
+        }
+        else if (arg == "--loadgen-seeded") {
+            loadgen.seeded = true;
+        }
+        else if ((arg == "--batch" || arg == "--job" || arg == "--results") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "--batch") ok = runner.addJobFile(value) && ok;
+            else if (arg == "--job") ok = runner.addJob(value) && ok;
+            else resultsPath = value;
+        }
+        else {
+            std::cerr << "[ERROR] Unknown or incomplete argument: " << arg << "\n"
+                << "Usage: " << argv[0]
+                << " [--batch <file>]... [--job \"<command> <args>\"]... [--results <file>] [--verbose]"
+                << " [--metrics <file>] [--metrics-interval <s>] [--metrics-stderr]"
+                << " [--checkpoint <file>] [--checkpoint-interval <s>] [--checkpoint-round <matches>]"
+                << " [--resume <file>] [--game-log <file>]"
+                << " [--analytics <file>] [--analytics-interval <s>]"
+                << " [--publish <store>] [--publish-round <matches>]"
+                << " [--trajectory <file>] [--trajectory-interval <matches>]"
+                << " [--trace <file>] [--trace-buffer <spans>]"
+                << " [--serve <socket>] [--serve-threads <n>] [--serve-batch <n>] [--serve-latency-us <us>]"
+                << " [--serve-follow <store>] [--serve-watch <weights file>]"
+                << " [--loadgen <socket>] [--loadgen-requests <n>] [--loadgen-connections <n>]"
+                << " [--loadgen-pipeline <n>] [--loadgen-seeded]\n";
+            return 2;
+        }
+    }
+    if (!ok) return 2;
+
+    // The load generator is a pure client: no jobs, no learner.
+    if (!loadgen.socketPath.empty()) {
+        LoadGeneratorResult result;
+        bool done = SuggestionLoadGenerator::run(loadgen, result);
+        SuggestionLoadGenerator::writeJson(std::cout, loadgen, result);
+        return done ? 0 : 1;
+    }
+
+    // A headless session starts from the default parameters, like answering 'n'
+    // to the interactive "load weights" prompt; a "load" job overrides them.
+    learner.setDefaultParameters();
+    learner.recordInitialWeights();
+
+    // A resumed run keeps writing to the same checkpoint unless told otherwise.
+    if (!resumePath.empty()) {
+        if (!runner.resume(resumePath)) return 2;
+        if (checkpointPath.empty()) checkpointPath = resumePath;
+    }
+    if (!checkpointPath.empty())
+        runner.enableCheckpoints(checkpointPath, checkpointInterval, checkpointRound);
+    if (!gameLogPath.empty() && !runner.enableGameLog(gameLogPath))
+        return 2;
+    if (!analyticsPath.empty() && !runner.enableAnalytics(analyticsPath, analyticsInterval))
+        return 2;
+    if (!publishPath.empty() && !runner.enablePublish(publishPath, publishRound))
+        return 2;
+    if (!trajectoryPath.empty() && !runner.enableTrajectory(trajectoryPath, trajectoryInterval))
+        return 2;
+
+    std::ofstream resultsFile;
+    if (!resultsPath.empty()) {
+        resultsFile.open(resultsPath, resumePath.empty() ? std::ios::trunc : std::ios::app);
+        if (!resultsFile.good()) {
+            std::cerr << "[ERROR] Cannot write results to " << resultsPath << "\n";
+            return 2;
+        }
+    }
+
+    MetricsExporter exporter;
+    if (!metricsPath.empty() || metricsStderr)
+        exporter.start(metricsPath, metricsInterval, metricsStderr);
+    if (!tracePath.empty())
+        Trace::start(tracePath, static_cast<std::size_t>(traceBuffer > 0 ? traceBuffer : 1));
+
+    int failed = runner.run(resultsPath.empty() ? std::cout : resultsFile, verbose);
+    int status = failed == 0 ? 0 : 1;
+
+    // The daemon serves the weights the jobs ended with.
+    if (!serve.socketPath.empty() && failed == 0) {
+        SuggestionServer server(serve);
+        WeightStore live;
+        WeightFileWatcher watcher;
+        bool ready = followPath.empty() || live.open(followPath);
+        if (ready && followPath.empty() && !watchPath.empty()) {
+            live.openLocal();
+            ready = watcher.start(watchPath, live);
+        }
+        if (ready && live.isOpen()) server.follow(&live);
+        ready = ready && server.open(learner.exportPlayerWeights());
+        if (ready) SuggestionServer::writeJson(resultsPath.empty() ? std::cout : resultsFile, server.serve());
+        else status = 2;
+    }
+    runner.checkpoints.stop();  // final checkpoint
+    exporter.stop();  // final export
+    runner.analytics.stop();  // final row
+    if (!tracePath.empty()) Trace::stop();  // final trace file
+    return status;
+}
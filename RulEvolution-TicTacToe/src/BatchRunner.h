@@ -0,0 +1,196 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "LearningModule.h"
+#include "Checkpoint.h"
+#include "GameLog.h"
+#include "TrainingAnalytics.h"
+#include "ConvergenceMonitor.h"
+#include "WeightStore.h"
+#include "Trajectory.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+/**
+ * @struct BatchJob
+ * @brief One headless job: a command word followed by its arguments.
+ *
+ * Supported commands:
+ *  - reset                              default weights and thresholds
+ *  - load <path>                        load weights through WeightsIO
+ *  - save <path>                        save weights through WeightsIO
+ *  - seed <n>                           reseed the random generator
+ *  - train <scenario> <matches> [merge] [workers]
+ *                                       Super-Training batch (1 = Stochastic vs RulEv, 2 = RulEv vs RulEv),
+ *                                       merge = mean|weighted|replay|median|trimmed
+ *  - evaluate <opponent> <matches> [table]
+ *                                       learned weights (or a compiled policy table) vs
+ *                                       stochastic|rulevolution, no learning
+ *  - evolve <opponent> <generations> <population> [matches] [prefix]
+ *                                       evolutionary weight search vs stochastic|rulevolution|perfect
+ *                                       (matches 0 or omitted = exact fitness), seeded from and written
+ *                                       back to the learner; elites saved as <prefix>_eliteN.txt
+ *  - converge <weightTol> <winMargin> [crossingTol] [patience] [round] | converge off
+ *                                       stop later train jobs early once converged (see ConvergenceMonitor);
+ *                                       <matches> becomes an upper bound
+ *  - params <eta> <threshold>           set the learning rate and the threshold of every rule in use
+ *  - replay <log> [shards] [merge]      learn from a recorded game log (no simulation)
+ *  - sweep <log> <etas> <thresholds>    replay the log once per combination (comma lists) from the
+ *                                       current learner and report exact win rates vs stochastic
+ *  - logstats <path>                    scan a game log: games, outcomes, rule usage, scan speed
+ *  - trajectory <path> [from to] [csv]  range query on a weight trajectory (steps from..to): samples,
+ *                                       bytes per sample, decode speed; the range optionally as CSV
+ *  - compile <path> [symmetric]         compile the learner's policy into a table file
+ *  - ab <a> <b> <opponent> <matches> [batch]
+ *                                       paired A/B win-rate comparison with common random numbers
+ *                                       (entrants as for tournament); with batch, stop once significant
+ *  - tournament <games> <cache|-> <entrant> <entrant> [...]
+ *                                       round robin, <games> per pairing and first mover; entrants are
+ *                                       stochastic|rulevolution|learner or weights files; Bradley-Terry
+ *                                       Elo with 95% intervals; pairings cached by weight hash
+ *  - simulate <x> <o> <matches> [lanes]
+ *                                       play <matches> matches of x against o in lockstep (BatchSimulator),
+ *                                       entrants as for tournament; outcome counts and matches/sec
+ *  - exact <opponent> [path ...]        exact win/draw/loss vs stochastic|rulevolution|self|perfect
+ *                                       for the learner or for each listed weights file
+ */
+struct BatchJob {
+    std::string command;            ///< Command word (lowercase)
+    std::vector<std::string> args;  ///< Positional arguments
+    std::string source;             ///< Origin of the job ("file:line" or "cli")
+};
+
+/**
+ * @class BatchRunner
+ * @brief Non-interactive driver: runs a list of jobs back to back in one
+ *        process and reports each result as one JSON line.
+ *
+ * All jobs share the same learner and the same (warm) OpenMP thread pool,
+ * so a nightly queue pays process startup only once.
+ */
+class BatchRunner {
+public:
+    explicit BatchRunner(LearningModule& learner);
+
+    /**
+     * @brief Append the jobs listed in a job file ('#' starts a comment).
+     * @return false if the file cannot be read or contains an unknown command.
+     */
+    bool addJobFile(const std::string& filename);
+
+    /**
+     * @brief Append a single job given as text (e.g. "train 1 10000").
+     * @return false if the command is unknown or malformed.
+     */
+    bool addJob(const std::string& line, const std::string& source = "cli");
+
+    /**
+     * @brief Run all queued jobs in order, writing one JSON object per line.
+     * @param results Destination of the machine-readable results.
+     * @param verbose Keep the per-match / per-move traces of the interactive mode.
+     * @return Number of failed jobs (0 on full success).
+     */
+    int run(std::ostream& results, bool verbose = false);
+
+    /**
+     * @brief Write checkpoints from a background thread while run() executes.
+     * @param path Checkpoint file (replaced atomically).
+     * @param intervalSeconds Minimum time between two writes.
+     * @param roundMatches Train jobs run in rounds of this many matches, with a
+     *        snapshot after each round (a resumed job restarts at a round boundary).
+     */
+    void enableCheckpoints(const std::string& path, double intervalSeconds, int roundMatches);
+
+    /**
+     * @brief Restore the learner, random stream and job cursor from a checkpoint.
+     *        Completed jobs are skipped by run(); the queued job list must be the
+     *        one the checkpoint was written for.
+     * @return false if the file is unreadable, corrupt or from another job list.
+     */
+    bool resume(const std::string& path);
+
+    /**
+     * @brief Append every game played by train jobs to a game log.
+     * @return false if the log cannot be opened.
+     */
+    bool enableGameLog(const std::string& path);
+
+    /**
+     * @brief Stream training analytics (rates, EWMAs, first-mover advantage,
+     *        rule firings, weights) of the train jobs to a time-series file.
+     * @param path CSV if the name ends in ".csv", JSON lines otherwise (appended).
+     * @param intervalSeconds Time between two rows.
+     * @return false if the file cannot be opened.
+     */
+    bool enableAnalytics(const std::string& path, double intervalSeconds);
+
+    /**
+     * @brief Publish the learner's weights to a live weight store after every
+     *        job and every train round that changed them.
+     * @param roundMatches Train jobs run in rounds of this many matches (unless
+     *        checkpoints already set a round size).
+     * @return false if the store cannot be mapped.
+     */
+    bool enablePublish(const std::string& path, int roundMatches);
+
+    /**
+     * @brief Record the weight and counter trajectory of the run: every
+     *        worker learner each `interval` matches of a train job, and the
+     *        learner after every merge and every job that changed it.
+     * @return false if the file cannot be opened or is not a trajectory.
+     */
+    bool enableTrajectory(const std::string& path, int interval);
+
+    /// Hash identifying the queued job list (stored in checkpoints).
+    std::uint64_t jobsHash() const;
+
+    /**
+     * @brief Command-line entry point used by main() when arguments are given.
+     *
+     * Flags: --batch <file> (repeatable), --job "<line>" (repeatable),
+     *        --results <file> (default: stdout), --verbose,
+     *        --checkpoint <file>, --checkpoint-interval <s>, --checkpoint-round <matches>,
+     *        --resume <file>, --game-log <file>,
+     *        --analytics <file>, --analytics-interval <s>,
+     *        --publish <store>, --publish-round <matches>,
+     *        --trajectory <file>, --trajectory-interval <matches>,
+     *        --trace <file> (Chrome trace-event timeline, also written on SIGUSR1),
+     *        --trace-buffer <spans per thread>,
+     *        --serve <socket> (then answer move suggestions with the final
+     *        weights, see SuggestionServer), --serve-threads <n>, --serve-batch <n>,
+     *        --serve-latency-us <us>, --serve-follow <store> (adopt every weight
+     *        generation published there), --serve-watch <weights file> (adopt the
+     *        file whenever it is rewritten),
+     *        --loadgen <socket> (run the load generator instead of jobs),
+     *        --loadgen-requests <n>, --loadgen-connections <n>,
+     *        --loadgen-pipeline <n>, --loadgen-seeded.
+     * @return Process exit code.
+     */
+    static int runFromArgs(int argc, char* argv[], LearningModule& learner);
+
+private:
+    bool runJob(const BatchJob& job, std::ostream& results, int index, bool verbose);
+    void submitCheckpoint(int jobIndex, long long jobMatches);
+    void applyConvergence(const BatchJob& job);
+    void publishWeights();
+    static bool parseJob(const std::string& line, const std::string& source, BatchJob& job);
+
+    LearningModule& learner;       ///< Learner shared by all jobs
+    std::vector<BatchJob> jobs;    ///< Queued jobs, in execution order
+    CheckpointWriter checkpoints;  ///< Background checkpoint writer (if enabled)
+    GameLog gameLog;               ///< Log of the trained games (if enabled)
+    TrainingAnalytics analytics;   ///< Streaming analytics of the train jobs
+    WeightStore publishStore;      ///< Live weights for other engines (if enabled)
+    std::vector<double> published; ///< Last weights published
+    Trajectory trajectory;         ///< Weight trajectory of the run (if enabled)
+    int publishRound = 0;          ///< Matches per train round when publishing
+    int roundMatches = 0;          ///< Matches per train round (0 = whole job)
+    bool earlyStop = false;        ///< Stop train jobs once converged
+    ConvergenceConfig convergence; ///< Tolerances of the early stop
+    int resumeJob = 0;             ///< First job not completed before the resume
+    long long resumeMatches = 0;   ///< Matches of resumeJob already trained
+};
+
+#endif // BATCHRUNNER_H
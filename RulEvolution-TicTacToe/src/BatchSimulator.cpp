@@ -0,0 +1,254 @@
+// ================================================================
+//  BatchSimulator.cpp — Lockstep structure-of-arrays match simulation
+//  (OpenMP Optional)
+//  Notes:
+//    - cell i is bit i of a side's mask; the base-3 code of a position is
+//      BASE3[x] + 2 * BASE3[o], the PolicyTable key without a Board;
+//    - random numbers use the mappings of Random::below() / unit();
+//    - the win test loops over lanes with the 8 lines unrolled and no
+//      branch, so the compiler vectorizes it.
+// ================================================================
+#include "BatchSimulator.h"
+#include "PolicyTable.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "Metrics.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+const std::uint16_t FULL_BOARD = 0x1FF;
+const std::uint16_t LINES[8] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054 };
+
+/// Per-mask lookup tables (512 masks of 9 cells).
+struct MaskTables {
+    std::uint16_t base3[512];   ///< Sum of 3^i over the set cells
+    std::uint8_t count[512];    ///< Set cells
+    std::uint8_t select[512][9];  ///< k-th set cell
+
+    MaskTables() {
+        for (int m = 0; m < 512; ++m) {
+            int code = 0, n = 0, pow = 1;
+            for (int i = 0; i < 9; ++i, pow *= 3) {
+                select[m][i] = 0;
+                if (!(m >> i & 1)) continue;
+                code += pow;
+                select[m][n++] = static_cast<std::uint8_t>(i);
+            }
+            base3[m] = static_cast<std::uint16_t>(code);
+            count[m] = static_cast<std::uint8_t>(n);
+        }
+    }
+};
+const MaskTables MASKS;
+
+/// Move policy of one side, ready for the lockstep loop.
+struct SidePolicy {
+    bool stochastic = true;
+    const PolicyTable* table = nullptr;
+    const std::vector<double>* weights = nullptr;  ///< Fallback for positions missing from the table
+};
+
+inline int below(std::uint64_t bits, int n) {
+    return static_cast<int>(((bits >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+}
+
+inline double unit(std::uint64_t bits) {
+    return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int rulevolutionMove(const SidePolicy& policy, std::uint16_t x, std::uint16_t o, char side, std::uint64_t bits) {
+    int transform = 0;
+    const PolicyEntry* entry = policy.table->findCode(MASKS.base3[x] + 2 * MASKS.base3[o], side, transform);
+    if (entry)
+        return PolicyTable::pick(*entry, transform, (entry->flags & POLICY_SAMPLED) ? unit(bits) : 0.0);
+
+    Board board;
+    for (int i = 0; i < 9; ++i) {
+        if (x >> i & 1) board.place(i, 'X');
+        else if (o >> i & 1) board.place(i, 'O');
+    }
+    MoveDistribution dist = RulEvolutionPlayer::distribution(board, side, *policy.weights);
+    return dist.pick(dist.sampled ? unit(bits) : 0.0);
+}
+
+/// One thread's matches in flight, structure of arrays.
+struct Lanes {
+    std::vector<std::uint16_t> x, o;    ///< Cells of X and of O
+    std::vector<std::uint8_t> turn;     ///< Side to move (0 = X, 1 = O)
+    std::vector<std::uint8_t> cell;     ///< Move chosen in the current step
+    std::vector<std::uint8_t> status;   ///< 0 running, 1 won by the side that just moved, 2 draw
+
+    explicit Lanes(int n) : x(n), o(n), turn(n), cell(n), status(n) {}
+};
+
+/// Play `matches` matches on the calling thread; adds the counts to `r`.
+void simulate(const SidePolicy side[2], long long matches, int laneCount, BatchSimResult& r) {
+    RandomSource& random = Random::source();
+    Lanes lanes(laneCount);
+    std::uint64_t seed = 0, first = 0;
+
+    long long started = std::min<long long>(laneCount, matches);
+    int active = static_cast<int>(started);
+    first = random.reserve(static_cast<std::uint64_t>(active), seed);
+    for (int i = 0; i < active; ++i) {
+        lanes.x[i] = lanes.o[i] = 0;
+        lanes.turn[i] = static_cast<std::uint8_t>(below(RandomSource::at(seed, first + i), 2));
+    }
+
+    std::uint16_t* x = lanes.x.data();
+    std::uint16_t* o = lanes.o.data();
+    std::uint8_t* turn = lanes.turn.data();
+    std::uint8_t* cell = lanes.cell.data();
+    std::uint8_t* status = lanes.status.data();
+
+    while (active > 0) {
+        // 1. Moves: one random number per lane from a single reserved block.
+        first = random.reserve(static_cast<std::uint64_t>(active), seed);
+        if (side[0].stochastic && side[1].stochastic) {
+            for (int i = 0; i < active; ++i) {
+                std::uint16_t empty = static_cast<std::uint16_t>(FULL_BOARD & ~(x[i] | o[i]));
+                cell[i] = MASKS.select[empty][below(RandomSource::at(seed, first + i), MASKS.count[empty])];
+            }
+        }
+        else {
+            for (int i = 0; i < active; ++i) {
+                const SidePolicy& p = side[turn[i]];
+                std::uint64_t bits = RandomSource::at(seed, first + i);
+                if (p.stochastic) {
+                    std::uint16_t empty = static_cast<std::uint16_t>(FULL_BOARD & ~(x[i] | o[i]));
+                    cell[i] = MASKS.select[empty][below(bits, MASKS.count[empty])];
+                }
+                else {
+                    cell[i] = static_cast<std::uint8_t>(rulevolutionMove(p, x[i], o[i], turn[i] ? 'O' : 'X', bits));
+                }
+            }
+        }
+
+        // 2. Place and test all lanes (branch-free).
+        for (int i = 0; i < active; ++i) {
+            std::uint16_t bit = static_cast<std::uint16_t>(1u << cell[i]);
+            std::uint16_t isO = static_cast<std::uint16_t>(0u - turn[i]);
+            x[i] = static_cast<std::uint16_t>(x[i] | (bit & ~isO));
+            o[i] = static_cast<std::uint16_t>(o[i] | (bit & isO));
+            std::uint16_t mover = static_cast<std::uint16_t>((o[i] & isO) | (x[i] & ~isO));
+            int won = 0;
+            for (int k = 0; k < 8; ++k) won |= ((mover & LINES[k]) == LINES[k]);
+            int full = ((x[i] | o[i]) == FULL_BOARD);
+            status[i] = static_cast<std::uint8_t>(won ? 1 : 2 * full);
+        }
+        r.moves += active;
+
+        // 3. Tally finished lanes, refill them while matches remain, compact the rest.
+        int finished = 0;
+        for (int i = 0; i < active; ++i) finished += (status[i] != 0);
+        if (finished == 0) {
+            for (int i = 0; i < active; ++i) turn[i] ^= 1u;
+            continue;
+        }
+        long long refills = std::min<long long>(finished, matches - started);
+        first = random.reserve(static_cast<std::uint64_t>(refills), seed);
+        long long used = 0;
+        int kept = 0;
+        for (int i = 0; i < active; ++i) {
+            if (status[i] == 0) {
+                x[kept] = x[i];
+                o[kept] = o[i];
+                turn[kept] = static_cast<std::uint8_t>(turn[i] ^ 1u);
+                ++kept;
+                continue;
+            }
+            if (status[i] == 1) {
+                if (turn[i] == 0) ++r.winsX;
+                else ++r.winsO;
+            }
+            else {
+                ++r.draws;
+            }
+            ++r.matches;
+            if (used < refills) {
+                x[kept] = o[kept] = 0;
+                turn[kept] = static_cast<std::uint8_t>(below(RandomSource::at(seed, first + used), 2));
+                ++used;
+                ++kept;
+            }
+        }
+        started += refills;
+        active = kept;
+    }
+}
+
+} // namespace
+
+bool BatchSimulator::run(const PolicySpec& xSpec, const PolicySpec& oSpec, long long matches,
+    BatchSimResult& result, int lanes) {
+    result = BatchSimResult();
+    result.lanes = std::max(1, lanes);
+    if (xSpec.kind == POLICY_PERFECT || oSpec.kind == POLICY_PERFECT) {
+        std::cerr << "[ERROR] BatchSimulator does not support the perfect policy\n";
+        return false;
+    }
+#ifdef USE_OMP
+    double startTime = omp_get_wtime();
+#else
+    auto startTime = std::clock();
+#endif
+
+    PolicyTable tables[2];
+    SidePolicy side[2];
+    const PolicySpec* specs[2] = { &xSpec, &oSpec };
+    for (int s = 0; s < 2; ++s) {
+        side[s].stochastic = specs[s]->kind == POLICY_STOCHASTIC;
+        if (side[s].stochastic) continue;
+        tables[s].compile(specs[s]->weights);
+        side[s].table = &tables[s];
+        side[s].weights = &specs[s]->weights;
+    }
+
+    const ThreadContext context = ThreadContext::current();
+    long long winsX = 0, winsO = 0, draws = 0, moves = 0;
+#ifdef USE_OMP
+#pragma omp parallel reduction(+:winsX,winsO,draws,moves)
+#endif
+    {
+        ContextBinding bindContext(context);
+        int threads = 1, id = 0;
+#ifdef USE_OMP
+        threads = omp_get_num_threads();
+        id = omp_get_thread_num();
+#endif
+        long long share = matches * (id + 1) / threads - matches * id / threads;
+        BatchSimResult part;
+        if (share > 0) simulate(side, share, result.lanes, part);
+        winsX += part.winsX;
+        winsO += part.winsO;
+        draws += part.draws;
+        moves += part.moves;
+    }
+
+    result.winsX = winsX;
+    result.winsO = winsO;
+    result.draws = draws;
+    result.moves = moves;
+    result.matches = winsX + winsO + draws;
+    Metrics::add(METRIC_MATCHES, static_cast<unsigned long long>(result.matches));
+    Metrics::add(METRIC_WINS_X, static_cast<unsigned long long>(winsX));
+    Metrics::add(METRIC_WINS_O, static_cast<unsigned long long>(winsO));
+    Metrics::add(METRIC_DRAWS, static_cast<unsigned long long>(draws));
+    Metrics::add(METRIC_MOVES, static_cast<unsigned long long>(moves));
+#ifdef USE_OMP
+    result.elapsedSeconds = omp_get_wtime() - startTime;
+#else
+    result.elapsedSeconds = double(std::clock() - startTime) / CLOCKS_PER_SEC;
+#endif
+    return true;
+}
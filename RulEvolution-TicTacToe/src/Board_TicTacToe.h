@@ -47,6 +47,13 @@ public:
      */
     bool isEmpty(int idx) const;
 
+    /**
+     * @fn char Board::at(int idx) const
+     * @brief Content of a cell ('X', 'O' or ' '); ' ' for an invalid index.
+     * @param idx Index of the cell (0..8).
+     */
+    char at(int idx) const { return (idx >= 0 && idx < 9) ? cells[idx] : ' '; }
+
     /**
      * @fn bool Board::isFull() const
      * @brief Check if the board is completely filled.
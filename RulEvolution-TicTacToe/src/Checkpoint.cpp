@@ -0,0 +1,260 @@
+// ================================================================
+//  Checkpoint.cpp — Binary checkpoints and the background writer
+//  Notes:
+//    - payload fields are appended one by one (no struct padding in the
+//      file); integers and doubles use the host byte order, as the
+//      policy table files do;
+//    - the file is synced before the rename and its directory after it,
+//      so after a crash either the old or the new checkpoint is on disk,
+//      complete;
+//    - the payload size in the header is checked against the file size
+//      before anything is allocated for it.
+// ================================================================
+#define _CRT_SECURE_NO_WARNINGS
+#include "Checkpoint.h"
+#include "ThreadContext.h"
+#include "Trace.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<CheckpointData>::value,
+    "checkpoint snapshots must stay plain memory copies");
+
+namespace {
+
+    const char FILE_MAGIC[8] = { 'R', 'U', 'L', 'E', 'V', 'C', 'K', 'P' };
+
+    struct CheckpointHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t payloadSize;
+        std::uint64_t checksum;      ///< FNV-1a 64 of the payload
+    };
+    static_assert(sizeof(CheckpointHeader) == 24, "CheckpointHeader layout");
+
+    class Writer {
+    public:
+        template <class T> void put(const T& value) {
+            static_assert(std::is_arithmetic<T>::value, "scalar fields only");
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        template <class T, size_t N> void put(const std::array<T, N>& values) {
+            for (const T& v : values) put(v);
+        }
+        std::string bytes;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(const std::string& b) : bytes(b) {}
+        template <class T> bool get(T& value) {
+            if (offset + sizeof(T) > bytes.size()) return false;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        }
+        template <class T, size_t N> bool get(std::array<T, N>& values) {
+            for (T& v : values)
+                if (!get(v)) return false;
+            return true;
+        }
+        bool done() const { return offset == bytes.size(); }
+    private:
+        const std::string& bytes;
+        size_t offset = 0;
+    };
+
+    /**
+     * @brief Replace target by source; atomic on POSIX, MoveFileEx on Windows.
+     *        On POSIX the directory is synced too, or the rename itself may
+     *        not survive a crash.
+     */
+    bool replaceFile(const std::string& source, const std::string& target) {
+#ifdef _WIN32
+        return MoveFileExA(source.c_str(), target.c_str(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        if (std::rename(source.c_str(), target.c_str()) != 0) return false;
+        std::size_t slash = target.find_last_of('/');
+        std::string dir = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : target.substr(0, slash));
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) return false;
+        bool synced = fsync(fd) == 0 || errno == EINVAL;  // some file systems cannot sync a directory
+        ::close(fd);
+        return synced;
+#endif
+    }
+
+} // namespace
+
+std::uint64_t Checkpoint::hash(const std::string& bytes) {
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char c : bytes) {
+        h ^= c;
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+bool Checkpoint::save(const std::string& path, const CheckpointData& data) {
+    TraceSpan span(TRACE_IO);
+    const LearningModule& m = data.learner;
+    Writer w;
+    w.put(m.learningRate);
+    w.put(static_cast<std::uint32_t>(RULE_COUNT));
+    w.put(m.weight);
+    w.put(m.counter);
+    w.put(m.threshold);
+    w.put(m.initialWeight);
+    w.put(m.evidence);
+    w.put(m.updates);
+    w.put(static_cast<std::uint32_t>(m.activeMask));
+    w.put(static_cast<std::uint32_t>(m.initialMask));
+    w.put(static_cast<std::int32_t>(m.trainingStats.humanVsRulev));
+    w.put(static_cast<std::int32_t>(m.trainingStats.stochasticVsRulev));
+    w.put(static_cast<std::int32_t>(m.trainingStats.rulevVsRulev));
+    w.put(data.random.seed);
+    w.put(data.random.position);
+    w.put(data.jobsHash);
+    w.put(data.jobIndex);
+    w.put(data.jobMatches);
+
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = VERSION;
+    header.payloadSize = static_cast<std::uint32_t>(w.bytes.size());
+    header.checksum = Checkpoint::hash(w.bytes);
+
+    std::string tmp = path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1
+        && std::fwrite(w.bytes.data(), 1, w.bytes.size(), f) == w.bytes.size()
+        && std::fflush(f) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return replaceFile(tmp, path);
+}
+
+bool Checkpoint::load(const std::string& path, CheckpointData& data) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    CheckpointHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1
+        && std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+        && header.version == VERSION;
+    // The payload must be exactly the rest of the file: a corrupt size must
+    // not decide how much memory is allocated before the checksum is known.
+    long remaining = -1;
+    if (ok && std::fseek(f, 0, SEEK_END) == 0) {
+        remaining = std::ftell(f) - static_cast<long>(sizeof(header));
+        ok = std::fseek(f, static_cast<long>(sizeof(header)), SEEK_SET) == 0;
+    }
+    ok = ok && remaining >= 0 && static_cast<std::uint64_t>(remaining) == header.payloadSize;
+    std::string payload;
+    if (ok) {
+        payload.resize(header.payloadSize);
+        ok = std::fread(&payload[0], 1, payload.size(), f) == payload.size()
+            && std::fgetc(f) == EOF
+            && Checkpoint::hash(payload) == header.checksum;
+    }
+    std::fclose(f);
+    if (!ok) return false;
+
+    CheckpointData loaded;
+    LearningModule& m = loaded.learner;
+    Reader r(payload);
+    std::uint32_t ruleCount = 0, active = 0, initial = 0;
+    std::int32_t human = 0, stochastic = 0, rulev = 0;
+    ok = r.get(m.learningRate) && r.get(ruleCount) && ruleCount == RULE_COUNT
+        && r.get(m.weight) && r.get(m.counter) && r.get(m.threshold)
+        && r.get(m.initialWeight) && r.get(m.evidence) && r.get(m.updates)
+        && r.get(active) && r.get(initial)
+        && r.get(human) && r.get(stochastic) && r.get(rulev)
+        && r.get(loaded.random.seed) && r.get(loaded.random.position)
+        && r.get(loaded.jobsHash) && r.get(loaded.jobIndex) && r.get(loaded.jobMatches)
+        && r.done();
+    if (!ok) return false;
+
+    m.activeMask = active;
+    m.initialMask = initial;
+    m.trainingStats.humanVsRulev = human;
+    m.trainingStats.stochasticVsRulev = stochastic;
+    m.trainingStats.rulevVsRulev = rulev;
+    m.verbose = data.learner.verbose;  // a display setting, not state
+    data = loaded;
+    return true;
+}
+
+// --- CheckpointWriter -------------------------------------------------------
+
+void CheckpointWriter::start(const std::string& file, double intervalSeconds) {
+    stop();
+    path = file;
+    interval = (intervalSeconds > 0.0) ? intervalSeconds : 60.0;
+    pending = false;
+    running = true;
+
+    const ThreadContext context = ThreadContext::current();
+    worker = std::thread([this, context]() {
+        ContextBinding bindContext(context);
+        std::unique_lock<std::mutex> lock(mtx);
+        while (running) {
+            cv.wait_for(lock, std::chrono::duration<double>(interval), [this]() { return !running; });
+            if (!running) break;
+            lock.unlock();
+            writePending();
+            lock.lock();
+        }
+    });
+}
+
+void CheckpointWriter::submit(const CheckpointData& data) {
+    std::lock_guard<std::mutex> lock(mtx);
+    snapshot = data;
+    pending = true;
+}
+
+void CheckpointWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+    writePending();
+}
+
+void CheckpointWriter::writePending() {
+    CheckpointData data;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!pending) return;
+        data = snapshot;
+        pending = false;
+    }
+    if (Checkpoint::save(path, data)) ++writeCount;
+    else std::cerr << "[WARN] Cannot write checkpoint " << path << "\n";
+}
@@ -0,0 +1,91 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "LearningModule.h"
+#include "Random.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @struct CheckpointData
+ * @brief Everything needed to continue a run: the complete learner, the
+ *        random stream and the position in the job list.
+ *
+ * Trivially copyable, so taking a snapshot is a plain memory copy.
+ */
+struct CheckpointData {
+    LearningModule learner{ 0.02 };  ///< Complete learner state (weights, counters, thresholds, stats)
+    RandomState random;              ///< Shared random stream
+    std::uint64_t jobsHash = 0;      ///< Hash of the job list the cursor refers to
+    std::int32_t jobIndex = 0;       ///< Job in progress (0-based); earlier jobs are complete
+    std::int64_t jobMatches = 0;     ///< Matches of that job already trained
+};
+
+/**
+ * @class Checkpoint
+ * @brief Binary checkpoint file: fixed header (magic "RULEVCKP", version,
+ *        payload size, FNV-1a checksum) followed by the payload written
+ *        field by field. Doubles are stored bit-exact.
+ */
+class Checkpoint {
+public:
+    static const std::uint32_t VERSION = 1;
+
+    /**
+     * @brief Write a checkpoint to <path>.tmp, flush it to disk and rename
+     *        it over <path>, so a crash never leaves a partial file behind.
+     */
+    static bool save(const std::string& path, const CheckpointData& data);
+
+    /**
+     * @brief Read a checkpoint; fails on bad magic, unknown version, size or
+     *        checksum mismatch. On failure data is left unchanged.
+     */
+    static bool load(const std::string& path, CheckpointData& data);
+
+    /// FNV-1a 64 of a byte string (payload checksum, job-list hash).
+    static std::uint64_t hash(const std::string& bytes);
+};
+
+/**
+ * @class CheckpointWriter
+ * @brief Background thread that writes the most recent snapshot every
+ *        interval. submit() only copies the snapshot under a mutex, so the
+ *        training loop never waits for the disk.
+ */
+class CheckpointWriter {
+public:
+    CheckpointWriter() = default;
+    ~CheckpointWriter() { stop(); }
+
+    /// Start the writer thread.
+    void start(const std::string& path, double intervalSeconds);
+
+    /// Replace the pending snapshot (written at the next period).
+    void submit(const CheckpointData& snapshot);
+
+    /// Stop the thread, writing the pending snapshot first.
+    void stop();
+
+    bool isRunning() const { return running; }
+    int written() const { return writeCount.load(); }  ///< Checkpoints written so far
+
+private:
+    void writePending();
+
+    std::string path;
+    double interval = 60.0;
+    bool running = false;
+    bool pending = false;
+    std::atomic<int> writeCount{ 0 };
+    CheckpointData snapshot;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,63 @@
+// ================================================================
+//  ConvergenceMonitor.cpp — Early stop of Super-Training runs
+//  Notes:
+//    - the first round only sets the references (no test can pass);
+//    - the win-rate reference pools every round of the current streak,
+//      so the test gets sharper as the streak grows.
+// ================================================================
+#include "ConvergenceMonitor.h"
+#include <algorithm>
+#include <cmath>
+
+ConvergenceMonitor::ConvergenceMonitor(const ConvergenceConfig& cfg)
+    : config(cfg) {
+}
+
+void ConvergenceMonitor::reset() {
+    sample = ConvergenceSample();
+    rounds = 0;
+    streak = 0;
+    previousCrossingRate = 0.0;
+    refWins = 0;
+    refMatches = 0;
+}
+
+bool ConvergenceMonitor::observe(const RuleArray& before, const LearningModule& after,
+    const SuperTrainingResult& round, int scenario) {
+    if (round.matches <= 0) return converged();
+
+    long long wins = (scenario == 1) ? round.winsO : round.winsX;
+    double n = static_cast<double>(round.matches);
+
+    sample.weightDelta = 0.0;
+    for (int r = RULE_BLOCK; r < RULE_COUNT; ++r)
+        sample.weightDelta = std::max(sample.weightDelta, std::fabs(after.weights()[r] - before[r]));
+    sample.crossingRate = round.thresholdCrossings / n;
+    sample.winRate = wins / n;
+
+    bool first = (rounds++ == 0);
+    sample.weightsStable = !first && sample.weightDelta <= config.weightTolerance;
+    sample.crossingsStable = !first && previousCrossingRate > 0.0
+        && std::fabs(sample.crossingRate - previousCrossingRate) <= config.crossingTolerance * previousCrossingRate;
+
+    sample.winStable = false;
+    if (!first && refMatches > 0) {
+        double ref = static_cast<double>(refWins) / refMatches;
+        double se = std::sqrt(sample.winRate * (1.0 - sample.winRate) / n + ref * (1.0 - ref) / refMatches);
+        sample.winStable = std::fabs(sample.winRate - ref) + config.z * se < config.winMargin;
+    }
+    previousCrossingRate = sample.crossingRate;
+
+    if (sample.weightsStable && sample.crossingsStable && sample.winStable) {
+        ++streak;
+        refWins += wins;
+        refMatches += round.matches;
+    }
+    else {
+        // The streak restarts here: this round becomes the new reference.
+        streak = 0;
+        refWins = wins;
+        refMatches = round.matches;
+    }
+    return converged();
+}
@@ -0,0 +1,84 @@
+#ifndef CONVERGENCEMONITOR_H
+#define CONVERGENCEMONITOR_H
+
+#include "LearningModule.h"
+#include "SuperTraining.h"
+
+/**
+ * @struct ConvergenceConfig
+ * @brief Tolerances of the convergence monitor; every test must hold for
+ *        `patience` consecutive rounds.
+ *
+ * With a fixed learning rate the weights never stop moving: they settle
+ * into a stationary band whose width is a few learning-rate steps. The
+ * defaults therefore test for stationarity, not for zero change.
+ */
+struct ConvergenceConfig {
+    double weightTolerance = 0.05;    ///< Max |weight change| of any adaptive rule between two merges
+    double crossingTolerance = 0.05;  ///< Max relative change of threshold crossings per match
+    double winMargin = 0.03;          ///< Equivalence margin of the win-rate test
+    double z = 1.645;                 ///< One-sided normal quantile of the win-rate test (alpha = 0.05)
+    int patience = 3;                 ///< Consecutive rounds that must pass
+    int roundMatches = 10000;         ///< Matches between two merges when no other round size is set
+};
+
+/**
+ * @struct ConvergenceSample
+ * @brief Measurements of the last observed round.
+ */
+struct ConvergenceSample {
+    double weightDelta = 0.0;   ///< Max |weight change| over the adaptive rules
+    double crossingRate = 0.0;  ///< Threshold crossings per match
+    double winRate = 0.0;       ///< Win rate of the learning side
+    bool weightsStable = false;
+    bool crossingsStable = false;
+    bool winStable = false;
+};
+
+/**
+ * @class ConvergenceMonitor
+ * @brief Decides, round after round, whether a Super-Training run has
+ *        converged and can stop early.
+ *
+ * After each merge it checks three tests:
+ *  - the largest weight change since the previous merge;
+ *  - the relative change of the threshold crossing rate;
+ *  - a sequential equivalence test (two one-sided tests) between the
+ *    round's win rate and the pooled win rate of the current stable
+ *    streak: |p - p_ref| + z * se must stay below the margin.
+ * A round that fails any test restarts the streak at that round.
+ */
+class ConvergenceMonitor {
+public:
+    explicit ConvergenceMonitor(const ConvergenceConfig& config = ConvergenceConfig());
+
+    /// Forget every observed round (start of a new run).
+    void reset();
+
+    /**
+     * @brief Account one merged round.
+     * @param before Learner weights before the round.
+     * @param after Learner after the merge.
+     * @param round Result of the round.
+     * @param scenario Super-Training scenario (the learning side is O in 1, X in 2).
+     * @return true once the tests have held for `patience` consecutive rounds.
+     */
+    bool observe(const RuleArray& before, const LearningModule& after,
+        const SuperTrainingResult& round, int scenario);
+
+    bool converged() const { return streak >= config.patience; }
+    int stableRounds() const { return streak; }
+    const ConvergenceSample& last() const { return sample; }
+    const ConvergenceConfig& settings() const { return config; }
+
+private:
+    ConvergenceConfig config;
+    ConvergenceSample sample;
+    int rounds = 0;             ///< Rounds observed since reset()
+    int streak = 0;             ///< Consecutive rounds passing every test
+    double previousCrossingRate = 0.0;
+    long long refWins = 0;      ///< Pooled wins of the reference window
+    long long refMatches = 0;   ///< Pooled matches of the reference window
+};
+
+#endif // CONVERGENCEMONITOR_H
@@ -0,0 +1,48 @@
+// ================================================================
+//  Engine.cpp — Reentrant training context (OpenMP Optional)
+//  Notes:
+//    - omp_set_num_threads() sets the calling thread's own ICV, so two
+//      engines on two threads keep their own team sizes;
+//    - a fresh engine starts from the default rule parameters.
+// ================================================================
+#include "Engine.h"
+#include "BatchRunner.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+Engine::Engine(const EngineOptions& options)
+    : settings(options), learning(options.learningRate), randomSource(options.seed) {
+    learning.setDefaultParameters();
+    learning.recordInitialWeights();
+    learning.setVerbose(options.verbose);
+}
+
+ThreadContext Engine::context() {
+    ThreadContext c;
+    c.random = &randomSource;
+    c.metrics = &metricsRegistry;
+    c.trace = &traceSession;
+    return c;
+}
+
+Engine::Scope::Scope(Engine& engine)
+    : binding(engine.context()) {
+#ifdef USE_OMP
+    previousThreads = omp_get_max_threads();
+    if (engine.settings.threads > 0)
+        omp_set_num_threads(engine.settings.threads);
+#endif
+}
+
+Engine::Scope::~Scope() {
+#ifdef USE_OMP
+    omp_set_num_threads(previousThreads);
+#endif
+}
+
+int Engine::runBatch(int argc, char* argv[]) {
+    Scope scope(*this);
+    return BatchRunner::runFromArgs(argc, argv, learning);
+}
@@ -0,0 +1,86 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "LearningModule.h"
+#include "Metrics.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include "Trace.h"
+#include <cstdint>
+
+/**
+ * @struct EngineOptions
+ * @brief Construction settings of an Engine.
+ */
+struct EngineOptions {
+    double learningRate = 0.02;           ///< Learning rate of the engine's learner
+    int threads = 0;                      ///< OpenMP threads of the engine's parallel regions (0 = runtime default)
+    std::uint64_t seed = 0x853C49E6748FEA9Bull;  ///< Seed of the engine's random stream
+    bool verbose = true;                  ///< Per-rule update trace of the learner
+};
+
+/**
+ * @class Engine
+ * @brief Self-contained training context: learner, random stream, metrics
+ *        registry, trace session and the team size of its parallel regions.
+ *
+ * Engine::Scope binds the engine to the calling thread, and every parallel
+ * region or background thread the engine starts binds the same context in
+ * its workers (ContextBinding), so the draws, metrics and spans of one
+ * engine never reach another: several engines can train concurrently on
+ * separate threads, each used from one thread at a time under its Scope.
+ * OpenMP forks every region's team from the thread that runs it, so two
+ * engines never share a team; `threads` sizes the engine's teams.
+ *
+ * What stays process-wide is what the process receives once: signals.
+ * A SIGUSR1 dumps every active trace session, and SIGINT/SIGTERM stop
+ * every running `serve` job. Code outside any engine uses the process
+ * default source, registry and session.
+ */
+class Engine {
+public:
+    explicit Engine(const EngineOptions& options = EngineOptions());
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    LearningModule& learner() { return learning; }
+    const LearningModule& learner() const { return learning; }
+    RandomSource& random() { return randomSource; }
+    MetricsRegistry& metrics() { return metricsRegistry; }
+    TraceSession& trace() { return traceSession; }
+    const EngineOptions& options() const { return settings; }
+
+    /// The engine's random source, metrics registry and trace session.
+    ThreadContext context();
+
+    /**
+     * @class Scope
+     * @brief Makes the engine current on the calling thread: its context
+     *        is bound (parallel regions rebind it in their workers) and,
+     *        with OpenMP, its thread count applies to the regions this
+     *        thread starts. Both are restored on destruction.
+     */
+    class Scope {
+    public:
+        explicit Scope(Engine& engine);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ContextBinding binding;
+        int previousThreads = 0;
+    };
+
+    /// Headless batch run (see BatchRunner::runFromArgs) inside this engine.
+    int runBatch(int argc, char* argv[]);
+
+private:
+    EngineOptions settings;
+    LearningModule learning;
+    RandomSource randomSource;
+    MetricsRegistry metricsRegistry;
+    TraceSession traceSession;
+};
+
+#endif // ENGINE_H
@@ -0,0 +1,242 @@
+// ================================================================
+//  EvolutionarySearch.cpp — Population-based weight search (OpenMP Optional)
+//  Notes:
+//    - exact fitness goes through ExactEvaluator::evaluateMany() and is
+//      cached: elites carried over are not evaluated again;
+//    - simulated fitness splits every individual's matches into fixed
+//      chunks and runs all chunks of the generation in one dynamic loop.
+// ================================================================
+#include "EvolutionarySearch.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "StochasticPlayer_TicTacToe.h"
+#include "Game_TicTacToe.h"
+#include "LearningModule.h"
+#include "WeightsIO.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+const int NUM_WEIGHTS = RULE_PREPARATION;  // player layout: index = rule - 1
+const int MATCH_CHUNK = 256;               // matches per simulation task
+
+/// Clamp to [0,1] and rescale to sum 1 (uniform if everything is zero).
+void normalizeWeights(std::vector<double>& weights) {
+    LearningState state;
+    state.weights = weights;
+    state.clamp();
+    state.normalize();
+    if (std::all_of(state.weights.begin(), state.weights.end(), [](double w) { return w == 0.0; }))
+        state.initialize(weights.size());
+    weights = state.weights;
+}
+
+} // namespace
+
+EvolutionarySearch::EvolutionarySearch(const EvolutionConfig& cfg)
+    : config(cfg), rng(cfg.seed) {
+    config.populationSize = std::max(2, config.populationSize);
+    config.eliteCount = std::max(0, std::min(config.eliteCount, config.populationSize - 1));
+    config.tournamentSize = std::max(1, config.tournamentSize);
+    if (config.matchesPerEval > 0 && config.opponent.kind == POLICY_PERFECT) {
+        std::cerr << "[WARN] No simulated perfect player: using exact evaluation.\n";
+        config.matchesPerEval = 0;
+    }
+}
+
+void EvolutionarySearch::initialize(const std::vector<double>& seedWeights) {
+    std::vector<double> seed = seedWeights;
+    seed.resize(NUM_WEIGHTS, seedWeights.empty() ? 1.0 : 0.0);
+    normalizeWeights(seed);
+
+    population.assign(config.populationSize, Individual());
+    population[0].state.weights = seed;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int i = 1; i < config.populationSize; ++i) {
+        std::vector<double> w(NUM_WEIGHTS);
+        // Half exploit the seed, half explore the whole simplex.
+        if (i % 2) {
+            w = seed;
+            for (double& x : w) x += std::normal_distribution<double>(0.0, 4 * config.mutationSigma)(rng);
+        }
+        else {
+            for (double& x : w) x = uniform(rng);
+        }
+        normalizeWeights(w);
+        population[i].state.weights = w;
+    }
+    generationCount = 0;
+}
+
+void EvolutionarySearch::evaluatePopulation() {
+    std::vector<int> pending;
+    for (int i = 0; i < static_cast<int>(population.size()); ++i)
+        if (!population[i].evaluated || config.matchesPerEval > 0) pending.push_back(i);
+    if (pending.empty()) return;
+
+    if (config.matchesPerEval <= 0) {
+        std::vector<std::vector<double>> weightSets;
+        for (int i : pending) weightSets.push_back(population[i].state.weights);
+        std::vector<ExactResult> results = ExactEvaluator::evaluateMany(weightSets, config.opponent);
+        for (size_t k = 0; k < pending.size(); ++k) {
+            Individual& ind = population[pending[k]];
+            ind.win = results[k].win;
+            ind.draw = results[k].draw;
+            ind.loss = results[k].loss;
+        }
+    }
+    else {
+        const int matches = config.matchesPerEval;
+        const int chunks = (matches + MATCH_CHUNK - 1) / MATCH_CHUNK;
+        const int tasks = static_cast<int>(pending.size()) * chunks;
+        std::vector<int> wins(tasks, 0), draws(tasks, 0), losses(tasks, 0);
+
+        const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int t = 0; t < tasks; ++t) {
+            ContextBinding bindContext(context);
+            const Individual& ind = population[pending[t / chunks]];
+            int n = std::min(MATCH_CHUNK, matches - (t % chunks) * MATCH_CHUNK);
+
+            RulEvolutionPlayer candidate('X', ind.state, false);
+            Player* opponent = nullptr;
+            if (config.opponent.kind == POLICY_STOCHASTIC) {
+                opponent = new StochasticPlayer('O');
+            }
+            else {
+                LearningState oppState;
+                oppState.weights = config.opponent.weights;
+                opponent = new RulEvolutionPlayer('O', oppState, false);
+            }
+            opponent->setVerbose(false);
+
+            for (int m = 0; m < n; ++m) {
+                Game g(&candidate, opponent);
+                char winner = g.play(false);
+                if (winner == 'X') wins[t]++;
+                else if (winner == 'O') losses[t]++;
+                else draws[t]++;
+            }
+            delete opponent;
+        }
+
+        for (size_t k = 0; k < pending.size(); ++k) {
+            int w = 0, d = 0, l = 0;
+            for (int c = 0; c < chunks; ++c) {
+                w += wins[k * chunks + c];
+                d += draws[k * chunks + c];
+                l += losses[k * chunks + c];
+            }
+            Individual& ind = population[pending[k]];
+            ind.win = double(w) / matches;
+            ind.draw = double(d) / matches;
+            ind.loss = double(l) / matches;
+        }
+    }
+
+    for (int i : pending) {
+        Individual& ind = population[i];
+        ind.fitness = ind.win + 0.5 * ind.draw;
+        ind.evaluated = true;
+    }
+    evaluationCount += static_cast<long long>(pending.size());
+}
+
+void EvolutionarySearch::sortByFitness() {
+    // Stable: ties keep their order, so exact runs stay reproducible.
+    std::stable_sort(population.begin(), population.end(),
+        [](const Individual& a, const Individual& b) { return a.fitness > b.fitness; });
+}
+
+const Individual& EvolutionarySearch::tournament() {
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(population.size()) - 1);
+    int best = pick(rng);
+    for (int k = 1; k < config.tournamentSize; ++k)
+        best = std::min(best, pick(rng));  // population is sorted: lower index = fitter
+    return population[best];
+}
+
+std::vector<double> EvolutionarySearch::crossover(const std::vector<double>& a, const std::vector<double>& b) {
+    std::bernoulli_distribution coin(0.5);
+    std::vector<double> child(a.size());
+    for (size_t i = 0; i < a.size(); ++i)
+        child[i] = coin(rng) ? a[i] : b[i];
+    return child;
+}
+
+void EvolutionarySearch::mutate(std::vector<double>& weights) {
+    std::bernoulli_distribution hit(config.mutationRate);
+    std::normal_distribution<double> step(0.0, config.mutationSigma);
+    for (double& w : weights)
+        if (hit(rng)) w += step(rng);
+}
+
+void EvolutionarySearch::step() {
+    if (population.empty()) initialize(std::vector<double>());
+
+    evaluatePopulation();
+    sortByFitness();
+
+    std::vector<Individual> next(population.begin(), population.begin() + config.eliteCount);
+    std::bernoulli_distribution doCrossover(config.crossoverRate);
+    while (static_cast<int>(next.size()) < config.populationSize) {
+        const Individual& a = tournament();
+        std::vector<double> child = a.state.weights;
+        if (doCrossover(rng)) child = crossover(child, tournament().state.weights);
+        mutate(child);
+        normalizeWeights(child);
+
+        Individual ind;
+        ind.state.weights = child;
+        next.push_back(ind);
+    }
+
+    // Keep the evaluated generation around for best()/elites() until the next step.
+    elite.assign(population.begin(), population.begin() + std::max(1, config.eliteCount));
+    population.swap(next);
+    ++generationCount;
+}
+
+void EvolutionarySearch::run(bool verbose) {
+    if (population.empty()) initialize(std::vector<double>());
+
+    for (int g = 0; g < config.generations; ++g) {
+        step();
+        if (verbose) {
+            const Individual& b = best();
+            std::cout << "[INFO] Generation " << generationCount
+                << " | best fitness " << std::fixed << std::setprecision(4) << b.fitness
+                << " (W " << b.win << " / D " << b.draw << " / L " << b.loss << ")\n";
+        }
+    }
+}
+
+const Individual& EvolutionarySearch::best() const {
+    static const Individual none;
+    return elite.empty() ? none : elite.front();
+}
+
+std::vector<Individual> EvolutionarySearch::elites() const {
+    return std::vector<Individual>(elite.begin(), elite.begin() + std::min<size_t>(elite.size(), config.eliteCount));
+}
+
+bool EvolutionarySearch::exportElites(const std::string& prefix) const {
+    std::vector<Individual> best = elites();
+    if (best.empty()) return false;
+    for (size_t i = 0; i < best.size(); ++i) {
+        LearningModule module(0.02);
+        module.setDefaultParameters();
+        module.importPlayerWeights(best[i].state.weights);
+        if (!WeightsIO::save(module, prefix + "_elite" + std::to_string(i + 1) + ".txt")) return false;
+    }
+    return true;
+}
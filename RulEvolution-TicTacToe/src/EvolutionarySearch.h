@@ -0,0 +1,99 @@
+#ifndef EVOLUTIONARYSEARCH_H
+#define EVOLUTIONARYSEARCH_H
+
+#include "LearningState.h"
+#include "ExactEvaluator.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @struct EvolutionConfig
+ * @brief Parameters of a population-based weight search.
+ */
+struct EvolutionConfig {
+    int populationSize = 64;       ///< Individuals per generation
+    int generations = 50;          ///< Generations to run
+    int eliteCount = 4;            ///< Best individuals copied unchanged into the next generation
+    int tournamentSize = 3;        ///< Individuals drawn per parent selection
+    double crossoverRate = 0.7;    ///< Probability that a child mixes two parents
+    double mutationRate = 0.3;     ///< Per-weight mutation probability
+    double mutationSigma = 0.05;   ///< Standard deviation of a mutation step
+    int matchesPerEval = 0;        ///< Simulated matches per fitness evaluation (0 = exact evaluation)
+    PolicySpec opponent;           ///< Opponent the candidates play against (as O)
+    unsigned seed = 1;             ///< Seed of the selection/mutation generator
+};
+
+/**
+ * @struct Individual
+ * @brief One candidate weight vector and its measured fitness.
+ */
+struct Individual {
+    LearningState state;   ///< Weights in RulEvolutionPlayer layout
+    double fitness = 0.0;  ///< win + draw / 2 against the opponent
+    double win = 0.0;      ///< Win rate
+    double draw = 0.0;     ///< Draw rate
+    double loss = 0.0;     ///< Loss rate
+    bool evaluated = false;
+};
+
+/**
+ * @class EvolutionarySearch
+ * @brief Genetic search over RulEvolutionPlayer weight vectors: tournament
+ *        selection, uniform crossover, Gaussian mutation and elitism.
+ *
+ * Fitness comes either from ExactEvaluator (deterministic, exact win/draw/loss
+ * probabilities) or from simulated matches. Either way a generation is one
+ * parallel loop over all evaluation tasks of the population, so every core
+ * stays busy. Selection and mutation draw from their own seeded generator,
+ * so an exact-fitness search is fully reproducible.
+ */
+class EvolutionarySearch {
+public:
+    explicit EvolutionarySearch(const EvolutionConfig& config);
+
+    /**
+     * @brief Build the first generation: the seed vector plus mutated copies.
+     * @param seedWeights Starting weights (RulEvolutionPlayer layout); empty = uniform.
+     */
+    void initialize(const std::vector<double>& seedWeights);
+
+    /// Evaluate the current generation and breed the next one.
+    void step();
+
+    /**
+     * @brief Run config.generations generations (initializing first if needed).
+     * @param verbose Print one [INFO] line per generation.
+     */
+    void run(bool verbose = true);
+
+    /// Best individual of the last evaluated generation.
+    const Individual& best() const;
+    /// The config.eliteCount best individuals, best first.
+    std::vector<Individual> elites() const;
+
+    /**
+     * @brief Save every elite through WeightsIO as <prefix>_elite<N>.txt (N from 1).
+     * @return false if there is nothing to export or a file cannot be written.
+     */
+    bool exportElites(const std::string& prefix) const;
+
+    int generation() const { return generationCount; }    ///< Generations completed
+    long long evaluations() const { return evaluationCount; } ///< Fitness evaluations performed
+
+private:
+    void evaluatePopulation();
+    void sortByFitness();
+    const Individual& tournament();
+    std::vector<double> crossover(const std::vector<double>& a, const std::vector<double>& b);
+    void mutate(std::vector<double>& weights);
+
+    EvolutionConfig config;
+    std::vector<Individual> population;  ///< Generation to be evaluated next
+    std::vector<Individual> elite;       ///< Best of the last evaluated generation, best first
+    std::mt19937 rng;
+    int generationCount = 0;
+    long long evaluationCount = 0;
+};
+
+#endif // EVOLUTIONARYSEARCH_H
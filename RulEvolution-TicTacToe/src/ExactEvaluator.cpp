@@ -0,0 +1,217 @@
+// ================================================================
+//  ExactEvaluator.cpp — Exact policy evaluation (OpenMP Optional)
+//  Notes:
+//    - values are memoized per (board code, side to move);
+//    - the minimax table for POLICY_PERFECT is built once, thread-safely;
+//    - evaluateMany() runs one independent memo per weight vector.
+// ================================================================
+#include "ExactEvaluator.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "StochasticPlayer_TicTacToe.h"
+#include "ThreadContext.h"
+#include <array>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    const int POW3[9] = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561 };
+
+    inline int sideIndex(char side) { return side == 'X' ? 0 : 1; }
+    inline char other(char side) { return side == 'X' ? 'O' : 'X'; }
+
+    /**
+     * @brief Minimax value (+1 win, 0 draw, -1 loss) for the side to move,
+     *        for every (code, side). Unreachable codes are simply unused.
+     */
+    class MinimaxTable {
+    public:
+        MinimaxTable() : value(2 * ExactEvaluator::NUM_CODES), known(2 * ExactEvaluator::NUM_CODES, 0) {}
+
+        int get(const Board& board, int code, char side) {
+            int key = 2 * code + sideIndex(side);
+            if (known[key]) return value[key];
+
+            int best = -2;
+            for (int i = 0; i < 9; ++i) {
+                if (!board.isEmpty(i)) continue;
+                Board next = board;
+                next.place(i, side);
+                int v;
+                if (next.winner() == side) v = 1;
+                else if (next.isFull()) v = 0;
+                else v = -get(next, code + POW3[i] * (side == 'X' ? 1 : 2), other(side));
+                if (v > best) best = v;
+            }
+            value[key] = (best == -2) ? 0 : best;
+            known[key] = 1;
+            return value[key];
+        }
+
+    private:
+        std::vector<int> value;
+        std::vector<char> known;
+    };
+
+    /// Shared minimax table, filled completely on first use.
+    MinimaxTable& minimax() {
+        static MinimaxTable* table = []() {
+            MinimaxTable* t = new MinimaxTable();
+            Board empty;
+            t->get(empty, 0, 'X');
+            t->get(empty, 0, 'O');
+            return t;
+        }();
+        return *table;
+    }
+
+    /**
+     * @brief Forward DP for one pair of policies: V(state) = sum over moves of
+     *        P(move) * V(child), terminal states scored from X's point of view.
+     */
+    class TreeEvaluator {
+    public:
+        TreeEvaluator(const PolicySpec& x, const PolicySpec& o)
+            : px(x), po(o), memo(2 * ExactEvaluator::NUM_CODES), known(2 * ExactEvaluator::NUM_CODES, 0) {
+        }
+
+        ExactResult run(double firstX) {
+            Board empty;
+            ExactResult a = value(empty, 0, 'X');
+            ExactResult b = value(empty, 0, 'O');
+            ExactResult r;
+            r.win = firstX * a.win + (1.0 - firstX) * b.win;
+            r.draw = firstX * a.draw + (1.0 - firstX) * b.draw;
+            r.loss = firstX * a.loss + (1.0 - firstX) * b.loss;
+            r.positions = visited;
+            return r;
+        }
+
+    private:
+        ExactResult value(const Board& board, int code, char side) {
+            int key = 2 * code + sideIndex(side);
+            if (known[key]) return memo[key];
+            ++visited;
+
+            std::array<double, 9> prob = policy(board, code, side);
+            ExactResult r;
+            for (int i = 0; i < 9; ++i) {
+                if (prob[i] <= 0.0) continue;
+                Board next = board;
+                if (!next.place(i, side)) {
+                    // Invalid move: Game::play awards the match to the opponent.
+                    addOutcome(r, other(side), prob[i]);
+                    continue;
+                }
+                char w = next.winner();
+                if (w != ' ') addOutcome(r, w, prob[i]);
+                else if (next.isFull()) r.draw += prob[i];
+                else {
+                    ExactResult c = value(next, code + POW3[i] * (side == 'X' ? 1 : 2), other(side));
+                    r.win += prob[i] * c.win;
+                    r.draw += prob[i] * c.draw;
+                    r.loss += prob[i] * c.loss;
+                }
+            }
+            memo[key] = r;
+            known[key] = 1;
+            return r;
+        }
+
+        static void addOutcome(ExactResult& r, char winner, double p) {
+            if (winner == 'X') r.win += p;
+            else r.loss += p;
+        }
+
+        std::array<double, 9> policy(const Board& board, int code, char side) {
+            const PolicySpec& spec = (side == 'X') ? px : po;
+            std::array<double, 9> prob{};
+
+            if (spec.kind == POLICY_RULEVOLUTION)
+                return RulEvolutionPlayer::distribution(board, side, spec.weights).prob;
+
+            int count = 0;
+            std::array<bool, 9> allowed{};
+            for (int i = 0; i < 9; ++i) {
+                if (!board.isEmpty(i)) continue;
+                if (spec.kind == POLICY_PERFECT) {
+                    Board next = board;
+                    next.place(i, side);
+                    int v;
+                    if (next.winner() == side) v = 1;
+                    else if (next.isFull()) v = 0;
+                    else v = -minimax().get(next, code + POW3[i] * (side == 'X' ? 1 : 2), other(side));
+                    allowed[i] = (v == minimax().get(board, code, side));
+                }
+                else {
+                    allowed[i] = true;
+                }
+                if (allowed[i]) ++count;
+            }
+            for (int i = 0; i < 9; ++i)
+                if (allowed[i]) prob[i] = 1.0 / count;
+            return prob;
+        }
+
+        const PolicySpec& px;
+        const PolicySpec& po;
+        std::vector<ExactResult> memo;
+        std::vector<char> known;
+        int visited = 0;
+    };
+
+} // namespace
+
+std::unique_ptr<Player> PolicySpec::makePlayer(char symbol) const {
+    std::unique_ptr<Player> player;
+    if (kind == POLICY_RULEVOLUTION) {
+        LearningState state;
+        state.weights = weights;
+        player.reset(new RulEvolutionPlayer(symbol, state, false));
+    }
+    else if (kind == POLICY_STOCHASTIC) {
+        player.reset(new StochasticPlayer(symbol));
+    }
+    else {
+        return player;  // POLICY_PERFECT: no simulated player
+    }
+    player->setVerbose(false);
+    return player;
+}
+
+int ExactEvaluator::encode(const Board& board) {
+    int code = 0;
+    for (int i = 0; i < 9; ++i) {
+        char c = board.at(i);
+        if (c == 'X') code += POW3[i];
+        else if (c == 'O') code += 2 * POW3[i];
+    }
+    return code;
+}
+
+ExactResult ExactEvaluator::evaluate(const PolicySpec& x, const PolicySpec& o, double firstX) {
+    if (x.kind == POLICY_PERFECT || o.kind == POLICY_PERFECT)
+        minimax();  // build the shared table before any parallel use
+    TreeEvaluator tree(x, o);
+    return tree.run(firstX);
+}
+
+std::vector<ExactResult> ExactEvaluator::evaluateMany(const std::vector<std::vector<double>>& weightSets,
+    const PolicySpec& opponent, bool selfPlay) {
+    std::vector<ExactResult> results(weightSets.size());
+    if (opponent.kind == POLICY_PERFECT)
+        minimax();
+
+    const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < static_cast<int>(weightSets.size()); ++i) {
+        ContextBinding bindContext(context);
+        PolicySpec candidate = PolicySpec::rulevolution(weightSets[i]);
+        results[i] = evaluate(candidate, selfPlay ? candidate : opponent);
+    }
+    return results;
+}
@@ -0,0 +1,97 @@
+#ifndef EXACTEVALUATOR_H
+#define EXACTEVALUATOR_H
+
+#include "Board_TicTacToe.h"
+#include <memory>
+#include <vector>
+#include <string>
+
+class Player;
+
+/**
+ * @enum PolicyKind
+ * @brief Move policies the exact evaluator can propagate through the game tree.
+ */
+enum PolicyKind {
+    POLICY_RULEVOLUTION = 0,  ///< Reflective-Exploration distribution of RulEvolutionPlayer
+    POLICY_STOCHASTIC,        ///< Uniform over empty cells (StochasticPlayer)
+    POLICY_PERFECT            ///< Uniform over minimax-optimal moves
+};
+
+/**
+ * @struct PolicySpec
+ * @brief A policy and, for RulEvolution, its adaptive weight vector.
+ */
+struct PolicySpec {
+    PolicyKind kind = POLICY_STOCHASTIC;
+    std::vector<double> weights;  ///< Adaptive weights (RulEvolution only)
+
+    static PolicySpec rulevolution(const std::vector<double>& w) {
+        PolicySpec p;
+        p.kind = POLICY_RULEVOLUTION;
+        p.weights = w;
+        return p;
+    }
+    static PolicySpec stochastic() { return PolicySpec(); }
+    static PolicySpec perfect() {
+        PolicySpec p;
+        p.kind = POLICY_PERFECT;
+        return p;
+    }
+
+    /// False for POLICY_PERFECT, which only the exact evaluator can play.
+    bool simulable() const { return kind != POLICY_PERFECT; }
+
+    /**
+     * @brief A quiet Player following this policy.
+     * @return nullptr if the policy is not simulable().
+     */
+    std::unique_ptr<Player> makePlayer(char symbol) const;
+};
+
+/**
+ * @struct ExactResult
+ * @brief Exact outcome probabilities from player X's point of view.
+ */
+struct ExactResult {
+    double win = 0.0;    ///< P(X wins)
+    double draw = 0.0;   ///< P(draw)
+    double loss = 0.0;   ///< P(O wins)
+    int positions = 0;   ///< Distinct (position, side to move) states visited
+};
+
+/**
+ * @class ExactEvaluator
+ * @brief Exact policy evaluation by dynamic programming over the game tree.
+ *
+ * Move probabilities are propagated from the initial position (first mover
+ * drawn 50/50, as in Game::play) through every reachable position, memoized
+ * by (base-3 board code, side to move). One pass replaces any number of
+ * simulated matches and is deterministic.
+ */
+class ExactEvaluator {
+public:
+    /**
+     * @brief Exact win/draw/loss probabilities of X against O.
+     * @param x Policy of player X.
+     * @param o Policy of player O.
+     * @param firstX Probability that X moves first (Game::play uses 0.5).
+     */
+    static ExactResult evaluate(const PolicySpec& x, const PolicySpec& o, double firstX = 0.5);
+
+    /**
+     * @brief Evaluate many RulEvolution weight vectors (as X) against one opponent, in parallel.
+     * @param selfPlay If true each vector plays against itself and opponent is ignored.
+     */
+    static std::vector<ExactResult> evaluateMany(const std::vector<std::vector<double>>& weightSets,
+        const PolicySpec& opponent, bool selfPlay = false);
+
+    /**
+     * @brief Base-3 code of a board (cell i contributes 3^i: 0 empty, 1 X, 2 O).
+     */
+    static int encode(const Board& board);
+
+    static const int NUM_CODES = 19683;  ///< 3^9
+};
+
+#endif // EXACTEVALUATOR_H
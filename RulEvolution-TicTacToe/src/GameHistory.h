@@ -1,57 +1,66 @@
 #ifndef GAMEHISTORY_H
 #define GAMEHISTORY_H
 
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 #include "RulEvolutionRules.h"  // for RuleType
 
-/**
- * @struct MoveRecord
- * @brief Represents a single move with all rules that suggested it.
- */
-struct MoveRecord {
-    int move;                        ///< Cell index chosen
-    std::vector<RuleType> rules;     ///< List of rules that supported this move
-};
-
 /**
  * @class GameHistory
  * @brief Stores the sequence of moves and their associated RulEvolution rules.
  * It also keeps track of the match outcome for learning purposes.
+ *
+ * Fixed-size encoding: a match has at most 9 moves, so every move is a
+ * one-byte cell index plus a one-byte rule bitmask (bit = 1 << RuleType)
+ * and one bit for the side that played it. The whole history is a small
+ * trivially copyable value: recording never allocates and copying is a
+ * plain memory copy.
  */
 class GameHistory {
 public:
-    std::vector<MoveRecord> moves;   ///< Sequence of all moves made in the match
-    bool hasWon;                     ///< True if the RulEvolution player has won
-    int totalMoves;                  ///< Total number of moves recorded
-    int rulevMoves;                  ///< Moves made by the RulEvolution player only
+    static const int MAX_MOVES = 9;
+
+    std::uint8_t cells[MAX_MOVES] = {};  ///< Cell index of each move
+    std::uint8_t rules[MAX_MOVES] = {};  ///< Rules that supported each move (bit = 1 << RuleType)
+    std::uint16_t sideO = 0;             ///< Bit i set if move i was played by 'O'
+    std::uint8_t count = 0;              ///< Number of moves recorded
+    std::uint8_t rulevMoves = 0;         ///< Moves supported by at least one rule
+    char winner = 0;                     ///< 'X', 'O', ' ' for a draw, 0 while unfinished
+    bool hasWon = false;                 ///< True if the RulEvolution player has won
 
     /**
-     * @brief Default constructor. Initializes all counters.
+     * @brief Add a move with the rules that supported it.
+     * @param move The chosen cell index
+     * @param ruleMask Rules applied for this move (bit = 1 << RuleType)
+     * @param side Player who made the move ('X' or 'O')
      */
-    GameHistory()
-        : hasWon(false), totalMoves(0), rulevMoves(0) {
+    void addMove(int move, unsigned ruleMask, char side = 'X') noexcept {
+        if (count >= MAX_MOVES) return;
+        cells[count] = static_cast<std::uint8_t>(move);
+        rules[count] = static_cast<std::uint8_t>(ruleMask);
+        if (side == 'O') sideO |= static_cast<std::uint16_t>(1u << count);
+        if (ruleMask) rulevMoves++;
+        count++;
     }
 
     /**
-     * @brief Add a move with the rules that supported it.
+     * @brief Add a move with the list of rules that supported it.
      * @param move The chosen cell index
-     * @param rules The list of rules applied for this move
+     * @param ruleList The list of rules applied for this move
      */
-    void addMove(int move, const std::vector<RuleType>& rules) {
-        moves.push_back({ move, rules });
-        totalMoves++;
-        if (!rules.empty())
-            rulevMoves++;
+    void addMove(int move, const std::vector<RuleType>& ruleList, char side = 'X') noexcept {
+        unsigned mask = 0;
+        for (RuleType r : ruleList)
+            if (r >= 0 && r < RULE_COUNT) mask |= 1u << r;
+        addMove(move, mask, side);
     }
 
     /**
      * @brief Clear the game history.
      */
     void clear() noexcept {
-        moves.clear();
-        hasWon = false;
-        totalMoves = 0;
-        rulevMoves = 0;
+        *this = GameHistory();
     }
 
     /**
@@ -62,13 +71,24 @@ public:
         hasWon = win;
     }
 
+    /**
+     * @brief Side ('X' or 'O') that made move i.
+     */
+    char side(int i) const noexcept {
+        return (sideO >> i) & 1u ? 'O' : 'X';
+    }
+
     /**
      * @brief Returns the number of recorded moves.
      * @return int Number of moves stored.
      */
     int size() const noexcept {
-        return static_cast<int>(moves.size());
+        return count;
     }
 };
 
-#endif // GAMEHISTORY_H
\ No newline at end of file
+static_assert(RULE_COUNT <= 8, "GameHistory stores rule masks in one byte");
+static_assert(std::is_trivially_copyable<GameHistory>::value, "GameHistory must stay a plain value");
+static_assert(sizeof(GameHistory) <= 32, "GameHistory should fit in 32 bytes");
+
+#endif // GAMEHISTORY_H
@@ -0,0 +1,293 @@
+// ================================================================
+//  GameLog.cpp — Append-only columnar game log
+//  Notes:
+//    - block slots are reserved with one atomic add; each writer then
+//      writes its own slot with positional I/O (no shared file cursor);
+//    - the block header is written last, so a torn block reads as empty;
+//    - integers use the host byte order, like the other binary files.
+// ================================================================
+#include "GameLog.h"
+#include "Trace.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const char FILE_MAGIC[8] = { 'R', 'U', 'L', 'E', 'V', 'G', 'L', 'G' };
+    const std::uint32_t BLOCK_MAGIC = 0x4B4C4247;  // "GBLK"
+
+    struct LogFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t blockRecords;
+        std::uint32_t reserved[12];
+    };
+    static_assert(sizeof(LogFileHeader) == 64, "LogFileHeader layout");
+
+    struct LogBlockHeader {
+        std::uint32_t magic;
+        std::uint32_t count;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(LogBlockHeader) == 16, "LogBlockHeader layout");
+
+    const std::size_t META_OFFSET = sizeof(LogBlockHeader);
+    const std::size_t MASKS_OFFSET = META_OFFSET + GameLog::BLOCK_RECORDS * sizeof(std::uint32_t);
+
+    const std::uint32_t PERM_BITS = 19;
+    const std::uint32_t COUNT_SHIFT = 19;
+    const std::uint32_t FIRST_O_BIT = 1u << 23;
+    const std::uint32_t WINNER_SHIFT = 24;
+    const std::uint32_t HAS_WON_BIT = 1u << 26;
+
+    int popcount(std::uint64_t v) {
+        int n = 0;
+        for (; v; v &= v - 1) ++n;
+        return n;
+    }
+
+    const std::uint64_t RULE_LANES = 0x1041041041041ull;  // bit 6i for every move i
+
+} // namespace
+
+// --- Encoding ---------------------------------------------------------------
+
+void GameLog::encode(const GameHistory& history, std::uint32_t& meta, std::uint64_t& masks) {
+    int n = history.size();
+
+    // Lehmer code of the move order, completed with the unplayed cells.
+    unsigned available = 0x1FF;
+    std::uint32_t index = 0;
+    int position = 0;
+    auto take = [&](int cell) {
+        unsigned bit = 1u << cell;
+        index = index * (9 - position) + popcount(available & (bit - 1));
+        available &= ~bit;
+        ++position;
+    };
+    masks = 0;
+    for (int i = 0; i < n; ++i) {
+        take(history.cells[i]);
+        masks |= static_cast<std::uint64_t>(history.rules[i] & 0x3F) << (6 * i);
+    }
+    for (int cell = 0; cell < 9; ++cell)
+        if (available & (1u << cell)) take(cell);
+
+    std::uint32_t winner = 0;
+    if (history.winner == 'X') winner = 1;
+    else if (history.winner == 'O') winner = 2;
+    else if (history.winner == ' ') winner = 3;
+
+    meta = index
+        | static_cast<std::uint32_t>(n) << COUNT_SHIFT
+        | (n > 0 && history.side(0) == 'O' ? FIRST_O_BIT : 0u)
+        | winner << WINNER_SHIFT
+        | (history.hasWon ? HAS_WON_BIT : 0u);
+}
+
+void GameLog::decode(std::uint32_t meta, std::uint64_t masks, GameHistory& history) {
+    history.clear();
+
+    int digits[9];
+    std::uint32_t index = meta & ((1u << PERM_BITS) - 1);
+    for (int i = 8; i >= 0; --i) {
+        digits[i] = static_cast<int>(index % (9 - i));
+        index /= (9 - i);
+    }
+
+    int n = static_cast<int>((meta >> COUNT_SHIFT) & 0xF);
+    char side = (meta & FIRST_O_BIT) ? 'O' : 'X';
+    unsigned available = 0x1FF;
+    for (int i = 0; i < n && i < GameHistory::MAX_MOVES; ++i) {
+        // digits[i]-th smallest cell still available
+        int cell = 0;
+        for (int k = digits[i]; ; ++cell)
+            if ((available & (1u << cell)) && k-- == 0) break;
+        available &= ~(1u << cell);
+        history.addMove(cell, static_cast<unsigned>((masks >> (6 * i)) & 0x3F), side);
+        side = (side == 'X') ? 'O' : 'X';
+    }
+
+    static const char WINNERS[4] = { 0, 'X', 'O', ' ' };
+    history.winner = WINNERS[(meta >> WINNER_SHIFT) & 3u];
+    history.hasWon = (meta & HAS_WON_BIT) != 0;
+}
+
+int GameLog::ruleUses(std::uint64_t masks, int rule) {
+    return popcount(masks & (RULE_LANES << rule));
+}
+
+std::size_t GameLog::blockBytes() {
+    return MASKS_OFFSET + BLOCK_RECORDS * sizeof(std::uint64_t);
+}
+
+// --- File -------------------------------------------------------------------
+
+bool GameLog::open(const std::string& filename) {
+    close();
+    std::uint64_t size = 0;
+    LogFileHeader header;
+#ifdef _WIN32
+    HANDLE h = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    handle = h;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(h, &sz)) { close(); return false; }
+    size = static_cast<std::uint64_t>(sz.QuadPart);
+    if (size >= sizeof(header)) {
+        DWORD got = 0;
+        OVERLAPPED ov{};
+        if (!ReadFile(h, &header, sizeof(header), &got, &ov) || got != sizeof(header)) { close(); return false; }
+    }
+#else
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+    size = static_cast<std::uint64_t>(st.st_size);
+    if (size >= sizeof(header) && pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        close();
+        return false;
+    }
+#endif
+
+    if (size == 0) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = VERSION;
+        header.blockRecords = BLOCK_RECORDS;
+        if (!writeAt(0, &header, sizeof(header))) { close(); return false; }
+        size = sizeof(header);
+    }
+    else if (size < sizeof(header) || std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || header.version != VERSION || header.blockRecords != BLOCK_RECORDS) {
+        std::cerr << "[ERROR] " << filename << " is not a game log of this version\n";
+        close();
+        return false;
+    }
+
+    // Append after the last (possibly partial) block.
+    std::uint64_t data = size - sizeof(header);
+    nextBlock.store((data + blockBytes() - 1) / blockBytes());
+    return true;
+}
+
+void GameLog::close() {
+#ifdef _WIN32
+    if (handle) CloseHandle(static_cast<HANDLE>(handle));
+    handle = nullptr;
+#else
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+}
+
+bool GameLog::isOpen() const {
+#ifdef _WIN32
+    return handle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+bool GameLog::writeAt(std::uint64_t offset, const void* data, std::size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(offset);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD put = 0;
+        if (!WriteFile(static_cast<HANDLE>(handle), p, static_cast<DWORD>(size), &put, &ov) || put == 0)
+            return false;
+#else
+        ssize_t put = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (put <= 0) return false;
+#endif
+        p += put;
+        offset += static_cast<std::uint64_t>(put);
+        size -= static_cast<std::size_t>(put);
+    }
+    return true;
+}
+
+bool GameLog::appendBlock(const std::uint32_t* meta, const std::uint64_t* masks, std::uint32_t count) {
+    if (!isOpen() || count == 0 || count > BLOCK_RECORDS) return false;
+    TraceSpan span(TRACE_IO);
+    std::uint64_t slot = nextBlock.fetch_add(1);
+    std::uint64_t base = sizeof(LogFileHeader) + slot * blockBytes();
+
+    LogBlockHeader header{ BLOCK_MAGIC, count, 0 };
+    return writeAt(base + META_OFFSET, meta, count * sizeof(std::uint32_t))
+        && writeAt(base + MASKS_OFFSET, masks, count * sizeof(std::uint64_t))
+        && writeAt(base, &header, sizeof(header));
+}
+
+// --- GameLogWriter ------------------------------------------------------------
+
+GameLogWriter::GameLogWriter(GameLog& target)
+    : log(target), meta(GameLog::BLOCK_RECORDS), masks(GameLog::BLOCK_RECORDS) {
+}
+
+void GameLogWriter::append(const GameHistory& history) {
+    if (count == GameLog::BLOCK_RECORDS) flush();
+    GameLog::encode(history, meta[count], masks[count]);
+    ++count;
+}
+
+bool GameLogWriter::flush() {
+    if (count == 0) return true;
+    bool ok = log.appendBlock(meta.data(), masks.data(), count);
+    if (!ok) std::cerr << "[WARN] Cannot write " << count << " games to the game log\n";
+    count = 0;
+    return ok;
+}
+
+// --- GameLogReader ------------------------------------------------------------
+
+bool GameLogReader::open(const std::string& filename) {
+    blockOffsets.clear();
+    games = 0;
+    if (!file.open(filename) || file.size() < sizeof(LogFileHeader)) return false;
+
+    LogFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || header.version != GameLog::VERSION || header.blockRecords != GameLog::BLOCK_RECORDS) {
+        file.close();
+        return false;
+    }
+
+    // Block index: one header read per block.
+    for (std::size_t off = sizeof(LogFileHeader); off + sizeof(LogBlockHeader) <= file.size();
+        off += GameLog::blockBytes()) {
+        LogBlockHeader bh;
+        std::memcpy(&bh, file.data() + off, sizeof(bh));
+        if (bh.magic != BLOCK_MAGIC || bh.count == 0 || bh.count > GameLog::BLOCK_RECORDS) continue;
+        if (off + MASKS_OFFSET + bh.count * sizeof(std::uint64_t) > file.size()) continue;
+        blockOffsets.push_back(off);
+        games += bh.count;
+    }
+    return true;
+}
+
+GameLogBlock GameLogReader::block(std::size_t i) const {
+    GameLogBlock blk;
+    const unsigned char* base = file.data() + blockOffsets[i];
+    LogBlockHeader bh;
+    std::memcpy(&bh, base, sizeof(bh));
+    blk.count = bh.count;
+    blk.meta = reinterpret_cast<const std::uint32_t*>(base + META_OFFSET);
+    blk.masks = reinterpret_cast<const std::uint64_t*>(base + MASKS_OFFSET);
+    return blk;
+}
@@ -0,0 +1,155 @@
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include "GameHistory.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct GameLogBlock
+ * @brief Zero-copy view of one block of a mapped game log: two columns of
+ *        `count` entries each (see GameLog for the encoding).
+ */
+struct GameLogBlock {
+    const std::uint32_t* meta = nullptr;   ///< Move order, move count, first side, winner, outcome
+    const std::uint64_t* masks = nullptr;  ///< 6-bit rule mask of every move
+    std::uint32_t count = 0;               ///< Records in the block
+};
+
+/**
+ * @class GameLog
+ * @brief Append-only on-disk game log shared by any number of writers.
+ *
+ * One game is 12 bytes in two columns:
+ *  - meta (u32): bits 0-18 permutation index of the move order (the played
+ *    cells followed by the unplayed ones in ascending order, 9! < 2^19),
+ *    bits 19-22 move count, bit 23 first mover is 'O', bits 24-25 winner
+ *    (0 unfinished, 1 'X', 2 'O', 3 draw), bit 26 learning outcome (hasWon);
+ *  - masks (u64): rule bitmask of move i in bits 6i..6i+5.
+ *
+ * The file is a 64-byte header followed by fixed-size blocks of
+ * BLOCK_RECORDS games (16-byte block header, meta column, masks column).
+ * Writers reserve a whole block with one atomic add and write it at its
+ * offset, so appends never take a lock. A block that was reserved but never
+ * written (crash) reads as empty and is skipped.
+ */
+class GameLog {
+public:
+    static const std::uint32_t BLOCK_RECORDS = 4096;
+    static const std::uint32_t VERSION = 1;
+
+    GameLog() = default;
+    ~GameLog() { close(); }
+    GameLog(const GameLog&) = delete;
+    GameLog& operator=(const GameLog&) = delete;
+
+    /**
+     * @brief Open a log for appending, creating it if needed.
+     * @return false if the file cannot be opened or is not a game log.
+     */
+    bool open(const std::string& filename);
+
+    /// Close the file (writers must be flushed first).
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * @brief Write one block of records at the next free block slot (thread-safe).
+     * @return false on I/O error.
+     */
+    bool appendBlock(const std::uint32_t* meta, const std::uint64_t* masks, std::uint32_t count);
+
+    /// Pack a history into its two column values.
+    static void encode(const GameHistory& history, std::uint32_t& meta, std::uint64_t& masks);
+    /// Rebuild a history from its column values.
+    static void decode(std::uint32_t meta, std::uint64_t masks, GameHistory& history);
+
+    /// Move count of a meta column value.
+    static int moveCount(std::uint32_t meta) { return static_cast<int>((meta >> 19) & 0xFu); }
+    /// Winner code of a meta column value: 0 unfinished, 1 'X', 2 'O', 3 draw.
+    static int winnerCode(std::uint32_t meta) { return static_cast<int>((meta >> 24) & 3u); }
+    /// Recorded learning outcome of a meta column value.
+    static bool hasWon(std::uint32_t meta) { return ((meta >> 26) & 1u) != 0; }
+
+    /// Number of moves of a game (masks column value) supported by a rule.
+    static int ruleUses(std::uint64_t masks, int rule);
+
+    /// Size in bytes of one block on disk.
+    static std::size_t blockBytes();
+
+private:
+    bool writeAt(std::uint64_t offset, const void* data, std::size_t size);
+
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+    std::atomic<std::uint64_t> nextBlock{ 0 };  ///< Next free block slot
+};
+
+/**
+ * @class GameLogWriter
+ * @brief Per-thread buffer in front of a GameLog: games are encoded into a
+ *        private block and handed to the log when the block is full.
+ */
+class GameLogWriter {
+public:
+    explicit GameLogWriter(GameLog& log);
+    ~GameLogWriter() { flush(); }
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    /// Record one finished game.
+    void append(const GameHistory& history);
+
+    /// Write the partial block (if any).
+    bool flush();
+
+private:
+    GameLog& log;
+    std::vector<std::uint32_t> meta;
+    std::vector<std::uint64_t> masks;
+    std::uint32_t count = 0;
+};
+
+/**
+ * @class GameLogReader
+ * @brief Memory-mapped reader; blocks are exposed in place, without copies.
+ */
+class GameLogReader {
+public:
+    /**
+     * @brief Map a log and index its non-empty blocks.
+     * @return false if the file is missing or is not a game log.
+     */
+    bool open(const std::string& filename);
+
+    std::size_t blockCount() const { return blockOffsets.size(); }
+    std::uint64_t gameCount() const { return games; }
+    GameLogBlock block(std::size_t i) const;
+
+    /// Decode every game in file order: fn(const GameHistory&).
+    template <class Fn>
+    void forEach(Fn fn) const {
+        GameHistory history;
+        for (std::size_t b = 0; b < blockCount(); ++b) {
+            GameLogBlock blk = block(b);
+            for (std::uint32_t i = 0; i < blk.count; ++i) {
+                GameLog::decode(blk.meta[i], blk.masks[i], history);
+                fn(history);
+            }
+        }
+    }
+
+private:
+    MappedFile file;
+    std::vector<std::size_t> blockOffsets;  ///< Offset of every non-empty block
+    std::uint64_t games = 0;
+};
+
+#endif // GAMELOG_H
@@ -1,18 +1,28 @@
 #include "Game_TicTacToe.h"
 #include "RulEvolutionPlayer_TicTacToe.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "Random.h"
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 
-extern LearningModule learner;
-
-Game::Game(Player* pX, Player* pO)
-    : board(), playerX(pX), playerO(pO), currentTurn('X') {
+Game::Game(Player* pX, Player* pO, LearningModule* learningModule)
+    : board(), playerX(pX), playerO(pO), learner(learningModule), currentTurn('X') {
 }
 
 char Game::play(bool verbose) {
+    Random::channel(RANDOM_CHANNEL_GAME);
+    return play(verbose, (Random::below(2) == 0) ? 'X' : 'O');
+}
+
+char Game::play(bool verbose, char firstMover) {
+    PhaseTimer timer(PHASE_SELECTION);
+    TraceSpan span(TRACE_MATCH);
+    playerX->beginMatch();
+    playerO->beginMatch();
     board.reset();
-    currentTurn = (std::rand() % 2 == 0) ? 'X' : 'O';
+    currentTurn = firstMover;
     gameHistory.clear();
 
     if (verbose) {
@@ -30,9 +40,11 @@ char Game::play(bool verbose) {
         }
 
         int move = -1;
-        std::vector<RuleType> rulesUsed;
+        unsigned rulesUsed = 0;
 
         // Se il player  di tipo RulEvolution, usa la versione che restituisce le regole usate
+        // Each side draws from its own channel of an active match stream.
+        Random::channel(currentTurn == 'X' ? RANDOM_CHANNEL_X : RANDOM_CHANNEL_O);
         if (currentTurn == 'X') {
             if (auto rp = dynamic_cast<RulEvolutionPlayer*>(playerX))
                 move = rp->chooseMove(board, rulesUsed);
@@ -47,18 +59,27 @@ char Game::play(bool verbose) {
         }
 
         if (!board.place(move, currentTurn)) {
+            gameHistory.winner = (currentTurn == 'X') ? 'O' : 'X';
+            Metrics::add(METRIC_INVALID_MOVES);
+            Metrics::add(METRIC_MATCHES);
+            Metrics::movesPerMatch(moveCount);
             std::cout << "Invalid move by " << currentTurn
                 << " at cell " << move << std::endl;
             return (currentTurn == 'X') ? 'O' : 'X';
         }
 
         // Registra la mossa nel gameHistory
-        gameHistory.addMove(move, rulesUsed);
+        gameHistory.addMove(move, rulesUsed, currentTurn);
         moveCount++;
+        Metrics::add(METRIC_MOVES);
 
         char winner = board.winner();
 
         if (winner != ' ') {
+            gameHistory.winner = winner;
+            Metrics::add(METRIC_MATCHES);
+            Metrics::add(winner == 'X' ? METRIC_WINS_X : METRIC_WINS_O);
+            Metrics::movesPerMatch(moveCount);
             if (verbose) {
                 board.print();
                 std::cout << "Winner: " << winner << std::endl;
@@ -67,6 +88,10 @@ char Game::play(bool verbose) {
         }
 
         if (board.isFull()) {
+            gameHistory.winner = ' ';
+            Metrics::add(METRIC_MATCHES);
+            Metrics::add(METRIC_DRAWS);
+            Metrics::movesPerMatch(moveCount);
             if (verbose) {
                 board.print();
                 std::cout << "It's a draw!" << std::endl;
@@ -97,16 +122,17 @@ char Game::playAndLearn(GameHistory& history, bool verbose) {
     }
 
     if (isDraw) {
-        std::cout << "[LEARN] Draw detected -> no weight change." << std::endl;
+        if (learner && learner->isVerbose())
+            std::cout << "[LEARN] Draw detected -> no weight change." << std::endl;
         history = gameHistory;
         return winner;
     }
 
     // Aggiorna il learning module
-    if (rulevWon)
-        learner.updateFromGame(gameHistory, true);
-    else if (rulevLost)
-        learner.updateFromGame(gameHistory, false);
+    if (learner && rulevWon)
+        learner->updateFromGame(gameHistory, true);
+    else if (learner && rulevLost)
+        learner->updateFromGame(gameHistory, false);
 
     // Esporta la history al chiamante
     history = gameHistory;
@@ -10,18 +10,23 @@
 
 class Game {
 public:
-    Game(Player* pX, Player* pO);
+    // learner: module updated by playAndLearn() (nullptr = record only)
+    Game(Player* pX, Player* pO, LearningModule* learner = nullptr);
 
     // Plays a single match
     char play(bool verbose = false);
 
-    // Plays a match and updates learning afterwards
+    // Plays a single match with a fixed first mover ('X' or 'O')
+    char play(bool verbose, char firstMover);
+
+    // Plays a match and updates the learner (if any) afterwards
     char playAndLearn(GameHistory& history, bool verbose = false);
 
 private:
     Board board;
     Player* playerX;
     Player* playerO;
+    LearningModule* learner;
     char currentTurn;
     GameHistory gameHistory;
 };
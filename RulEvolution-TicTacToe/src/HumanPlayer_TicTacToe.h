@@ -7,6 +7,7 @@ class HumanPlayer : public Player {
 public:
     explicit HumanPlayer(char s) : Player(s) {}
     int chooseMove(const Board& board) override;
+    std::unique_ptr<Player> clone() const override { return std::unique_ptr<Player>(new HumanPlayer(*this)); }
 };
 
 #endif // HUMANPLAYER_TICTACTOE_H
\ No newline at end of file
@@ -1,43 +1,69 @@
 ﻿// ================================================================
-//  LearningModule.cpp — Parallel-friendly (OpenMP Optional, MSVC-safe)
+//  LearningModule.cpp — Dense rule arrays (sequential by design)
 //  Notes:
 //    - updateFromGame() kept sequential for determinism (threshold logic).
-//    - normalizeWeights() uses index-based loops over a refs vector
-//      to be valid under MSVC OpenMP on ARM64.
+//    - rule data lives in fixed arrays indexed by RuleType; with
+//      RULE_COUNT = 6 an OpenMP region costs far more than the loop
+//      it would split, so normalizeWeights() is a plain loop.
 // ================================================================
 #include "LearningModule.h"
 #include "RulEvolutionRules.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
 #include <vector>
-#include <functional> // std::reference_wrapper
+#include <type_traits>
+#include <cmath>
 
-#ifdef USE_OMP
-#include <omp.h>
-#endif
+static_assert(std::is_trivially_copyable<LearningModule>::value,
+    "LearningModule copies must stay plain memory copies");
 
 LearningModule::LearningModule(double eta)
     : learningRate(eta) {
 }
 
+void LearningModule::activate(RuleType rule, double initial, double ruleThreshold) {
+    weight[rule] = initial;
+    counter[rule] = 0.0;
+    threshold[rule] = ruleThreshold;
+    activeMask |= 1u << rule;
+}
+
 // --- Initialization and configuration --------------------------------------
 
-void LearningModule::setRuleParameters(RuleType rule, double initialWeight, double threshold) {
-    ruleData[rule] = RuleStats(initialWeight, threshold);
+void LearningModule::setRuleParameters(RuleType rule, double initialWeight, double ruleThreshold) {
+    if (rule < 0 || rule >= RULE_COUNT) return;
+    activate(rule, initialWeight, ruleThreshold);
+}
+
+void LearningModule::setDefaultParameters() {
+    setRuleParameters(RULE_BLOCK, 0.278, 5.0);
+    setRuleParameters(RULE_PREPARATION, 0.222, 5.0);
+    setRuleParameters(RULE_CENTER, 0.222, 5.0);
+    setRuleParameters(RULE_CORNER, 0.167, 5.0);
+    setRuleParameters(RULE_SIDE, 0.111, 5.0);
 }
 
 void LearningModule::recordInitialWeights() {
-    initialWeights.clear();
-    for (const auto& pair : ruleData)
-        initialWeights[pair.first] = pair.second.weight;
+    initialWeight = weight;
+    initialMask = activeMask;
 }
 
 void LearningModule::incrementTrainingCount(const std::string& gameType) {
-    if (gameType == "HumanVsRulev")        trainingStats.humanVsRulev++;
-    else if (gameType == "StochasticVsRulev") trainingStats.stochasticVsRulev++;
-    else if (gameType == "RulevVsRulev")     trainingStats.rulevVsRulev++;
+    if (gameType == "HumanVsRulev")        incrementTrainingCount(TRAIN_HUMAN_VS_RULEV);
+    else if (gameType == "StochasticVsRulev") incrementTrainingCount(TRAIN_STOCHASTIC_VS_RULEV);
+    else if (gameType == "RulevVsRulev")     incrementTrainingCount(TRAIN_RULEV_VS_RULEV);
+}
+
+void LearningModule::incrementTrainingCount(TrainingScenario scenario, int count) {
+    switch (scenario) {
+    case TRAIN_HUMAN_VS_RULEV:      trainingStats.humanVsRulev += count; break;
+    case TRAIN_STOCHASTIC_VS_RULEV: trainingStats.stochasticVsRulev += count; break;
+    case TRAIN_RULEV_VS_RULEV:      trainingStats.rulevVsRulev += count; break;
+    }
 }
 
 // --- Learning core ----------------------------------------------------------
@@ -49,35 +75,52 @@ void LearningModule::incrementTrainingCount(const std::string& gameType) {
  *        per-move threshold/reset semantics (deterministic behavior).
  */
 void LearningModule::updateFromGame(const GameHistory& history, bool hasWon) {
+    if (!verbose) {
+        // Same result as the traced loop below, in O(rules) instead of O(moves x rules)
+        RuleUsage usage = RuleUsage::fromHistory(history, hasWon);
+        updateFromBatch(&usage, 1, true);
+        return;
+    }
+
+    PhaseTimer timer(PHASE_LEARNING);
+    TraceSpan span(TRACE_LEARNING);
+    Metrics::add(METRIC_LEARNING_UPDATES);
     std::cout << "\n=== LEARNING UPDATE START ===\n";
 
-    for (const auto& moveRecord : history.moves) {
-        for (auto rule : moveRecord.rules) {
-            auto& stats = ruleData[rule];
-            double oldWeight = stats.weight;
+    for (int i = 0; i < history.size(); ++i) {
+        for (int r = 0; r < RULE_COUNT; ++r) {
+            if (!((history.rules[i] >> r) & 1u)) continue;
+            RuleType rule = static_cast<RuleType>(r);
+            if (!hasRule(rule)) activate(rule, 0.5, 5.0);  // same defaults as RuleStats
+            double oldWeight = weight[rule];
 
             // Evidence accumulation
-            stats.counter += (hasWon ? 1.0 : -1.0);
+            counter[rule] += (hasWon ? 1.0 : -1.0);
+            evidence[rule] += (hasWon ? 1.0 : -1.0);
 
             // Thresholded updates
-            if (stats.counter >= stats.threshold) {
-                stats.weight += learningRate;
-                stats.counter = 0.0;
+            if (counter[rule] >= threshold[rule]) {
+                weight[rule] += learningRate;
+                counter[rule] = 0.0;
+                updates[rule] += 1.0;
+                Metrics::add(METRIC_THRESHOLD_UP);
             }
-            else if (stats.counter <= -stats.threshold) {
-                stats.weight -= learningRate;
-                stats.counter = 0.0;
+            else if (counter[rule] <= -threshold[rule]) {
+                weight[rule] -= learningRate;
+                counter[rule] = 0.0;
+                updates[rule] += 1.0;
+                Metrics::add(METRIC_THRESHOLD_DOWN);
             }
 
             // Clamp to [0, 1]
-            stats.weight = std::max(0.0, std::min(1.0, stats.weight));
+            weight[rule] = std::max(0.0, std::min(1.0, weight[rule]));
 
             // Trace
             std::cout << "Rule " << std::setw(2) << (int)rule << " (" << ruleToString(rule) << ")"
                 << " | Old: " << std::fixed << std::setprecision(3) << oldWeight
-                << " -> New: " << stats.weight
-                << " | Counter: " << stats.counter
-                << " | Threshold: " << stats.threshold << "\n";
+                << " -> New: " << weight[rule]
+                << " | Counter: " << counter[rule]
+                << " | Threshold: " << threshold[rule] << "\n";
         }
     }
 
@@ -85,79 +128,217 @@ void LearningModule::updateFromGame(const GameHistory& history, bool hasWon) {
     std::cout << "=== LEARNING UPDATE END ===\n\n";
 }
 
+/**
+ * @brief Batched update from per-game rule histograms.
+ *
+ *        Inside one game every occurrence of a rule moves its counter in the
+ *        same direction, so n occurrences are advanced in closed form: the
+ *        first crossing after k1 = ceil(T -/+ c) steps, then one every
+ *        ceil(T) steps, leftover steps stay in the counter.
+ *
+ *        strict = true : games in order, weights renormalized after every
+ *                        game and crossings applied one addition at a time
+ *                        -> bit-identical to calling updateFromGame() per game.
+ *        strict = false: rules are independent between normalizations, so
+ *                        each rule runs through the whole batch on its own
+ *                        and the weights are renormalized once at the end.
+ */
+void LearningModule::updateFromBatch(const std::vector<RuleUsage>& games, bool strict) {
+    updateFromBatch(games.data(), games.size(), strict);
+}
+
+void LearningModule::updateFromBatch(const RuleUsage* games, size_t count, bool strict) {
+    if (count == 0) return;
+    PhaseTimer timer(PHASE_LEARNING);
+    TraceSpan span(TRACE_LEARNING);
+    Metrics::add(METRIC_LEARNING_UPDATES, count);
+
+    if (strict) {
+        for (size_t i = 0; i < count; ++i) {
+            for (int r = 0; r < RULE_COUNT; ++r)
+                if (games[i].count[r]) advanceRule(r, games[i].count[r], games[i].hasWon, true);
+            normalizeWeights();
+        }
+        return;
+    }
+
+    for (int r = 0; r < RULE_COUNT; ++r)
+        for (size_t i = 0; i < count; ++i)
+            if (games[i].count[r]) advanceRule(r, games[i].count[r], games[i].hasWon, false);
+    normalizeWeights();
+}
+
+/**
+ * @brief Replay net evidence (positive = wins) on one rule's counter and
+ *        threshold, as if it had been observed here. Does not renormalize.
+ */
+void LearningModule::applyEvidence(RuleType rule, long long net) {
+    if (rule < 0 || rule >= RULE_COUNT || net == 0) return;
+    advanceRule(rule, net > 0 ? net : -net, net > 0, false);
+}
+
+/**
+ * @brief Apply n same-sign occurrences of one rule (see updateFromBatch()).
+ */
+void LearningModule::advanceRule(int r, long long n, bool hasWon, bool strict) {
+    RuleType rule = static_cast<RuleType>(r);
+    if (!hasRule(rule)) activate(rule, 0.5, 5.0);  // same defaults as RuleStats
+
+    double sign = hasWon ? 1.0 : -1.0;
+    double& c = counter[r];
+    double& w = weight[r];
+    const double T = threshold[r];
+    evidence[r] += sign * n;
+
+    // One occurrence, exactly as updateFromGame().
+    auto stepOnce = [&]() {
+        c += sign;
+        if (c >= T) { w += learningRate; c = 0.0; updates[r] += 1.0; Metrics::add(METRIC_THRESHOLD_UP); }
+        else if (c <= -T) { w -= learningRate; c = 0.0; updates[r] += 1.0; Metrics::add(METRIC_THRESHOLD_DOWN); }
+        w = std::max(0.0, std::min(1.0, w));
+    };
+
+    // Degenerate thresholds: replay the step-by-step rule.
+    if (!(T > 0.0) || T > 1e9) {
+        for (long long k = 0; k < n; ++k) stepOnce();
+        return;
+    }
+
+    // A counter at or past a threshold lowered by setThreshold() crosses on
+    // its next occurrence whatever the sign (c = 4, T = 2, a loss: c = 3 >= T,
+    // one step up). The closed form assumes |c| < T, so step until it holds;
+    // that takes one occurrence at most.
+    while (n > 0 && std::fabs(c) >= T) { stepOnce(); --n; }
+    if (n == 0) return;
+
+    long long first = std::max(1LL, static_cast<long long>(std::ceil(T - sign * c)));
+    if (n < first) {
+        c += sign * n;
+        w = std::max(0.0, std::min(1.0, w));  // every step clamps
+        return;
+    }
+
+    long long period = std::max(1LL, static_cast<long long>(std::ceil(T)));
+    long long crossings = 1 + (n - first) / period;
+    long long leftover = (n - first) % period;
+
+    // The first step clamps even without a crossing; afterwards w stays in [0,1]
+    // and same-sign additions commute with the clamp.
+    if (first > 1) w = std::max(0.0, std::min(1.0, w));
+    double step = sign * learningRate;
+    if (strict) {
+        for (long long k = 0; k < crossings; ++k)
+            w = std::max(0.0, std::min(1.0, w + step));
+    }
+    else {
+        w = std::max(0.0, std::min(1.0, w + step * crossings));
+    }
+    c = leftover ? sign * leftover : 0.0;
+    updates[r] += crossings;
+    Metrics::add(hasWon ? METRIC_THRESHOLD_UP : METRIC_THRESHOLD_DOWN, crossings);
+}
+
 /**
  * @brief Normalize all weights: clamp to [minW,maxW] and ensure sum = 1.
- *        MSVC-OpenMP-safe: iterate with index over a refs vector.
+ *        Only rules in use take part; two short passes over dense arrays.
  */
 void LearningModule::normalizeWeights(double minW, double maxW) {
-    // Build an indexable list of references to RuleStats to allow OpenMP index loops.
-    std::vector<std::reference_wrapper<RuleStats>> refs;
-    refs.reserve(ruleData.size());
-    for (auto& kv : ruleData) refs.push_back(kv.second);
-
     // 1) Clamp and accumulate total sum (single pass)
     double sum = 0.0;
-
-#ifdef USE_OMP
-#pragma omp parallel for reduction(+:sum)
-#endif
-    for (int i = 0; i < static_cast<int>(refs.size()); ++i) {
-        RuleStats& rs = refs[i].get();
-        rs.weight = std::max(minW, std::min(maxW, rs.weight));
-        sum += rs.weight;
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!(activeMask & (1u << r))) continue;
+        weight[r] = std::max(minW, std::min(maxW, weight[r]));
+        sum += weight[r];
     }
 
     // 2) Normalize if sum > 0 (separate pass to avoid dividing during reduction)
     if (sum > 0.0) {
-#ifdef USE_OMP
-#pragma omp parallel for
-#endif
-        for (int i = 0; i < static_cast<int>(refs.size()); ++i) {
-            RuleStats& rs = refs[i].get();
-            rs.weight /= sum;
-        }
+        for (int r = 0; r < RULE_COUNT; ++r)
+            if (activeMask & (1u << r)) weight[r] /= sum;
     }
 }
 
 // --- Utilities --------------------------------------------------------------
 
 void LearningModule::resetCounters() {
-    for (auto& pair : ruleData)
-        pair.second.counter = 0.0;
+    counter.fill(0.0);
 }
 
 bool LearningModule::setWeight(RuleType rule, double newWeight) {
-    auto it = ruleData.find(rule);
-    if (it == ruleData.end()) {
-        ruleData[rule] = RuleStats(newWeight, 5.0); // default threshold
+    if (rule < 0 || rule >= RULE_COUNT) return false;
+    if (!hasRule(rule)) {
+        activate(rule, newWeight, 5.0); // default threshold
         return true;
     }
-    it->second.weight = std::max(0.0, std::min(1.0, newWeight));
+    weight[rule] = std::max(0.0, std::min(1.0, newWeight));
+    return true;
+}
+
+bool LearningModule::setThreshold(RuleType rule, double newThreshold) {
+    if (!hasRule(rule) || !(newThreshold > 0.0)) return false;
+    threshold[rule] = newThreshold;
+    return true;
+}
+
+bool LearningModule::setCounter(RuleType rule, double newCounter) {
+    if (!hasRule(rule)) return false;
+    counter[rule] = newCounter;
     return true;
 }
 
+void LearningModule::addTotals(RuleType rule, double net, double crossings) {
+    if (!hasRule(rule)) return;
+    evidence[rule] += net;
+    updates[rule] += crossings;
+}
+
 double LearningModule::getThreshold(RuleType rule) const {
-    auto it = ruleData.find(rule);
-    return (it != ruleData.end()) ? it->second.threshold : 0.0;
+    return hasRule(rule) ? threshold[rule] : 0.0;
+}
+
+RuleStats LearningModule::getRuleStats(RuleType rule) const {
+    if (!hasRule(rule)) return RuleStats();
+    RuleStats stats(weight[rule], threshold[rule]);
+    stats.counter = counter[rule];
+    return stats;
 }
 
 // --- Accessors / reporting --------------------------------------------------
 
 std::unordered_map<RuleType, double> LearningModule::getWeights() const {
     std::unordered_map<RuleType, double> weights;
-    for (const auto& pair : ruleData)
-        weights[pair.first] = pair.second.weight;
+    for (int r = 0; r < RULE_COUNT; ++r)
+        if (activeMask & (1u << r))
+            weights[static_cast<RuleType>(r)] = weight[r];
     return weights;
 }
 
 std::vector<double> LearningModule::exportWeightVector() const {
-    std::vector<double> vec;
-    vec.reserve(ruleData.size());
-    for (const auto& pair : ruleData)
-        vec.push_back(pair.second.weight);
+    std::vector<double> vec(RULE_COUNT, 0.0);
+    for (int r = 0; r < RULE_COUNT; ++r)
+        if (activeMask & (1u << r))
+            vec[r] = weight[r];
     return vec;
 }
 
+/**
+ * @brief Adaptive weights indexed as (rule - 1), i.e. BLOCK, CENTER, CORNER,
+ *        SIDE, PREPARATION — the layout read by RulEvolutionRules::evaluate().
+ *        Missing rules default to 0.
+ */
+std::vector<double> LearningModule::exportPlayerWeights() const {
+    std::vector<double> vec(RULE_PREPARATION, 0.0);
+    for (int r = RULE_BLOCK; r <= RULE_PREPARATION; ++r)
+        vec[r - 1] = getWeight(static_cast<RuleType>(r));
+    return vec;
+}
+
+void LearningModule::importPlayerWeights(const std::vector<double>& playerWeights) {
+    size_t n = std::min(playerWeights.size(), static_cast<size_t>(RULE_PREPARATION));
+    for (size_t i = 0; i < n; ++i)
+        setWeight(static_cast<RuleType>(i + 1), std::max(0.0, std::min(1.0, playerWeights[i])));
+}
+
 void LearningModule::compareWeightVectors(const std::vector<double>& before,
     const std::vector<double>& after) {
     std::cout << "=== WEIGHT COMPARISON ===\n";
@@ -182,10 +363,11 @@ void LearningModule::printLearningReport() const {
     std::cout << "---------------------------------------------------------------\n";
 
     double total = 0.0;
-    for (const auto& pair : ruleData) {
-        RuleType rule = pair.first;
-        const RuleStats& stats = pair.second;
-        double init = (initialWeights.count(rule) ? initialWeights.at(rule) : stats.weight);
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!(activeMask & (1u << r))) continue;
+        RuleType rule = static_cast<RuleType>(r);
+        const RuleStats stats = getRuleStats(rule);
+        double init = ((initialMask >> r) & 1u) ? initialWeight[r] : stats.weight;
         double delta = stats.weight - init;
         total += stats.weight;
 
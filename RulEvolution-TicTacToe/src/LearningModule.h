@@ -3,6 +3,7 @@
 
 #include "RulEvolutionRules.h"   // For RuleType and ruleToString()
 #include "GameHistory.h"
+#include <array>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -33,6 +34,41 @@ struct TrainingStats {
     int rulevVsRulev = 0;
 };
 
+/**
+ * @enum TrainingScenario
+ * @brief Training scenario counted in TrainingStats.
+ */
+enum TrainingScenario {
+    TRAIN_HUMAN_VS_RULEV = 0,
+    TRAIN_STOCHASTIC_VS_RULEV,
+    TRAIN_RULEV_VS_RULEV
+};
+
+/// Dense per-rule array, indexed by RuleType.
+typedef std::array<double, RULE_COUNT> RuleArray;
+
+/**
+ * @struct RuleUsage
+ * @brief Compressed learning input of one game: how many times each rule
+ *        supported a move, plus the outcome. Move order is not needed
+ *        because every occurrence in a game moves a rule's counter the
+ *        same way.
+ */
+struct RuleUsage {
+    unsigned char count[RULE_COUNT] = {};  ///< Occurrences per rule
+    bool hasWon = false;                   ///< Outcome used for the update
+
+    /// Build the histogram of a recorded game.
+    static RuleUsage fromHistory(const GameHistory& history, bool hasWon) {
+        RuleUsage usage;
+        usage.hasWon = hasWon;
+        for (int i = 0; i < history.size(); ++i)
+            for (int r = 0; r < RULE_COUNT; ++r)
+                usage.count[r] += (history.rules[i] >> r) & 1u;
+        return usage;
+    }
+};
+
 /**
  * @class LearningModule
  * @brief Manages the adaptive learning logic for all RulEvolution rules.
@@ -42,6 +78,10 @@ struct TrainingStats {
  *  - maintaining stability through threshold-based evolution
  *  - normalizing weights so that their total sum is 1
  *  - exporting / printing readable learning reports
+ *
+ * Rule data is stored as fixed-capacity arrays indexed by rule id
+ * (structure of arrays) plus a bitmask of the rules in use, so the class
+ * is trivially copyable: copying a learner is a copy of a few cache lines.
  */
 class LearningModule {
 public:
@@ -49,14 +89,34 @@ public:
 
     // --- Initialization and configuration ---
     void setRuleParameters(RuleType rule, double initialWeight, double threshold);
+    void setDefaultParameters();                                    ///< Default weights/thresholds of a fresh session
     void recordInitialWeights();
     void incrementTrainingCount(const std::string& gameType);
+    void incrementTrainingCount(TrainingScenario scenario, int count = 1);
     void updateFromGame(const GameHistory& history, bool hasWon);
+    void updateFromBatch(const std::vector<RuleUsage>& games, bool strict = false); ///< Batched update from rule histograms
+    void updateFromBatch(const RuleUsage* games, size_t count, bool strict = false);
+    void applyEvidence(RuleType rule, long long net);              ///< Replay net evidence through the threshold logic
     void resetCounters();
+    void setVerbose(bool v) { verbose = v; }                        ///< Enable/disable the per-rule update trace
+    bool isVerbose() const { return verbose; }
 
     // --- Accessors ---
-    std::unordered_map<RuleType, double> getWeights() const;
-    std::vector<double> exportWeightVector() const;
+    std::unordered_map<RuleType, double> getWeights() const;        ///< Compatibility copy; prefer weights()
+    const RuleArray& weights() const { return weight; }             ///< Weights by rule id (zero-copy)
+    const RuleArray& counters() const { return counter; }           ///< Evidence counters by rule id (zero-copy)
+    const RuleArray& thresholds() const { return threshold; }       ///< Thresholds by rule id (zero-copy)
+    const RuleArray& evidenceTotals() const { return evidence; }    ///< Net evidence ever observed per rule (never reset)
+    const RuleArray& updateCounts() const { return updates; }       ///< Threshold crossings ever applied per rule
+    unsigned activeRules() const { return activeMask; }             ///< Bit (1 << rule) set for every rule in use
+    bool hasRule(RuleType rule) const { return (activeMask >> rule) & 1u; }
+    double getWeight(RuleType rule) const { return hasRule(rule) ? weight[rule] : 0.0; }
+    RuleStats getRuleStats(RuleType rule) const;
+    double getLearningRate() const { return learningRate; }
+    const TrainingStats& getTrainingStats() const { return trainingStats; }
+    std::vector<double> exportWeightVector() const;                 ///< Weights indexed by rule id (0 for unused rules)
+    std::vector<double> exportPlayerWeights() const;                ///< Adaptive weights laid out as RulEvolutionRules::evaluate() expects
+    void importPlayerWeights(const std::vector<double>& playerWeights); ///< Inverse of exportPlayerWeights() (values clamped to [0,1])
     void compareWeightVectors(const std::vector<double>& before,
         const std::vector<double>& after);
     void printLearningReport() const;
@@ -64,13 +124,29 @@ public:
     // --- Manual adjustments and data persistence ---
     bool setWeight(RuleType rule, double newWeight);                ///< Manually set a weight
     double getThreshold(RuleType rule) const;                       ///< Retrieve rule threshold
+    bool setThreshold(RuleType rule, double newThreshold);          ///< Change the threshold of a rule in use
+    bool setCounter(RuleType rule, double newCounter);              ///< Set the evidence counter of a rule in use
+    void addTotals(RuleType rule, double net, double crossings);    ///< Add to the evidence and crossing totals of a rule in use
+    void setLearningRate(double eta) { learningRate = eta; }        ///< Change the step applied at each crossing
     void normalizeWeights(double minW = 0.0, double maxW = 1.0);    ///< Keep weights within [min,max] and normalize sum to 1
 
 private:
-    double learningRate;  ///< Learning rate
-    std::unordered_map<RuleType, RuleStats> ruleData;   ///< Data for each rule
-    std::unordered_map<RuleType, double> initialWeights;///< Snapshot of initial weights
-    TrainingStats trainingStats;                        ///< Counters for training sessions
+    friend class Checkpoint;  // serializes the complete state
+
+    void activate(RuleType rule, double initialWeight, double ruleThreshold);
+    void advanceRule(int rule, long long occurrences, bool hasWon, bool strict);
+
+    double learningRate;          ///< Learning rate
+    RuleArray weight{};           ///< Current adaptive weight per rule
+    RuleArray counter{};          ///< Accumulated evidence per rule
+    RuleArray threshold{};        ///< Update threshold per rule
+    RuleArray initialWeight{};    ///< Snapshot of initial weights
+    RuleArray evidence{};         ///< Net +1/-1 evidence observed per rule
+    RuleArray updates{};          ///< Threshold crossings applied per rule
+    unsigned activeMask = 0;      ///< Rules in use (bit = 1 << RuleType)
+    unsigned initialMask = 0;     ///< Rules present in the initial snapshot
+    TrainingStats trainingStats;  ///< Counters for training sessions
+    bool verbose = true;          ///< Print the per-rule update trace
 };
 
 #endif // LEARNINGMODULE_H
\ No newline at end of file
@@ -4,15 +4,21 @@
 //  Description:
 //     Standard mode -> interactive play with any player types.
 //     Super-Training mode -> automatic parallel training between AIs.
+//     Batch mode -> headless job list (--batch / --job), JSON results.
 //     Execution time measured for performance comparison.
 // ============================================================================
 
+#include "Engine.h"
 #include "Game_TicTacToe.h"
 #include "LearningModule.h"
 #include "HumanPlayer_TicTacToe.h"
 #include "StochasticPlayer_TicTacToe.h"
 #include "RulEvolutionPlayer_TicTacToe.h"
 #include "WeightsIO.h"
+#include "SuperTraining.h"
+#include "ConvergenceMonitor.h"
+#include "BatchRunner.h"
+#include "Trace.h"
 
 #include <iostream>
 #include <cstdlib>
@@ -26,8 +32,6 @@
 #include <omp.h>
 #endif
 
-LearningModule learner(0.02);
-
 /**
  * @brief Convert a string to lowercase.
  */
@@ -39,9 +43,24 @@ auto normalize = [](std::string s) {
 
 /**
  * @brief Program entry point.
+ *        With command-line arguments the headless batch runner is used,
+ *        otherwise the interactive session starts.
  */
-int main() {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+int main(int argc, char* argv[]) {
+    EngineOptions options;
+    options.seed = static_cast<std::uint64_t>(std::time(nullptr));
+    Engine engine(options);
+
+    if (argc > 1)
+        return engine.runBatch(argc, argv);
+
+    Engine::Scope scope(engine);
+    LearningModule& learner = engine.learner();
+
+    // RULEV_TRACE=<file> records a timeline of the session (batch mode: --trace).
+    const char* tracePath = std::getenv("RULEV_TRACE");
+    if (tracePath && *tracePath) Trace::start(tracePath);
+
     std::cout << "=== RulEvolution TicTacToe ===\n";
 
 #ifdef USE_OMP
@@ -66,11 +85,7 @@ int main() {
             std::cout << "[WARN] No previous weights found. Using defaults.\n";
     }
     else {
-        learner.setRuleParameters(RULE_BLOCK, 0.278, 5.0);
-        learner.setRuleParameters(RULE_PREPARATION, 0.222, 5.0);
-        learner.setRuleParameters(RULE_CENTER, 0.222, 5.0);
-        learner.setRuleParameters(RULE_CORNER, 0.167, 5.0);
-        learner.setRuleParameters(RULE_SIDE, 0.111, 5.0);
+        learner.setDefaultParameters();
     }
 
     learner.recordInitialWeights();
@@ -96,87 +111,36 @@ int main() {
         std::cin >> scenario;
 
         int numMatches;
-        std::cout << "Number of training matches: ";
+        std::cout << "Number of training matches (0 = until converged): ";
         std::cin >> numMatches;
 
-        Player* pX = nullptr;
-        Player* pO = nullptr;
+        std::cout << "\n[MODE] Super-Training Parallel Batch Activated.\n";
 
-        if (scenario == 1) {
-            pX = new StochasticPlayer('X');
-            pO = new RulEvolutionPlayer('O');
+        double elapsed = 0.0;
+        if (numMatches > 0) {
+            SuperTrainingResult result = SuperTraining::run(learner, scenario, numMatches);
+            elapsed = result.elapsedSeconds;
         }
         else {
-            pX = new RulEvolutionPlayer('X');
-            pO = new RulEvolutionPlayer('O');
-        }
-
-        std::cout << "\n[MODE] Super-Training Parallel Batch Activated.\n";
-
-#ifdef USE_OMP
-        double startTime = omp_get_wtime();
-#else
-        auto startTime = std::clock();
-#endif
-
-        std::vector<LearningModule> learners(numMatches, learner);
-
-#ifdef USE_OMP
-#pragma omp parallel for
-#endif
-        for (int i = 0; i < numMatches; ++i) {
-            Game g(pX, pO);
-            GameHistory history;
-            char winner = g.playAndLearn(history, false);
-            bool rulevWon = (winner == 'X' || winner == 'O');
-            learners[i].updateFromGame(history, rulevWon);
-
-            int tid = 0;
-#ifdef USE_OMP
-            tid = omp_get_thread_num();
-#endif
-#pragma omp critical
-            {
-                std::cout << "[Thread " << tid << "] Match " << (i + 1)
-                    << " finished. Winner: "
-                    << (winner == ' ' ? "Draw" : std::string(1, winner))
-                    << "\n";
+            // Rounds of a fixed size until the convergence monitor is satisfied.
+            const long long maxMatches = 10000000;
+            ConvergenceMonitor monitor;
+            int round = monitor.settings().roundMatches;
+            long long played = 0;
+            bool converged = false;
+            while (!converged && played < maxMatches) {
+                RuleArray before = learner.weights();
+                SuperTrainingResult result = SuperTraining::run(learner, scenario, round, false);
+                elapsed += result.elapsedSeconds;
+                played += result.matches;
+                converged = monitor.observe(before, learner, result, scenario);
             }
+            std::cout << (converged ? "[INFO] Converged after " : "[WARN] Not converged after ")
+                << played << " matches.\n";
         }
 
-        // === MERGE STEP ===
-        std::unordered_map<RuleType, double> globalWeights = learner.getWeights();
-
-        for (size_t i = 0; i < learners.size(); ++i) {
-            std::unordered_map<RuleType, double> localWeights = learners[i].getWeights();
-            for (auto it = localWeights.begin(); it != localWeights.end(); ++it)
-                globalWeights[it->first] += it->second;
-        }
-
-        for (auto it = globalWeights.begin(); it != globalWeights.end(); ++it) {
-            RuleType rule = it->first;
-            double averaged = it->second / learners.size();
-            learner.setWeight(rule, averaged);
-        }
-
-        // === UPDATE TRAINING STATS ===
-        for (int i = 0; i < numMatches; ++i) {
-            if (scenario == 1)
-                learner.incrementTrainingCount("StochasticVsRulev");
-            else
-                learner.incrementTrainingCount("RulevVsRulev");
-        }
-
-#ifdef USE_OMP
-        double elapsed = omp_get_wtime() - startTime;
-#else
-        double elapsed = double(std::clock() - startTime) / CLOCKS_PER_SEC;
-#endif
         std::cout << "\n[TIME] Super-Training elapsed: " << elapsed << " s\n";
         std::cout << "[INFO] Super-Training merge complete.\n";
-
-        delete pX;
-        delete pO;
     }
 
     // =====================================================
@@ -217,7 +181,7 @@ int main() {
 
         for (int i = 1; i <= numMatches; ++i) {
             std::cout << "\n--- Match " << i << " ---\n";
-            Game g(pX, pO);
+            Game g(pX, pO, &learner);
             GameHistory history;
             char winner = g.playAndLearn(history, true);
 
@@ -227,11 +191,11 @@ int main() {
                 std::cout << "Winner: " << winner << "\n";
 
             if (dynamic_cast<RulEvolutionPlayer*>(pX) && dynamic_cast<RulEvolutionPlayer*>(pO))
-                learner.incrementTrainingCount("RulevVsRulev");
+                learner.incrementTrainingCount(TRAIN_RULEV_VS_RULEV);
             else if (dynamic_cast<HumanPlayer*>(pX) || dynamic_cast<HumanPlayer*>(pO))
-                learner.incrementTrainingCount("HumanVsRulev");
+                learner.incrementTrainingCount(TRAIN_HUMAN_VS_RULEV);
             else
-                learner.incrementTrainingCount("StochasticVsRulev");
+                learner.incrementTrainingCount(TRAIN_STOCHASTIC_VS_RULEV);
 
             learner.printLearningReport();
         }
@@ -253,8 +217,12 @@ int main() {
     std::cout << "\n=== End of RulEvolution Session ===\n";
     learner.printLearningReport();
 
-    WeightsIO::save(learner, "weights_data.txt");
-    std::cout << "[INFO] Weights saved to weights_data.txt\n";
+    if (WeightsIO::save(learner, "weights_data.txt"))
+        std::cout << "[INFO] Weights saved to weights_data.txt\n";
+    else
+        std::cerr << "[ERROR] Cannot write weights_data.txt\n";
 
+    if (tracePath && *tracePath && Trace::stop())
+        std::cout << "[INFO] Trace written to " << tracePath << "\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) { CloseHandle(f); return false; }
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+    fileHandle = f;
+    mapHandle = m;
+    base = static_cast<const unsigned char*>(p);
+    length = static_cast<std::size_t>(sz.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const unsigned char*>(p);
+    length = static_cast<std::size_t>(st.st_size);
+#endif
+    return true;
+}
+
+bool MappedFile::openShared(const std::string& filename, std::size_t size) {
+    close();
+    if (size == 0) return false;
+#ifdef _WIN32
+    HANDLE f = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz)) { CloseHandle(f); return false; }
+    std::size_t mapped = (std::max)(size, static_cast<std::size_t>(sz.QuadPart));
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<unsigned long long>(mapped) >> 32), static_cast<DWORD>(mapped), nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    void* p = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+    fileHandle = f;
+    mapHandle = m;
+    base = static_cast<const unsigned char*>(p);
+    length = mapped;
+#else
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+    std::size_t mapped = (std::max)(size, static_cast<std::size_t>(st.st_size));
+    if (static_cast<std::size_t>(st.st_size) < size && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const unsigned char*>(p);
+    length = mapped;
+#endif
+    writable = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mapHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    fileHandle = mapHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(base), length);
+#endif
+    base = nullptr;
+    length = 0;
+    writable = false;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept {
+    std::swap(base, other.base);
+    std::swap(length, other.length);
+    std::swap(writable, other.writable);
+#ifdef _WIN32
+    std::swap(fileHandle, other.fileHandle);
+    std::swap(mapHandle, other.mapHandle);
+#endif
+}
@@ -0,0 +1,60 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Memory mapping of a whole file (POSIX mmap / Win32 views), read-only
+ *        or shared read-write between processes.
+ *
+ * Move-only; the mapping is released by the destructor.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) { close(); swap(other); }
+        return *this;
+    }
+
+    /**
+     * @brief Map a file read-only.
+     * @return false if the file cannot be opened or is empty.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Map a file read-write, shared with every process mapping it.
+     *        The file is created if missing and grown (zero-filled) to `size`.
+     * @return false if the file cannot be created, resized or mapped.
+     */
+    bool openShared(const std::string& filename, std::size_t size);
+
+    /// Release the mapping (no-op if nothing is mapped).
+    void close();
+
+    const unsigned char* data() const { return base; }
+    unsigned char* mutableData() { return writable ? const_cast<unsigned char*>(base) : nullptr; }  ///< nullptr unless openShared()
+    std::size_t size() const { return length; }
+    bool isOpen() const { return base != nullptr; }
+
+private:
+    void swap(MappedFile& other) noexcept;
+
+    const unsigned char* base = nullptr;  ///< Start of the mapping
+    std::size_t length = 0;               ///< Mapped size in bytes
+    bool writable = false;                ///< Mapped by openShared()
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,72 @@
+// ================================================================
+//  MatchArena.cpp — Per-worker monotonic arena for match scratch state
+//  Notes:
+//    - the binding is thread-local, like the RandomSource binding, so
+//      library code picks up a worker's arena without new parameters;
+//    - overflow blocks are only released at reset(), never in between.
+// ================================================================
+#include "MatchArena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const std::size_t CACHE_LINE = 64;
+
+thread_local MatchArena* boundArena = nullptr;
+
+std::size_t alignUp(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+MatchArena::MatchArena(std::size_t capacity) {
+    grow((std::max)(capacity, CACHE_LINE));
+}
+
+void MatchArena::grow(std::size_t capacity) {
+    capacity = alignUp(capacity, CACHE_LINE);
+    storage.reset(new unsigned char[capacity + CACHE_LINE]);
+    std::uintptr_t p = reinterpret_cast<std::uintptr_t>(storage.get());
+    base = storage.get() + (alignUp(p, CACHE_LINE) - p);
+    size = capacity;
+    offset = 0;
+}
+
+void* MatchArena::allocate(std::size_t bytes, std::size_t alignment) {
+    if (bytes == 0) bytes = 1;
+    std::size_t start = alignUp(offset, alignment);
+    if (start + bytes <= size) {
+        offset = start + bytes;
+        return base + start;
+    }
+    // Does not fit: a private block until reset(), which then grows the main one.
+    ++overflowCount;
+    overflow.emplace_back(new unsigned char[bytes + CACHE_LINE]);
+    overflowBytes += bytes;
+    std::uintptr_t p = reinterpret_cast<std::uintptr_t>(overflow.back().get());
+    return overflow.back().get() + (alignUp(p, CACHE_LINE) - p);
+}
+
+void MatchArena::reset() {
+    peak = (std::max)(peak, used());
+    if (!overflow.empty()) {
+        overflow.clear();
+        overflowBytes = 0;
+        grow((std::max)(peak + peak / 2, size * 2));
+    }
+    offset = 0;
+}
+
+MatchArena* MatchArena::current() {
+    return boundArena;
+}
+
+ArenaBinding::ArenaBinding(MatchArena& arena) : previous(boundArena) {
+    boundArena = &arena;
+}
+
+ArenaBinding::~ArenaBinding() {
+    boundArena = previous;
+}
@@ -0,0 +1,108 @@
+#ifndef MATCHARENA_H
+#define MATCHARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * @class MatchArena
+ * @brief Per-worker monotonic arena for the scratch state of one match.
+ *
+ * allocate() bumps a pointer in one cache-line aligned block and
+ * deallocation is a no-op; reset() after every match makes the whole block
+ * reusable at once. A request that does not fit is served by an overflow
+ * block kept until the next reset(), which then grows the main block to
+ * the high-water mark: after the first few matches a worker allocates
+ * nothing from the heap and its footprint stays fixed.
+ *
+ * Not thread-safe: each worker owns one and binds it with ArenaBinding.
+ */
+class MatchArena {
+public:
+    static const std::size_t DEFAULT_CAPACITY = 8192;  ///< Bytes (a RulEvolution vs RulEvolution match peaks near 8 KiB)
+
+    explicit MatchArena(std::size_t capacity = DEFAULT_CAPACITY);
+    MatchArena(const MatchArena&) = delete;
+    MatchArena& operator=(const MatchArena&) = delete;
+
+    /// Aligned storage valid until the next reset() (alignment at most 64).
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /// Release everything allocated since the last reset().
+    void reset();
+
+    std::size_t capacity() const { return size; }      ///< Bytes of the main block
+    std::size_t used() const { return offset + overflowBytes; }  ///< Bytes allocated since reset()
+    std::size_t highWater() const { return peak; }     ///< Largest used() seen at a reset()
+    long long overflows() const { return overflowCount; }  ///< Requests served outside the main block
+
+    /// Arena bound to the calling thread (nullptr = plain heap).
+    static MatchArena* current();
+
+private:
+    void grow(std::size_t capacity);
+
+    std::unique_ptr<unsigned char[]> storage;  ///< Main block (+ alignment slack)
+    unsigned char* base = nullptr;             ///< Cache-line aligned start of the main block
+    std::size_t size = 0;
+    std::size_t offset = 0;
+    std::vector<std::unique_ptr<unsigned char[]>> overflow;
+    std::size_t overflowBytes = 0;
+    std::size_t peak = 0;
+    long long overflowCount = 0;
+};
+
+/**
+ * @class ArenaBinding
+ * @brief Makes an arena the calling thread's MatchArena::current() for its
+ *        lifetime (RAII, restores the previous binding).
+ */
+class ArenaBinding {
+public:
+    explicit ArenaBinding(MatchArena& arena);
+    ~ArenaBinding();
+    ArenaBinding(const ArenaBinding&) = delete;
+    ArenaBinding& operator=(const ArenaBinding&) = delete;
+
+private:
+    MatchArena* previous;
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Standard allocator drawing from a MatchArena, by default the one
+ *        bound to the constructing thread; without an arena it uses the heap.
+ *
+ * Containers using it must not outlive the arena's next reset().
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator() noexcept : arena(MatchArena::current()) {}
+    explicit ArenaAllocator(MatchArena* a) noexcept : arena(a) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        if (!arena) ::operator delete(p);
+    }
+
+    MatchArena* arena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena == b.arena; }
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena != b.arena; }
+
+#endif // MATCHARENA_H
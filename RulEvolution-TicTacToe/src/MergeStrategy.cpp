@@ -0,0 +1,275 @@
+// ================================================================
+//  MergeStrategy.cpp — Super-Training merge strategies
+//  Notes:
+//    - one reduction per rule, always over the workers in index order,
+//      so results are identical for any thread count;
+//    - the rule loop only goes parallel for large worker counts, below
+//      that an OpenMP region costs more than the reduction itself;
+//    - counters are reduced like the weights, evidence and crossing
+//      totals are summed over the workers' deltas.
+// ================================================================
+#include "MergeStrategy.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int PARALLEL_MIN_WORKERS = 256;
+
+/// Per-rule array of a learner (weights, counters, ...).
+typedef const RuleArray& (LearningModule::*RuleField)() const;
+
+/// Rules in use by the global learner or by any worker.
+unsigned usedRules(const LearningModule& global, const std::vector<LearningModule>& workers) {
+    unsigned used = global.activeRules();
+    for (const LearningModule& w : workers) used |= w.activeRules();
+    return used;
+}
+
+/// Reduce the weight and the counter of every used rule with
+/// fn(r, current, field) -> merged value, sum the totals, then store and renormalize.
+template <class ReduceRule>
+void mergeRules(LearningModule& global, const std::vector<LearningModule>& workers, ReduceRule fn) {
+    unsigned used = usedRules(global, workers);
+    const RuleArray baseEvidence = global.evidenceTotals();
+    const RuleArray baseUpdates = global.updateCounts();
+    RuleArray weights = global.weights();
+    RuleArray counters = global.counters();
+    RuleArray net{}, crossings{};
+
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (workers.size() >= PARALLEL_MIN_WORKERS)
+#endif
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!(used & (1u << r))) continue;
+        weights[r] = fn(r, weights[r], &LearningModule::weights);
+        counters[r] = fn(r, counters[r], &LearningModule::counters);
+        for (const LearningModule& w : workers) {
+            if (!(w.activeRules() & (1u << r))) continue;
+            net[r] += w.evidenceTotals()[r] - baseEvidence[r];
+            crossings[r] += w.updateCounts()[r] - baseUpdates[r];
+        }
+    }
+
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!(used & (1u << r))) continue;
+        RuleType rule = static_cast<RuleType>(r);
+        global.setWeight(rule, weights[r]);
+        global.setCounter(rule, counters[r]);
+        global.addTotals(rule, net[r], crossings[r]);
+    }
+    global.normalizeWeights();
+}
+
+/// A threshold crossing found by the replay merge.
+struct Crossing {
+    int worker;
+    long long step;  ///< Replay step of the worker (1-based)
+    int rule;
+    int direction;   ///< +1 up, -1 down
+};
+
+bool replayOrder(const Crossing& a, const Crossing& b) {
+    if (a.worker != b.worker) return a.worker < b.worker;
+    if (a.step != b.step) return a.step < b.step;
+    return a.rule < b.rule;
+}
+
+/**
+ * @brief Crossings of `total` same-sign occurrences of one rule replayed
+ *        over `steps` steps (occurrence j at step ceil(j * steps / total)),
+ *        with the counter logic of LearningModule::advanceRule(). Leaves
+ *        the counter where the occurrences take it.
+ */
+void ruleCrossings(int worker, int rule, long long total, long long steps, double sign, double T,
+    double& c, std::vector<Crossing>& out) {
+    auto stepOf = [&](long long j) { return (j * steps + total - 1) / total; };
+    // One occurrence, exactly as LearningModule::updateFromGame().
+    auto stepOnce = [&](long long j) {
+        c += sign;
+        if (c >= T) { out.push_back({ worker, stepOf(j), rule, 1 }); c = 0.0; }
+        else if (c <= -T) { out.push_back({ worker, stepOf(j), rule, -1 }); c = 0.0; }
+    };
+
+    if (!(T > 0.0) || T > 1e9) {
+        for (long long j = 1; j <= total; ++j) stepOnce(j);
+        return;
+    }
+
+    // A counter at or past a lowered threshold crosses on its next occurrence.
+    long long j = 0;
+    while (j < total && std::fabs(c) >= T) stepOnce(++j);
+    long long n = total - j;
+    if (n == 0) return;
+
+    long long first = std::max(1LL, static_cast<long long>(std::ceil(T - sign * c)));
+    if (n < first) {
+        c += sign * n;
+        return;
+    }
+    long long period = std::max(1LL, static_cast<long long>(std::ceil(T)));
+    long long count = 1 + (n - first) / period;
+    long long leftover = (n - first) % period;
+    for (long long k = 0; k < count; ++k)
+        out.push_back({ worker, stepOf(j + first + k * period), rule, sign > 0 ? 1 : -1 });
+    c = leftover ? sign * leftover : 0.0;
+}
+
+const MeanMerge meanMerge;
+const UpdateWeightedMerge weightedMerge;
+const CounterReplayMerge replayMerge;
+const TrimmedMeanMerge medianMerge(0.5);
+const TrimmedMeanMerge trimmedMerge(0.2);
+
+} // namespace
+
+// --- Registry ---------------------------------------------------------------
+
+const MergeStrategy* MergeStrategy::byName(const std::string& name) {
+    if (name == "mean")     return &meanMerge;
+    if (name == "weighted") return &weightedMerge;
+    if (name == "replay")   return &replayMerge;
+    if (name == "median")   return &medianMerge;
+    if (name == "trimmed")  return &trimmedMerge;
+    return nullptr;
+}
+
+const MergeStrategy& MergeStrategy::defaultStrategy() {
+    return meanMerge;
+}
+
+std::string MergeStrategy::names() {
+    return "mean, weighted, replay, median, trimmed";
+}
+
+void MergeStrategy::merge(LearningModule& global, const std::vector<LearningModule>& workers) const {
+    if (workers.empty()) return;
+    if (workers.size() == 1) {
+        global = workers.front();  // what the worker learned is exactly a sequential run
+        return;
+    }
+    reduce(global, workers);
+}
+
+// --- Strategies ---------------------------------------------------------------
+
+void MeanMerge::reduce(LearningModule& global, const std::vector<LearningModule>& workers) const {
+    mergeRules(global, workers, [&](int r, double current, RuleField field) {
+        double sum = 0.0;
+        int n = 0;
+        for (const LearningModule& w : workers) {
+            if (!(w.activeRules() & (1u << r))) continue;
+            sum += (w.*field)()[r];
+            ++n;
+        }
+        return n > 0 ? sum / n : current;
+    });
+}
+
+void UpdateWeightedMerge::reduce(LearningModule& global, const std::vector<LearningModule>& workers) const {
+    const RuleArray base = global.updateCounts();
+    mergeRules(global, workers, [&](int r, double current, RuleField field) {
+        double sum = 0.0, weightSum = 0.0, plain = 0.0;
+        int n = 0;
+        for (const LearningModule& w : workers) {
+            if (!(w.activeRules() & (1u << r))) continue;
+            double applied = w.updateCounts()[r] - base[r];
+            double value = (w.*field)()[r];
+            sum += applied * value;
+            weightSum += applied;
+            plain += value;
+            ++n;
+        }
+        if (weightSum > 0.0) return sum / weightSum;
+        return n > 0 ? plain / n : current;
+    });
+}
+
+void CounterReplayMerge::reduce(LearningModule& global, const std::vector<LearningModule>& workers) const {
+    const RuleArray base = global.evidenceTotals();
+    const int count = static_cast<int>(workers.size());
+
+    // Net evidence per worker and rule; the rule with the most sets the
+    // length of the worker's replay.
+    std::vector<long long> net(workers.size() * RULE_COUNT, 0);
+    std::vector<long long> steps(workers.size(), 0);
+    for (int k = 0; k < count; ++k) {
+        for (int r = 0; r < RULE_COUNT; ++r) {
+            if (!(workers[k].activeRules() & (1u << r))) continue;
+            long long n = static_cast<long long>(workers[k].evidenceTotals()[r] - base[r]);
+            net[k * RULE_COUNT + r] = n;
+            steps[k] = std::max(steps[k], n < 0 ? -n : n);
+            if (n != 0 && !global.hasRule(static_cast<RuleType>(r)))
+                global.setWeight(static_cast<RuleType>(r), 0.5);  // same defaults as applyEvidence()
+        }
+    }
+
+    // Counters only depend on their own rule: every rule runs through all
+    // workers on its own and records where it crosses.
+    RuleArray counters = global.counters();
+    std::vector<Crossing> found[RULE_COUNT];
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (workers.size() >= PARALLEL_MIN_WORKERS)
+#endif
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!global.hasRule(static_cast<RuleType>(r))) continue;
+        const double T = global.thresholds()[r];
+        for (int k = 0; k < count; ++k) {
+            long long n = net[k * RULE_COUNT + r];
+            if (n != 0)
+                ruleCrossings(k, r, n < 0 ? -n : n, steps[k], n < 0 ? -1.0 : 1.0, T, counters[r], found[r]);
+        }
+    }
+
+    // Apply the crossings in replay order, renormalizing after each one.
+    // Every rule's list is already in order, so the lists are merged.
+    const double eta = global.getLearningRate();
+    RuleArray applied{};
+    std::size_t next[RULE_COUNT] = {};
+    unsigned long long up = 0, down = 0;
+    for (;;) {
+        const Crossing* x = nullptr;
+        for (int r = 0; r < RULE_COUNT; ++r)
+            if (next[r] < found[r].size() && (!x || replayOrder(found[r][next[r]], *x))) x = &found[r][next[r]];
+        if (!x) break;
+        ++next[x->rule];
+        RuleType rule = static_cast<RuleType>(x->rule);
+        global.setWeight(rule, global.weights()[x->rule] + x->direction * eta);
+        global.normalizeWeights();
+        applied[x->rule] += 1.0;
+        (x->direction > 0 ? up : down) += 1;
+    }
+    Metrics::add(METRIC_THRESHOLD_UP, up);
+    Metrics::add(METRIC_THRESHOLD_DOWN, down);
+
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        RuleType rule = static_cast<RuleType>(r);
+        if (!global.hasRule(rule)) continue;
+        double total = 0.0;
+        for (int k = 0; k < count; ++k) total += static_cast<double>(net[k * RULE_COUNT + r]);
+        global.setCounter(rule, counters[r]);
+        global.addTotals(rule, total, applied[r]);
+    }
+    global.normalizeWeights();
+}
+
+void TrimmedMeanMerge::reduce(LearningModule& global, const std::vector<LearningModule>& workers) const {
+    mergeRules(global, workers, [&](int r, double current, RuleField field) {
+        std::vector<double> values;
+        values.reserve(workers.size());
+        for (const LearningModule& w : workers)
+            if (w.activeRules() & (1u << r)) values.push_back((w.*field)()[r]);
+        if (values.empty()) return current;
+        std::sort(values.begin(), values.end());
+
+        size_t n = values.size();
+        if (trim >= 0.5)
+            return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+
+        size_t cut = static_cast<size_t>(trim * n);
+        double sum = 0.0;
+        for (size_t i = cut; i < n - cut; ++i) sum += values[i];
+        return sum / (n - 2 * cut);
+    });
+}
@@ -0,0 +1,119 @@
+#ifndef MERGESTRATEGY_H
+#define MERGESTRATEGY_H
+
+#include "LearningModule.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class MergeStrategy
+ * @brief Folds the worker learners of a Super-Training batch back into the
+ *        global learner.
+ *
+ * Every worker starts as a copy of the global learner, so a strategy can
+ * read what each worker changed from the difference to the global state.
+ * The whole learning state is merged, not only the weights: counters carry
+ * the workers' unfinished evidence into the next batch, and the evidence
+ * and crossing totals keep counting. A single worker is adopted as is, so
+ * a one-worker run learns the same weights however it is split into
+ * batches (rounds, checkpoints, publishes).
+ *
+ * Rules are reduced independently, each one over the workers in worker
+ * order: the result does not depend on how many threads run the reduction.
+ * Cost is O(workers x rules), independent of the number of matches,
+ * except for CounterReplayMerge (see there).
+ */
+class MergeStrategy {
+public:
+    virtual ~MergeStrategy() = default;
+
+    /// Name used on the command line / in job files.
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Merge the workers into the global learner and renormalize it.
+     * @param global Learner the workers were copied from; receives the result.
+     * @param workers Worker learners after their matches, in worker order.
+     */
+    void merge(LearningModule& global, const std::vector<LearningModule>& workers) const;
+
+    /// Built-in strategy by name ("mean", "weighted", "replay", "median", "trimmed"), nullptr if unknown.
+    static const MergeStrategy* byName(const std::string& name);
+    /// Strategy used when none is given (plain mean).
+    static const MergeStrategy& defaultStrategy();
+    /// Comma-separated list of the built-in names, for messages.
+    static std::string names();
+
+protected:
+    /// Merge two or more workers (see merge()).
+    virtual void reduce(LearningModule& global, const std::vector<LearningModule>& workers) const = 0;
+};
+
+/**
+ * @class MeanMerge
+ * @brief Arithmetic mean of the worker weights and counters.
+ */
+class MeanMerge : public MergeStrategy {
+public:
+    const char* name() const override { return "mean"; }
+
+protected:
+    void reduce(LearningModule& global, const std::vector<LearningModule>& workers) const override;
+};
+
+/**
+ * @class UpdateWeightedMerge
+ * @brief Mean of the worker weights and counters, each worker weighted per
+ *        rule by the number of threshold updates it applied. Rules no
+ *        worker updated fall back to the plain mean.
+ */
+class UpdateWeightedMerge : public MergeStrategy {
+public:
+    const char* name() const override { return "weighted"; }
+
+protected:
+    void reduce(LearningModule& global, const std::vector<LearningModule>& workers) const override;
+};
+
+/**
+ * @class CounterReplayMerge
+ * @brief Replays the net evidence every worker observed per rule through
+ *        the global learner's counters and thresholds, so that evidence
+ *        split across workers still reaches the threshold.
+ *
+ * Workers are replayed in worker order, each rule's occurrences spread
+ * evenly over the worker's replay with the rules interleaved, and the
+ * weights are renormalized after every threshold crossing, as in
+ * sequential learning. A counter only depends on its own rule, so each
+ * rule's crossings are found in closed form, in parallel; only the
+ * crossings are then applied in order, each with a renormalization.
+ * Cost is O(workers x rules + crossings); the crossings grow with the net
+ * evidence, so unlike the other strategies this one costs O(matches).
+ */
+class CounterReplayMerge : public MergeStrategy {
+public:
+    const char* name() const override { return "replay"; }
+
+protected:
+    void reduce(LearningModule& global, const std::vector<LearningModule>& workers) const override;
+};
+
+/**
+ * @class TrimmedMeanMerge
+ * @brief Per-rule trimmed mean of the worker weights and counters: the
+ *        lowest and the highest `trim` fraction are dropped. trim >= 0.5
+ *        gives the median.
+ */
+class TrimmedMeanMerge : public MergeStrategy {
+public:
+    explicit TrimmedMeanMerge(double trim) : trim(trim) {}
+    const char* name() const override { return trim >= 0.5 ? "median" : "trimmed"; }
+
+protected:
+    void reduce(LearningModule& global, const std::vector<LearningModule>& workers) const override;
+
+private:
+    double trim;  ///< Fraction dropped at each end
+};
+
+#endif // MERGESTRATEGY_H
@@ -0,0 +1,205 @@
+// ================================================================
+//  Metrics.cpp — Thread-local hot-path metrics and exporters
+//  Notes:
+//    - a thread registers one shard per registry it records into; shards
+//      are freed with their registry, so a snapshot can read them while
+//      worker threads keep writing;
+//    - the registry mutex is taken only at registration and snapshot
+//      time, never on the recording path;
+//    - registry ids start at 1, so a thread's empty shard cache (id 0)
+//      never matches.
+// ================================================================
+#include "Metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+    std::atomic<std::uint64_t> nextRegistryId{ 1 };
+
+    const char* counterName(int c) {
+        switch (c) {
+        case METRIC_MATCHES:          return "rulev_matches_total";
+        case METRIC_WINS_X:           return "rulev_wins_x_total";
+        case METRIC_WINS_O:           return "rulev_wins_o_total";
+        case METRIC_DRAWS:            return "rulev_draws_total";
+        case METRIC_INVALID_MOVES:    return "rulev_invalid_moves_total";
+        case METRIC_MOVES:            return "rulev_moves_total";
+        case METRIC_RULE_EVALUATIONS: return "rulev_rule_evaluations_total";
+        case METRIC_LEARNING_UPDATES: return "rulev_learning_updates_total";
+        case METRIC_THRESHOLD_UP:     return "rulev_threshold_crossings_up_total";
+        case METRIC_THRESHOLD_DOWN:   return "rulev_threshold_crossings_down_total";
+        case METRIC_MERGES:           return "rulev_merges_total";
+        default:                      return "rulev_unknown_total";
+        }
+    }
+
+    const char* phaseName(int p) {
+        switch (p) {
+        case PHASE_SELECTION: return "selection";
+        case PHASE_LEARNING:  return "learning";
+        case PHASE_MERGE:     return "merge";
+        default:              return "unknown";
+        }
+    }
+
+} // namespace
+
+MetricsShard::MetricsShard() {
+    for (auto& a : counters) a.store(0, std::memory_order_relaxed);
+    for (auto& a : rulesFired) a.store(0, std::memory_order_relaxed);
+    for (auto& a : movesPerMatch) a.store(0, std::memory_order_relaxed);
+    for (auto& row : phaseBuckets)
+        for (auto& a : row) a.store(0, std::memory_order_relaxed);
+    for (auto& a : phaseCount) a.store(0, std::memory_order_relaxed);
+    for (auto& a : phaseNanos) a.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry Metrics::defaultRegistry;
+
+// --- Registry -----------------------------------------------------------------
+
+MetricsRegistry::MetricsRegistry() : identity(nextRegistryId.fetch_add(1)) {}
+
+MetricsShard& MetricsRegistry::threadShard() {
+    std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(mtx);
+    for (std::size_t i = 0; i < owners.size(); ++i)
+        if (owners[i] == self) return *shards[i];
+    shards.push_back(std::unique_ptr<MetricsShard>(new MetricsShard()));
+    owners.push_back(self);
+    return *shards.back();
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    MetricsSnapshot snap;
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& s : shards) {
+        for (int i = 0; i < METRIC_COUNTER_COUNT; ++i)
+            snap.counters[i] += s->counters[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < METRIC_RULE_COUNT; ++i)
+            snap.rulesFired[i] += s->rulesFired[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < METRIC_MOVES_BUCKETS; ++i)
+            snap.movesPerMatch[i] += s->movesPerMatch[i].load(std::memory_order_relaxed);
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            for (int b = 0; b < METRIC_LATENCY_BUCKETS; ++b)
+                snap.phaseBuckets[p][b] += s->phaseBuckets[p][b].load(std::memory_order_relaxed);
+            snap.phaseCount[p] += s->phaseCount[p].load(std::memory_order_relaxed);
+            snap.phaseNanos[p] += s->phaseNanos[p].load(std::memory_order_relaxed);
+        }
+    }
+    return snap;
+}
+
+void Metrics::writePrometheus(std::ostream& out, const MetricsSnapshot& snap) {
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        out << "# TYPE " << counterName(i) << " counter\n"
+            << counterName(i) << " " << snap.counters[i] << "\n";
+    }
+
+    out << "# TYPE rulev_rules_fired_total counter\n";
+    for (int r = 0; r < METRIC_RULE_COUNT; ++r)
+        out << "rulev_rules_fired_total{rule=\"" << ruleToString(static_cast<RuleType>(r))
+            << "\"} " << snap.rulesFired[r] << "\n";
+
+    unsigned long long cumulative = 0, movesSum = 0;
+    out << "# TYPE rulev_moves_per_match histogram\n";
+    for (int m = 0; m < METRIC_MOVES_BUCKETS; ++m) {
+        cumulative += snap.movesPerMatch[m];
+        movesSum += snap.movesPerMatch[m] * static_cast<unsigned long long>(m);
+        out << "rulev_moves_per_match_bucket{le=\"" << m << "\"} " << cumulative << "\n";
+    }
+    out << "rulev_moves_per_match_bucket{le=\"+Inf\"} " << cumulative << "\n"
+        << "rulev_moves_per_match_sum " << movesSum << "\n"
+        << "rulev_moves_per_match_count " << cumulative << "\n";
+
+    out << "# TYPE rulev_phase_seconds histogram\n";
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        cumulative = 0;
+        for (int b = 0; b < METRIC_LATENCY_BUCKETS; ++b) {
+            cumulative += snap.phaseBuckets[p][b];
+            out << "rulev_phase_seconds_bucket{phase=\"" << phaseName(p)
+                << "\",le=\"" << (bucketBound(b) * 1e-9) << "\"} " << cumulative << "\n";
+        }
+        out << "rulev_phase_seconds_bucket{phase=\"" << phaseName(p) << "\",le=\"+Inf\"} "
+            << snap.phaseCount[p] << "\n"
+            << "rulev_phase_seconds_sum{phase=\"" << phaseName(p) << "\"} "
+            << (snap.phaseNanos[p] * 1e-9) << "\n"
+            << "rulev_phase_seconds_count{phase=\"" << phaseName(p) << "\"} "
+            << snap.phaseCount[p] << "\n";
+    }
+}
+
+bool MetricsRegistry::writePrometheusFile(const std::string& filename) const {
+    std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out.good()) return false;
+        Metrics::writePrometheus(out, snapshot());
+        if (!out.good()) return false;
+    }
+    std::remove(filename.c_str());  // rename() does not overwrite on Windows
+    return std::rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+void Metrics::writeJson(std::ostream& out, const MetricsSnapshot& snap) {
+    std::ostringstream oss;
+    oss << "{\"metrics\":{";
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i)
+        oss << (i ? "," : "") << '"' << counterName(i) << "\":" << snap.counters[i];
+    oss << ",\"rules_fired\":[";
+    for (int r = 0; r < METRIC_RULE_COUNT; ++r)
+        oss << (r ? "," : "") << snap.rulesFired[r];
+    oss << "],\"moves_per_match\":[";
+    for (int m = 0; m < METRIC_MOVES_BUCKETS; ++m)
+        oss << (m ? "," : "") << snap.movesPerMatch[m];
+    oss << "],\"phase_seconds\":{";
+    for (int p = 0; p < PHASE_COUNT; ++p)
+        oss << (p ? "," : "") << '"' << phaseName(p) << "\":" << (snap.phaseNanos[p] * 1e-9);
+    oss << "}}}\n";
+    out << oss.str();
+}
+
+// --- Periodic exporter ------------------------------------------------------
+
+void MetricsExporter::start(const std::string& file, double intervalSeconds, bool stderrToo) {
+    stop();
+    filename = file;
+    interval = (intervalSeconds > 0.0) ? intervalSeconds : 10.0;
+    toStderr = stderrToo;
+    source = &Metrics::registry();
+    running = true;
+
+    worker = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (running) {
+            cv.wait_for(lock, std::chrono::duration<double>(interval), [this]() { return !running; });
+            if (!running) break;
+            lock.unlock();
+            exportOnce();
+            lock.lock();
+        }
+    });
+}
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+    exportOnce();
+}
+
+void MetricsExporter::exportOnce() {
+    if (!filename.empty() && !source->writePrometheusFile(filename))
+        std::cerr << "[WARN] Cannot write metrics to " << filename << "\n";
+    if (toStderr)
+        Metrics::writeJson(std::cerr, source->snapshot());
+}
@@ -0,0 +1,288 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "RuleType.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum MetricCounter
+ * @brief Event counters collected on the training hot path.
+ */
+enum MetricCounter {
+    METRIC_MATCHES = 0,        ///< Matches played (Game::play)
+    METRIC_WINS_X,             ///< Matches won by X
+    METRIC_WINS_O,             ///< Matches won by O
+    METRIC_DRAWS,              ///< Drawn matches
+    METRIC_INVALID_MOVES,      ///< Matches ended by an invalid move
+    METRIC_MOVES,              ///< Moves placed on the board
+    METRIC_RULE_EVALUATIONS,   ///< Calls to RulEvolutionRules::evaluate()
+    METRIC_LEARNING_UPDATES,   ///< Calls to LearningModule::updateFromGame()
+    METRIC_THRESHOLD_UP,       ///< Counter crossings of +threshold (weight increased)
+    METRIC_THRESHOLD_DOWN,     ///< Counter crossings of -threshold (weight decreased)
+    METRIC_MERGES,             ///< Super-Training merge steps
+    METRIC_COUNTER_COUNT
+};
+
+/**
+ * @enum MetricPhase
+ * @brief Timed phases of a training run.
+ */
+enum MetricPhase {
+    PHASE_SELECTION = 0,   ///< Match simulation (move selection by both players)
+    PHASE_LEARNING,        ///< LearningModule::updateFromGame()
+    PHASE_MERGE,           ///< Super-Training merge step
+    PHASE_COUNT
+};
+
+const int METRIC_RULE_COUNT = RULE_COUNT;  ///< RULE_WIN .. RULE_PREPARATION
+const int METRIC_MOVES_BUCKETS = 10;    ///< Moves per match: 0..9
+const int METRIC_LATENCY_BUCKETS = 32;  ///< Power-of-two ns buckets: <=1ns .. <=2^31ns
+
+/**
+ * @struct MetricsShard
+ * @brief Per-thread metric storage.
+ *
+ * Each thread writes only its own shard (relaxed load + store, no lock
+ * prefix); readers sum all shards. Cache-line aligned to avoid false sharing.
+ */
+struct alignas(64) MetricsShard {
+    std::atomic<unsigned long long> counters[METRIC_COUNTER_COUNT];
+    std::atomic<unsigned long long> rulesFired[METRIC_RULE_COUNT];
+    std::atomic<unsigned long long> movesPerMatch[METRIC_MOVES_BUCKETS];
+    std::atomic<unsigned long long> phaseBuckets[PHASE_COUNT][METRIC_LATENCY_BUCKETS];
+    std::atomic<unsigned long long> phaseCount[PHASE_COUNT];
+    std::atomic<unsigned long long> phaseNanos[PHASE_COUNT];
+
+    MetricsShard();
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Plain, merged copy of all shards at one point in time.
+ */
+struct MetricsSnapshot {
+    unsigned long long counters[METRIC_COUNTER_COUNT] = {};
+    unsigned long long rulesFired[METRIC_RULE_COUNT] = {};
+    unsigned long long movesPerMatch[METRIC_MOVES_BUCKETS] = {};
+    unsigned long long phaseBuckets[PHASE_COUNT][METRIC_LATENCY_BUCKETS] = {};
+    unsigned long long phaseCount[PHASE_COUNT] = {};
+    unsigned long long phaseNanos[PHASE_COUNT] = {};
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief One set of metrics: a shard per thread that recorded into it.
+ *
+ * Each Engine owns a registry and binds it to its threads; a thread with
+ * no registry bound records into the process default. Shards live as long
+ * as their registry, so a snapshot can read them while threads write.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /// Merge all thread shards (lock-free for the writers).
+    MetricsSnapshot snapshot() const;
+
+    /// Write the Prometheus text to a file (temp file + rename).
+    bool writePrometheusFile(const std::string& filename) const;
+
+    /// Distinguishes registries, even one created where another was freed.
+    std::uint64_t id() const { return identity; }
+
+    /// Shard of the calling thread, registered on its first use.
+    MetricsShard& threadShard();
+
+private:
+    const std::uint64_t identity;
+    mutable std::mutex mtx;  ///< Taken at registration and snapshot, never to record
+    std::vector<std::unique_ptr<MetricsShard>> shards;
+    std::vector<std::thread::id> owners;  ///< Thread of each shard
+};
+
+/**
+ * @class Metrics
+ * @brief Hot-path metrics, recorded into the registry bound to the calling
+ *        thread (MetricsBinding), or the process default.
+ *
+ * Define NO_METRICS to compile every recording call away.
+ */
+class Metrics {
+public:
+    static void add(MetricCounter counter, unsigned long long n = 1) {
+#ifndef NO_METRICS
+        bump(shard().counters[counter], n);
+#else
+        (void)counter; (void)n;
+#endif
+    }
+
+    static void ruleFired(RuleType rule) {
+#ifndef NO_METRICS
+        if (rule >= 0 && rule < METRIC_RULE_COUNT)
+            bump(shard().rulesFired[rule], 1);
+#else
+        (void)rule;
+#endif
+    }
+
+    static void movesPerMatch(int moves) {
+#ifndef NO_METRICS
+        if (moves < 0) moves = 0;
+        if (moves >= METRIC_MOVES_BUCKETS) moves = METRIC_MOVES_BUCKETS - 1;
+        bump(shard().movesPerMatch[moves], 1);
+#else
+        (void)moves;
+#endif
+    }
+
+    static void phaseTime(MetricPhase phase, unsigned long long nanos) {
+#ifndef NO_METRICS
+        MetricsShard& s = shard();
+        bump(s.phaseBuckets[phase][latencyBucket(nanos)], 1);
+        bump(s.phaseCount[phase], 1);
+        bump(s.phaseNanos[phase], nanos);
+#else
+        (void)phase; (void)nanos;
+#endif
+    }
+
+    /// Merge all thread shards of the bound registry (lock-free for the writers).
+    static MetricsSnapshot snapshot() { return registry().snapshot(); }
+
+    /// Prometheus text exposition format.
+    static void writePrometheus(std::ostream& out, const MetricsSnapshot& snap);
+
+    /// Write the bound registry's Prometheus text to a file (temp file + rename).
+    static bool writePrometheusFile(const std::string& filename) { return registry().writePrometheusFile(filename); }
+
+    /// Compact one-line JSON summary.
+    static void writeJson(std::ostream& out, const MetricsSnapshot& snap);
+
+    /// Upper bound (ns) of a latency bucket.
+    static unsigned long long bucketBound(int bucket) { return 1ULL << bucket; }
+
+    /// Registry bound to the calling thread (the process default if none).
+    static MetricsRegistry& registry() {
+        MetricsRegistry* bound = binding();
+        return bound ? *bound : defaultRegistry;
+    }
+
+private:
+    friend class MetricsBinding;
+
+    static void bump(std::atomic<unsigned long long>& a, unsigned long long n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static int latencyBucket(unsigned long long nanos) {
+        int b = 0;
+        while (b < METRIC_LATENCY_BUCKETS - 1 && (1ULL << b) < nanos) ++b;
+        return b;
+    }
+
+    /// The calling thread's shard, cached until the thread changes registry.
+    static MetricsShard& shard() {
+        static thread_local std::uint64_t cachedId = 0;
+        static thread_local MetricsShard* cached = nullptr;
+        MetricsRegistry& r = registry();
+        if (cachedId != r.id()) {
+            cached = &r.threadShard();
+            cachedId = r.id();
+        }
+        return *cached;
+    }
+
+    static MetricsRegistry*& binding() {
+        static thread_local MetricsRegistry* bound = nullptr;
+        return bound;
+    }
+
+    static MetricsRegistry defaultRegistry;
+};
+
+/**
+ * @class MetricsBinding
+ * @brief Scoped binding of a MetricsRegistry to the calling thread.
+ */
+class MetricsBinding {
+public:
+    explicit MetricsBinding(MetricsRegistry& registry) : previous(Metrics::binding()) { Metrics::binding() = &registry; }
+    ~MetricsBinding() { Metrics::binding() = previous; }
+    MetricsBinding(const MetricsBinding&) = delete;
+    MetricsBinding& operator=(const MetricsBinding&) = delete;
+
+private:
+    MetricsRegistry* previous;
+};
+
+/**
+ * @class PhaseTimer
+ * @brief RAII timer recording the lifetime of a scope into a phase histogram.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(MetricPhase p)
+        : phase(p), start(std::chrono::steady_clock::now()) {
+    }
+    ~PhaseTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        Metrics::phaseTime(phase, static_cast<unsigned long long>(ns));
+    }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    MetricPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Background thread that periodically exports a metrics snapshot
+ *        of the registry bound when it started to a Prometheus text file
+ *        and/or stderr (one JSON line).
+ */
+class MetricsExporter {
+public:
+    MetricsExporter() = default;
+    ~MetricsExporter() { stop(); }
+
+    /**
+     * @brief Start periodic export.
+     * @param filename Prometheus text file ("" = no file).
+     * @param intervalSeconds Export period.
+     * @param toStderr Also print a JSON line to stderr at each period (stdout
+     *        carries the job results, which the exporter thread must not split).
+     */
+    void start(const std::string& filename, double intervalSeconds, bool toStderr);
+
+    /// Stop the thread and perform one final export.
+    void stop();
+
+private:
+    void exportOnce();
+
+    std::string filename;
+    double interval = 10.0;
+    bool toStderr = false;
+    MetricsRegistry* source = nullptr;  ///< Registry bound to the thread that called start()
+    bool running = false;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,151 @@
+// ================================================================
+//  PairedComparison.cpp — Paired A/B comparison (OpenMP Optional)
+//  Notes:
+//    - A and B play match i back to back on the same thread, each game
+//      under its own RandomMatchStream(seed, i);
+//    - chunk sums are integers, so the totals are exact and identical
+//      for any thread count or schedule.
+// ================================================================
+#include "PairedComparison.h"
+#include "Game_TicTacToe.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+const int MATCH_CHUNK = 256;  // paired matches per task
+
+/// Integer totals of a range of paired matches.
+struct PairedCounts {
+    long long winsA = 0, drawsA = 0, winsB = 0, drawsB = 0;
+    long long sumDiff = 0;  ///< Sum of (A won) - (B won)
+    long long discordant = 0;
+};
+
+} // namespace
+
+double PairedComparison::normalQuantile(double p) {
+    // Bisection on the CDF; 100 halvings of [-40, 40] are far below double precision.
+    double lo = -40.0, hi = 40.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < p) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+PairedResult PairedComparison::run(const PolicySpec& a, const PolicySpec& b, const PolicySpec& opponent,
+    const PairedConfig& config) {
+    PairedResult result;
+#ifdef USE_OMP
+    double startTime = omp_get_wtime();
+#else
+    auto startTime = std::clock();
+#endif
+    if (!a.simulable() || !b.simulable() || !opponent.simulable()) {
+        std::cerr << "[ERROR] PairedComparison does not support the perfect policy\n";
+        result.ok = false;
+        return result;
+    }
+    if (config.matches <= 0) return result;
+
+    const long long batch = (config.batch > 0) ? std::min(config.batch, config.matches) : config.matches;
+    const long long maxLooks = (config.matches + batch - 1) / batch;
+    result.alpha = config.alpha;
+    result.maxLooks = maxLooks;
+    result.critical = normalQuantile(1.0 - config.alpha / (2.0 * maxLooks));
+
+    PairedCounts total;
+    long long done = 0;
+    while (done < config.matches) {
+        long long end = std::min(config.matches, done + batch);
+        const int tasks = static_cast<int>((end - done + MATCH_CHUNK - 1) / MATCH_CHUNK);
+        std::vector<PairedCounts> counts(tasks);
+
+        const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int t = 0; t < tasks; ++t) {
+            ContextBinding bindContext(context);
+            long long first = done + static_cast<long long>(t) * MATCH_CHUNK;
+            long long last = std::min(end, first + MATCH_CHUNK);
+            std::unique_ptr<Player> playerA = a.makePlayer('X');
+            std::unique_ptr<Player> playerB = b.makePlayer('X');
+            std::unique_ptr<Player> opp = opponent.makePlayer('O');
+            PairedCounts& c = counts[t];
+
+            for (long long i = first; i < last; ++i) {
+                char winnerA, winnerB;
+                {
+                    RandomMatchStream stream(config.seed, static_cast<std::uint64_t>(i));
+                    Game g(playerA.get(), opp.get());
+                    winnerA = g.play(false);
+                }
+                {
+                    RandomMatchStream stream(config.seed, static_cast<std::uint64_t>(i));
+                    Game g(playerB.get(), opp.get());
+                    winnerB = g.play(false);
+                }
+                int wonA = (winnerA == 'X'), wonB = (winnerB == 'X');
+                c.winsA += wonA;
+                c.winsB += wonB;
+                c.drawsA += (winnerA == ' ');
+                c.drawsB += (winnerB == ' ');
+                c.sumDiff += wonA - wonB;
+                c.discordant += (wonA != wonB);
+            }
+        }
+
+        for (const PairedCounts& c : counts) {
+            total.winsA += c.winsA;
+            total.drawsA += c.drawsA;
+            total.winsB += c.winsB;
+            total.drawsB += c.drawsB;
+            total.sumDiff += c.sumDiff;
+            total.discordant += c.discordant;
+        }
+        done = end;
+        ++result.looks;
+
+        // Differences are in {-1, 0, 1}: sum of squares = discordant matches.
+        double n = static_cast<double>(done);
+        double mean = total.sumDiff / n;
+        double variance = (done > 1) ? (total.discordant - n * mean * mean) / (n - 1.0) : 0.0;
+        result.stdError = std::sqrt(std::max(0.0, variance) / n);
+        result.diff = mean;
+        result.ciHalfWidth = result.critical * result.stdError;
+        result.significant = result.stdError > 0.0 && std::fabs(mean) > result.ciHalfWidth;
+        if (config.batch > 0 && result.significant) break;
+    }
+
+    double n = static_cast<double>(done);
+    double pA = total.winsA / n, pB = total.winsB / n;
+    result.matches = done;
+    result.winsA = total.winsA;
+    result.drawsA = total.drawsA;
+    result.lossesA = done - total.winsA - total.drawsA;
+    result.winsB = total.winsB;
+    result.drawsB = total.drawsB;
+    result.lossesB = done - total.winsB - total.drawsB;
+    result.discordant = total.discordant;
+    result.unpairedStdError = std::sqrt((pA * (1.0 - pA) + pB * (1.0 - pB)) / n);
+    result.stoppedEarly = done < config.matches;
+#ifdef USE_OMP
+    result.elapsedSeconds = omp_get_wtime() - startTime;
+#else
+    result.elapsedSeconds = double(std::clock() - startTime) / CLOCKS_PER_SEC;
+#endif
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef PAIREDCOMPARISON_H
+#define PAIREDCOMPARISON_H
+
+#include "ExactEvaluator.h"
+#include <cstdint>
+
+/**
+ * @struct PairedConfig
+ * @brief Settings of a paired A/B comparison.
+ */
+struct PairedConfig {
+    long long matches = 10000;  ///< Maximum number of paired matches
+    long long batch = 0;        ///< Look at the data every batch matches and stop once significant (0 = fixed size)
+    double alpha = 0.05;        ///< Two-sided significance level (split over the looks when stopping early)
+    std::uint64_t seed = 1;     ///< Seed of the match streams
+};
+
+/**
+ * @struct PairedResult
+ * @brief Outcome of a paired comparison; the difference is A minus B.
+ */
+struct PairedResult {
+    long long matches = 0;          ///< Paired matches played
+    long long winsA = 0, drawsA = 0, lossesA = 0;
+    long long winsB = 0, drawsB = 0, lossesB = 0;
+    long long discordant = 0;       ///< Matches where exactly one of A and B won
+    double diff = 0.0;              ///< Win-rate difference A - B
+    double stdError = 0.0;          ///< Standard error of diff from the paired differences
+    double unpairedStdError = 0.0;  ///< Standard error independent samples would give
+    double ciHalfWidth = 0.0;       ///< Half-width of the interval at level 1 - alpha / maxLooks
+    double critical = 0.0;          ///< Normal quantile used for the interval and the test
+    double alpha = 0.0;             ///< Overall two-sided level (PairedConfig::alpha)
+    long long maxLooks = 0;         ///< Looks the level is split over (1 without batching)
+    int looks = 0;                  ///< Interim analyses performed
+    bool significant = false;       ///< Zero lies outside the interval
+    bool stoppedEarly = false;      ///< Stopped before `matches` because significant
+    double elapsedSeconds = 0.0;
+    bool ok = true;                 ///< False if a policy cannot be simulated (nothing played)
+};
+
+/**
+ * @class PairedComparison
+ * @brief A/B comparison of two policies against one opponent with common
+ *        random numbers.
+ *
+ * Match i is played twice, once by A and once by B (both as X), each game
+ * under RandomMatchStream(seed, i): same first mover, same opponent move
+ * randomness. The per-match differences are much less noisy than two
+ * independent samples, so a real difference is detected with fewer
+ * matches. Matches are split into chunks over all threads; the result
+ * does not depend on the thread count.
+ *
+ * With batch > 0 the test is repeated after every batch and stops at the
+ * first significant look; the level is divided by the maximum number of
+ * looks (Bonferroni), so repeated testing does not inflate false positives.
+ */
+class PairedComparison {
+public:
+    static PairedResult run(const PolicySpec& a, const PolicySpec& b, const PolicySpec& opponent,
+        const PairedConfig& config);
+
+    /// Standard normal quantile (inverse CDF) of p in (0, 1).
+    static double normalQuantile(double p);
+};
+
+#endif // PAIREDCOMPARISON_H
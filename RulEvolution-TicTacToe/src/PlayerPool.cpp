@@ -0,0 +1,18 @@
+#include "PlayerPool.h"
+#include <algorithm>
+
+PlayerPool::PlayerPool(const Player& x, const Player& o, int workers)
+    : prototypeX(x), prototypeO(o), slots((std::max)(workers, 1)) {
+}
+
+Player& PlayerPool::x(int worker) {
+    Slot& slot = slots[worker];
+    if (!slot.x) slot.x = prototypeX.clone();
+    return *slot.x;
+}
+
+Player& PlayerPool::o(int worker) {
+    Slot& slot = slots[worker];
+    if (!slot.o) slot.o = prototypeO.clone();
+    return *slot.o;
+}
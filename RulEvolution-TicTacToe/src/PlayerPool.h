@@ -0,0 +1,40 @@
+#ifndef PLAYERPOOL_H
+#define PLAYERPOOL_H
+
+#include "Player_TicTacToe.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @class PlayerPool
+ * @brief One private copy of an X/O player pair per worker.
+ *
+ * Workers that shared one pair of Player objects wrote to the same cache
+ * lines (and raced on state refreshed at match start, e.g. live weights).
+ * Each worker now plays with clones of the two prototypes; a clone is made
+ * by the worker's own thread on first use, so it lands in that thread's
+ * heap, and the slots holding them sit on separate cache lines.
+ *
+ * The prototypes must outlive the pool and must not change while workers
+ * are cloning them.
+ */
+class PlayerPool {
+public:
+    PlayerPool(const Player& x, const Player& o, int workers);
+
+    Player& x(int worker);  ///< Worker's copy of the X prototype (call from that worker only)
+    Player& o(int worker);  ///< Worker's copy of the O prototype (call from that worker only)
+
+    int size() const { return static_cast<int>(slots.size()); }
+
+private:
+    struct alignas(64) Slot {
+        std::unique_ptr<Player> x, o;
+    };
+
+    const Player& prototypeX;
+    const Player& prototypeO;
+    std::vector<Slot> slots;
+};
+
+#endif // PLAYERPOOL_H
@@ -2,6 +2,7 @@
 #define PLAYER_TICTACTOE_H
 
 #include "Board_TicTacToe.h"
+#include <memory>
 
 /**
  * @class Player
@@ -9,7 +10,8 @@
  */
 class Player {
 protected:
-    char symbol; ///< 'X' or 'O'
+    char symbol;          ///< 'X' or 'O'
+    bool verbose = true;  ///< Print per-move traces to the console
 public:
     explicit Player(char s) : symbol(s) {}
     virtual ~Player() = default;
@@ -19,7 +21,22 @@ public:
      */
     virtual int chooseMove(const Board& board) = 0;
 
+    /**
+     * @brief Independent copy (symbol, settings and state) for one worker thread.
+     */
+    virtual std::unique_ptr<Player> clone() const = 0;
+
+    /**
+     * @brief Called by Game at the start of every match (match boundary).
+     */
+    virtual void beginMatch() {}
+
     char getSymbol() const { return symbol; }
+
+    /**
+     * @brief Enable or disable per-move console traces (headless runs disable them).
+     */
+    void setVerbose(bool v) { verbose = v; }
 };
 
 #endif // PLAYER_TICTACTOE_H
\ No newline at end of file
@@ -0,0 +1,385 @@
+// ================================================================
+//  PolicyTable.cpp — Compiled RulEvolution policy (OpenMP Optional)
+//  Notes:
+//    - keys are 2 * base3(board) + side (0 = X, 1 = O);
+//    - the 8 board symmetries are cell permutations: the canonical
+//      position C of P satisfies C[perm[t][i]] = P[i];
+//    - a symmetric entry is shared only if the distributions really
+//      match (index-order tie-breaks are not symmetric).
+// ================================================================
+#include "PolicyTable.h"
+#include "ExactEvaluator.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "ThreadContext.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    const int POW3[9] = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561 };
+    const char FILE_MAGIC[8] = { 'R', 'U', 'L', 'E', 'V', 'P', 'T', 'B' };
+    const std::uint32_t FILE_VERSION = 1;
+    const int MAX_FILE_WEIGHTS = 8;
+
+    struct PolicyFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;         ///< bit 0: symmetry-reduced
+        std::uint32_t numEntries;
+        std::uint32_t numWeights;
+        double weights[MAX_FILE_WEIGHTS];
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(PolicyFileHeader) == 96, "PolicyFileHeader layout");
+
+    /// perm[t][i]: cell of the transformed board that receives cell i.
+    struct Symmetries {
+        int perm[8][9];
+        Symmetries() {
+            for (int t = 0; t < 8; ++t) {
+                for (int i = 0; i < 9; ++i) {
+                    int r = i / 3, c = i % 3;
+                    if (t & 4) c = 2 - c;                       // reflection first
+                    for (int k = 0; k < (t & 3); ++k) {         // then k quarter turns
+                        int nr = c, nc = 2 - r;
+                        r = nr; c = nc;
+                    }
+                    perm[t][i] = 3 * r + c;
+                }
+            }
+        }
+    };
+    const Symmetries SYM;
+
+    inline std::uint32_t makeKey(int code, char side) {
+        return static_cast<std::uint32_t>(2 * code + (side == 'X' ? 0 : 1));
+    }
+
+    Board decode(int code) {
+        Board b;
+        for (int i = 0; i < 9; ++i) {
+            int v = code % 3;
+            code /= 3;
+            if (v == 1) b.place(i, 'X');
+            else if (v == 2) b.place(i, 'O');
+        }
+        return b;
+    }
+
+    void enumerate(const Board& board, int code, char side, std::vector<char>& seen,
+        std::vector<std::uint32_t>& out) {
+        std::uint32_t key = makeKey(code, side);
+        if (seen[key]) return;
+        seen[key] = 1;
+        out.push_back(key);
+        char next = (side == 'X') ? 'O' : 'X';
+        for (int i = 0; i < 9; ++i) {
+            if (!board.isEmpty(i)) continue;
+            Board child = board;
+            child.place(i, side);
+            if (child.winner() != ' ' || child.isFull()) continue;
+            enumerate(child, code + POW3[i] * (side == 'X' ? 1 : 2), next, seen, out);
+        }
+    }
+
+    /// All non-terminal (position, side to move) keys reachable from the empty board.
+    std::vector<std::uint32_t> reachableKeys() {
+        std::vector<char> seen(PolicyTable::INDEX_SIZE, 0);
+        std::vector<std::uint32_t> keys;
+        Board empty;
+        enumerate(empty, 0, 'X', seen, keys);
+        enumerate(empty, 0, 'O', seen, keys);
+        return keys;
+    }
+
+    void canonical(int code, int& canonCode, int& transform) {
+        canonCode = code;
+        transform = 0;
+        int digits[9];
+        for (int i = 0, c = code; i < 9; ++i, c /= 3) digits[i] = c % 3;
+        for (int t = 1; t < 8; ++t) {
+            int tc = 0;
+            for (int i = 0; i < 9; ++i) tc += digits[i] * POW3[SYM.perm[t][i]];
+            if (tc < canonCode) { canonCode = tc; transform = t; }
+        }
+    }
+
+    inline double probAt(const PolicyEntry& e, int cell) {
+        return e.cumulative[cell] - (cell > 0 ? e.cumulative[cell - 1] : 0.0f);
+    }
+
+    /// True if entry p equals entry c seen through symmetry t.
+    bool equivalent(const PolicyEntry& p, const PolicyEntry& c, int t) {
+        if (p.flags != c.flags) return false;
+        for (int i = 0; i < 9; ++i) {
+            int j = SYM.perm[t][i];
+            if (p.ruleMask[i] != c.ruleMask[j]) return false;
+            if (std::fabs(probAt(p, i) - probAt(c, j)) > 1e-6) return false;
+        }
+        return true;
+    }
+
+    /// True if every weight the entry depends on was scaled by the same factor.
+    bool rescaledOnly(unsigned dependsMask, const std::vector<double>& oldW,
+        const std::vector<double>& newW) {
+        double ratio = 0.0;
+        for (int r = RULE_BLOCK; r <= RULE_PREPARATION; ++r) {
+            if (!(dependsMask & (1u << r))) continue;
+            size_t k = static_cast<size_t>(r - 1);
+            if (k >= oldW.size() || k >= newW.size()) return false;
+            if (oldW[k] == 0.0 && newW[k] == 0.0) continue;   // zero stays zero under scaling
+            if (oldW[k] <= 0.0 || newW[k] <= 0.0) return false;
+            double q = newW[k] / oldW[k];
+            if (ratio == 0.0) ratio = q;
+            else if (std::fabs(q - ratio) > 1e-12 * ratio) return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+void PolicyTable::computeEntry(std::uint32_t key, PolicyEntry& entry) const {
+    Board board = decode(static_cast<int>(key / 2));
+    char side = (key & 1) ? 'O' : 'X';
+    MoveDistribution dist = RulEvolutionPlayer::distribution(board, side, weights);
+
+    std::memset(&entry, 0, sizeof(entry));
+    double cumulative = 0.0;
+    for (int i = 0; i < 9; ++i) {
+        cumulative += dist.prob[i];
+        entry.cumulative[i] = static_cast<float>(cumulative);
+        entry.ruleMask[i] = static_cast<unsigned char>(dist.ruleMask[i]);
+        if (dist.sampled) entry.dependsMask |= static_cast<unsigned char>(dist.ruleMask[i]);
+    }
+    entry.dependsMask &= static_cast<unsigned char>(~(1u << RULE_WIN));
+    if (dist.sampled) entry.flags |= POLICY_SAMPLED;
+    if (dist.absoluteWin) entry.flags |= POLICY_ABSOLUTE_WIN;
+}
+
+void PolicyTable::compile(const std::vector<double>& newWeights, bool symmetryReduced) {
+    mapping.close();
+    weights = newWeights;
+    symmetric = symmetryReduced;
+
+    std::vector<std::uint32_t> reach = reachableKeys();
+    std::vector<PolicyEntry> all(reach.size());
+
+    const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < static_cast<int>(reach.size()); ++i) {
+        ContextBinding bindContext(context);
+        computeEntry(reach[i], all[i]);
+    }
+
+    ownedIndex.assign(INDEX_SIZE, NO_ENTRY);
+    ownedKeys.clear();
+    ownedEntries.clear();
+
+    if (!symmetric) {
+        ownedKeys = reach;
+        ownedEntries = all;
+        for (size_t i = 0; i < reach.size(); ++i)
+            ownedIndex[reach[i]] = static_cast<std::uint32_t>(i) << 3;
+        attach();
+        return;
+    }
+
+    // Canonical positions first, then symmetric ones that share their entry.
+    std::vector<std::uint32_t> slot(INDEX_SIZE, NO_ENTRY);
+    for (size_t i = 0; i < reach.size(); ++i) slot[reach[i]] = static_cast<std::uint32_t>(i);
+
+    for (size_t i = 0; i < reach.size(); ++i) {
+        int canonCode, t;
+        canonical(static_cast<int>(reach[i] / 2), canonCode, t);
+        if (t != 0) continue;
+        ownedIndex[reach[i]] = static_cast<std::uint32_t>(ownedEntries.size()) << 3;
+        ownedKeys.push_back(reach[i]);
+        ownedEntries.push_back(all[i]);
+    }
+    for (size_t i = 0; i < reach.size(); ++i) {
+        int canonCode, t;
+        canonical(static_cast<int>(reach[i] / 2), canonCode, t);
+        if (t == 0) continue;
+        std::uint32_t canonKey = static_cast<std::uint32_t>(2 * canonCode) + (reach[i] & 1);
+        std::uint32_t canonEntry = ownedIndex[canonKey] >> 3;
+        if (equivalent(all[i], all[slot[canonKey]], t)) {
+            ownedIndex[reach[i]] = (canonEntry << 3) | static_cast<std::uint32_t>(t);
+        }
+        else {
+            ownedIndex[reach[i]] = static_cast<std::uint32_t>(ownedEntries.size()) << 3;
+            ownedKeys.push_back(reach[i]);
+            ownedEntries.push_back(all[i]);
+        }
+    }
+    attach();
+}
+
+int PolicyTable::update(const std::vector<double>& newWeights) {
+    if (!isReady() || newWeights.size() != weights.size()) {
+        compile(newWeights, symmetric);
+        return static_cast<int>(numEntries);
+    }
+    makeOwned();
+
+    std::vector<double> oldWeights = weights;
+    weights = newWeights;
+    std::vector<char> changed(ownedEntries.size(), 0);
+    int recomputed = 0;
+
+    const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+:recomputed)
+#endif
+    for (int i = 0; i < static_cast<int>(ownedEntries.size()); ++i) {
+        if (rescaledOnly(ownedEntries[i].dependsMask, oldWeights, newWeights)) continue;
+        ContextBinding bindContext(context);
+        computeEntry(ownedKeys[i], ownedEntries[i]);
+        changed[i] = 1;
+        ++recomputed;
+    }
+
+    // Shared symmetric entries must still match every position that uses them.
+    if (symmetric && recomputed > 0) {
+        for (int key = 0; key < INDEX_SIZE; ++key) {
+            std::uint32_t idx = ownedIndex[key];
+            if (idx == NO_ENTRY || (idx & 7) == 0 || !changed[idx >> 3]) continue;
+            PolicyEntry own;
+            computeEntry(static_cast<std::uint32_t>(key), own);
+            if (!equivalent(own, ownedEntries[idx >> 3], static_cast<int>(idx & 7))) {
+                compile(newWeights, true);
+                return static_cast<int>(numEntries);
+            }
+        }
+    }
+    return recomputed;
+}
+
+void PolicyTable::makeOwned() {
+    if (!mapping.isOpen()) return;
+    ownedIndex.assign(index, index + INDEX_SIZE);
+    ownedKeys.assign(keys, keys + numEntries);
+    ownedEntries.assign(entries, entries + numEntries);
+    mapping.close();
+    attach();
+}
+
+void PolicyTable::attach() {
+    index = ownedIndex.data();
+    keys = ownedKeys.data();
+    entries = ownedEntries.data();
+    numEntries = ownedEntries.size();
+}
+
+std::size_t PolicyTable::byteSize() const {
+    return sizeof(PolicyFileHeader) + INDEX_SIZE * sizeof(std::uint32_t)
+        + numEntries * (sizeof(std::uint32_t) + sizeof(PolicyEntry));
+}
+
+bool PolicyTable::save(const std::string& filename) const {
+    if (!isReady() || weights.size() > static_cast<size_t>(MAX_FILE_WEIGHTS)) return false;
+
+    PolicyFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.flags = symmetric ? 1u : 0u;
+    header.numEntries = static_cast<std::uint32_t>(numEntries);
+    header.numWeights = static_cast<std::uint32_t>(weights.size());
+    for (size_t i = 0; i < weights.size(); ++i) header.weights[i] = weights[i];
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.good()) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index), INDEX_SIZE * sizeof(std::uint32_t));
+    out.write(reinterpret_cast<const char*>(keys), numEntries * sizeof(std::uint32_t));
+    out.write(reinterpret_cast<const char*>(entries), numEntries * sizeof(PolicyEntry));
+    return out.good();
+}
+
+bool PolicyTable::map(const std::string& filename) {
+    MappedFile file;
+    if (!file.open(filename) || file.size() < sizeof(PolicyFileHeader)) return false;
+
+    PolicyFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || header.version != FILE_VERSION
+        || header.numWeights > static_cast<std::uint32_t>(MAX_FILE_WEIGHTS))
+        return false;
+
+    size_t expected = sizeof(PolicyFileHeader) + INDEX_SIZE * sizeof(std::uint32_t)
+        + header.numEntries * (sizeof(std::uint32_t) + sizeof(PolicyEntry));
+    if (file.size() != expected) return false;
+
+    // findCode() and update() follow the index and keys without checks, so
+    // a corrupt file must be refused here rather than read out of bounds.
+    const unsigned char* p = file.data() + sizeof(PolicyFileHeader);
+    const std::uint32_t* fileIndex = reinterpret_cast<const std::uint32_t*>(p);
+    const std::uint32_t* fileKeys = reinterpret_cast<const std::uint32_t*>(p + INDEX_SIZE * sizeof(std::uint32_t));
+    for (int key = 0; key < INDEX_SIZE; ++key)
+        if (fileIndex[key] != NO_ENTRY && (fileIndex[key] >> 3) >= header.numEntries) return false;
+    for (std::uint32_t i = 0; i < header.numEntries; ++i)
+        if (fileKeys[i] >= static_cast<std::uint32_t>(INDEX_SIZE)) return false;
+
+    index = fileIndex;
+    keys = fileKeys;
+    entries = reinterpret_cast<const PolicyEntry*>(p + (INDEX_SIZE + header.numEntries) * sizeof(std::uint32_t));
+    numEntries = header.numEntries;
+    weights.assign(header.weights, header.weights + header.numWeights);
+    symmetric = (header.flags & 1u) != 0;
+
+    ownedIndex.clear();
+    ownedKeys.clear();
+    ownedEntries.clear();
+    mapping = std::move(file);
+    return true;
+}
+
+const PolicyEntry* PolicyTable::find(const Board& board, char side, int& transform) const {
+    return findCode(ExactEvaluator::encode(board), side, transform);
+}
+
+const PolicyEntry* PolicyTable::findCode(int code, char side, int& transform) const {
+    if (!entries) return nullptr;
+    std::uint32_t idx = index[makeKey(code, side)];
+    if (idx == NO_ENTRY) return nullptr;
+    transform = static_cast<int>(idx & 7);
+    return &entries[idx >> 3];
+}
+
+int PolicyTable::pick(const PolicyEntry& entry, int transform, double u) {
+    if (transform == 0) {
+        int last = -1;
+        float prev = 0.0f;
+        for (int i = 0; i < 9; ++i) {
+            if (entry.cumulative[i] <= prev) continue;
+            prev = entry.cumulative[i];
+            last = i;
+            if (u <= entry.cumulative[i]) return i;
+        }
+        return (last >= 0) ? last : 0;
+    }
+
+    double cumulative = 0.0;
+    int last = -1;
+    for (int i = 0; i < 9; ++i) {
+        double p = probAt(entry, SYM.perm[transform][i]);
+        if (p <= 0.0) continue;
+        cumulative += p;
+        last = i;
+        if (u <= cumulative) return i;
+    }
+    return (last >= 0) ? last : 0;
+}
+
+unsigned PolicyTable::ruleMask(const PolicyEntry& entry, int transform, int cell) {
+    if (cell < 0 || cell >= 9) return 0;
+    return entry.ruleMask[transform == 0 ? cell : SYM.perm[transform][cell]];
+}
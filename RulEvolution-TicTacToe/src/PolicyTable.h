@@ -0,0 +1,116 @@
+#ifndef POLICYTABLE_H
+#define POLICYTABLE_H
+
+#include "Board_TicTacToe.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// PolicyEntry::flags bits
+const unsigned char POLICY_SAMPLED = 0x01;       ///< A random draw decides the move
+const unsigned char POLICY_ABSOLUTE_WIN = 0x02;  ///< The absolute WIN rule applies
+
+/**
+ * @struct PolicyEntry
+ * @brief Compiled move distribution of one (position, side to move).
+ *
+ * Plain 48-byte record, stored as-is in the table file so that a mapped
+ * table needs no decoding.
+ */
+struct PolicyEntry {
+    float cumulative[9];         ///< Cumulative move probability, cell order 0..8
+    unsigned char ruleMask[9];   ///< Rules supporting each cell (bit = 1 << RuleType)
+    unsigned char flags;         ///< POLICY_SAMPLED / POLICY_ABSOLUTE_WIN
+    unsigned char dependsMask;   ///< Rules whose weights this entry depends on
+    unsigned char reserved;
+};
+static_assert(sizeof(PolicyEntry) == 48, "PolicyEntry must stay 48 bytes (file format)");
+
+/**
+ * @class PolicyTable
+ * @brief Inference-only lookup table of the RulEvolution policy.
+ *
+ * compile() turns a weight snapshot into one entry per reachable
+ * (position, side to move); a move then costs one table load plus one
+ * random draw. Optionally symmetry-reduced: positions whose distribution is
+ * the rotated/reflected distribution of their canonical position share its
+ * entry. Tables can be updated incrementally when weights change, saved,
+ * and memory-mapped back (native byte order).
+ */
+class PolicyTable {
+public:
+    static const std::uint32_t NO_ENTRY = 0xFFFFFFFFu;
+    static const int INDEX_SIZE = 2 * 19683;  ///< (base-3 code, side) pairs
+
+    PolicyTable() = default;
+    PolicyTable(const PolicyTable&) = delete;
+    PolicyTable& operator=(const PolicyTable&) = delete;
+
+    /**
+     * @brief Build the table for a weight vector (layout of RulEvolutionRules::evaluate()).
+     * @param symmetryReduced Share entries between symmetric positions.
+     */
+    void compile(const std::vector<double>& weights, bool symmetryReduced = false);
+
+    /**
+     * @brief Bring the table up to date with new weights, recomputing only
+     *        entries whose distribution can change (entries that depend on a
+     *        changed rule and are not merely rescaled).
+     * @return Number of recomputed entries.
+     */
+    int update(const std::vector<double>& weights);
+
+    /// Save the table (header, index, entries) to a binary file.
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief Map a saved table read-only; entries are used in place (zero-copy).
+     * @return false if the file is not a table or any index slot or key is
+     *         out of range (the table is left unchanged).
+     */
+    bool map(const std::string& filename);
+
+    /**
+     * @brief Find the entry of a position.
+     * @param transform Receives the symmetry mapping the position onto the entry.
+     * @return nullptr if the position is not in the table.
+     */
+    const PolicyEntry* find(const Board& board, char side, int& transform) const;
+
+    /// find() for a position given by its base-3 code (ExactEvaluator::encode()).
+    const PolicyEntry* findCode(int code, char side, int& transform) const;
+
+    /// Pick a cell for a uniform draw u in [0,1].
+    static int pick(const PolicyEntry& entry, int transform, double u);
+
+    /// Rules supporting a cell of the looked-up position.
+    static unsigned ruleMask(const PolicyEntry& entry, int transform, int cell);
+
+    bool isReady() const { return entries != nullptr; }
+    bool isSymmetryReduced() const { return symmetric; }
+    bool isMapped() const { return mapping.isOpen(); }
+    std::size_t entryCount() const { return numEntries; }
+    std::size_t byteSize() const;
+    const std::vector<double>& getWeights() const { return weights; }
+
+private:
+    void computeEntry(std::uint32_t key, PolicyEntry& entry) const;
+    void makeOwned();
+    void attach();
+
+    std::vector<std::uint32_t> ownedIndex;    ///< (entry << 3) | transform, per key
+    std::vector<std::uint32_t> ownedKeys;     ///< Representative key of each entry
+    std::vector<PolicyEntry> ownedEntries;
+    MappedFile mapping;
+
+    const std::uint32_t* index = nullptr;
+    const std::uint32_t* keys = nullptr;
+    const PolicyEntry* entries = nullptr;
+    std::size_t numEntries = 0;
+
+    std::vector<double> weights;  ///< Weights the table was compiled for
+    bool symmetric = false;
+};
+
+#endif // POLICYTABLE_H
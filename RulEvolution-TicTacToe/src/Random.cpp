@@ -0,0 +1,36 @@
+#include "Random.h"
+
+RandomSource Random::defaultSource;
+
+void RandomSource::seed(std::uint64_t s) {
+    seedValue.store(s, std::memory_order_relaxed);
+    position.store(0, std::memory_order_relaxed);
+}
+
+RandomState RandomSource::state() const {
+    RandomState s;
+    s.seed = seedValue.load(std::memory_order_relaxed);
+    s.position = position.load(std::memory_order_relaxed);
+    return s;
+}
+
+void RandomSource::restore(const RandomState& s) {
+    seedValue.store(s.seed, std::memory_order_relaxed);
+    position.store(s.position, std::memory_order_relaxed);
+}
+
+RandomMatchStream::RandomMatchStream(std::uint64_t seed, std::uint64_t match) {
+    MatchStreamState& local = Random::matchStream();
+    previous = local;
+    std::uint64_t matchSeed = RandomSource::mix(seed + (match + 1) * 0xD1B54A32D192ED03ull);
+    for (int c = 0; c < RANDOM_CHANNEL_COUNT; ++c) {
+        local.base[c] = RandomSource::mix(matchSeed + (c + 1) * 0x9E3779B97F4A7C15ull);
+        local.position[c] = 0;
+    }
+    local.channel = RANDOM_CHANNEL_GAME;
+    local.active = true;
+}
+
+RandomMatchStream::~RandomMatchStream() {
+    Random::matchStream() = previous;
+}
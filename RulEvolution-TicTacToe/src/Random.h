@@ -0,0 +1,192 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct RandomState
+ * @brief Complete state of the shared random stream: seed and position.
+ */
+struct RandomState {
+    std::uint64_t seed = 0;      ///< Stream seed
+    std::uint64_t position = 0;  ///< Numbers drawn since seeding
+};
+
+/**
+ * @enum RandomChannel
+ * @brief Independent substreams of a match stream (see RandomMatchStream).
+ */
+enum RandomChannel {
+    RANDOM_CHANNEL_GAME = 0,  ///< First-mover draw in Game::play
+    RANDOM_CHANNEL_X,         ///< Moves of player X
+    RANDOM_CHANNEL_O,         ///< Moves of player O
+    RANDOM_CHANNEL_COUNT
+};
+
+/**
+ * @struct MatchStreamState
+ * @brief Per-thread state of the active match stream.
+ */
+struct MatchStreamState {
+    bool active = false;
+    int channel = RANDOM_CHANNEL_GAME;
+    std::uint64_t base[RANDOM_CHANNEL_COUNT] = {};      ///< Seed of each channel
+    std::uint64_t position[RANDOM_CHANNEL_COUNT] = {};  ///< Numbers drawn per channel
+};
+
+/**
+ * @class RandomSource
+ * @brief One counter-based random stream: the n-th number is a pure
+ *        function of (seed, n) (SplitMix64 finalizer), so the position is
+ *        one atomic counter and drawing is lock-free from any thread.
+ *
+ * Each Engine owns its own source; code that runs outside an engine uses
+ * a process default.
+ */
+class RandomSource {
+public:
+    explicit RandomSource(std::uint64_t seed = 0x853C49E6748FEA9Bull) : seedValue(seed) {}
+    RandomSource(const RandomSource&) = delete;
+    RandomSource& operator=(const RandomSource&) = delete;
+
+    /// Next 64 random bits.
+    std::uint64_t next() {
+        std::uint64_t n = position.fetch_add(1, std::memory_order_relaxed);
+        return at(seedValue.load(std::memory_order_relaxed), n);
+    }
+
+    /**
+     * @brief Claim the next n numbers with one atomic step: number i of the
+     *        block is at(seed, first + i), exactly what n next() calls return.
+     * @return Position of the first number of the block.
+     */
+    std::uint64_t reserve(std::uint64_t n, std::uint64_t& seed) {
+        seed = seedValue.load(std::memory_order_relaxed);
+        return position.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// Number at a position of the stream with this seed.
+    static std::uint64_t at(std::uint64_t seed, std::uint64_t n) {
+        return mix(seed + (n + 1) * 0x9E3779B97F4A7C15ull);
+    }
+
+    void seed(std::uint64_t s);                ///< Restart at position 0 with a new seed
+    RandomState state() const;                 ///< Current seed and position
+    void restore(const RandomState& s);        ///< Continue a saved stream
+
+    /// SplitMix64 finalizer.
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::atomic<std::uint64_t> seedValue;
+    std::atomic<std::uint64_t> position{ 0 };
+};
+
+/**
+ * @class Random
+ * @brief Random numbers for players and games, drawn from the source bound
+ *        to the calling thread (RandomBinding), or the process default.
+ *
+ * state()/restore() capture and resume the bound stream exactly, which
+ * std::rand() cannot do. While a RandomMatchStream is alive on a thread,
+ * that thread draws from the match stream instead, in the channel
+ * selected by channel().
+ */
+class Random {
+public:
+    /// Restart the bound stream at position 0 with a new seed.
+    static void seed(std::uint64_t s) { source().seed(s); }
+
+    /// Next 64 random bits.
+    static std::uint64_t next() {
+        MatchStreamState& local = matchStream();
+        if (local.active) {
+            int c = local.channel;
+            return RandomSource::mix(local.base[c] + (++local.position[c]) * 0x9E3779B97F4A7C15ull);
+        }
+        return source().next();
+    }
+
+    /// Uniform integer in [0, n), n > 0.
+    static int below(int n) {
+        return static_cast<int>(((next() >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+    }
+
+    /// Uniform double in [0, 1).
+    static double unit() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    static RandomState state() { return source().state(); }             ///< Current seed and position
+    static void restore(const RandomState& s) { source().restore(s); } ///< Continue a saved stream
+
+    /// Select the channel of the active match stream (no effect without one).
+    static void channel(RandomChannel c) { matchStream().channel = c; }
+
+    /// Source bound to the calling thread (the process default if none).
+    static RandomSource& source() {
+        RandomSource* bound = binding();
+        return bound ? *bound : defaultSource;
+    }
+
+private:
+    friend class RandomMatchStream;
+    friend class RandomBinding;
+
+    static MatchStreamState& matchStream() {
+        static thread_local MatchStreamState local;
+        return local;
+    }
+
+    static RandomSource*& binding() {
+        static thread_local RandomSource* bound = nullptr;
+        return bound;
+    }
+
+    static RandomSource defaultSource;
+};
+
+/**
+ * @class RandomBinding
+ * @brief Scoped binding of a RandomSource to the calling thread. Parallel
+ *        regions bind the caller's source in every worker thread, so an
+ *        engine's randomness never leaks into another engine.
+ */
+class RandomBinding {
+public:
+    explicit RandomBinding(RandomSource& source) : previous(Random::binding()) { Random::binding() = &source; }
+    ~RandomBinding() { Random::binding() = previous; }
+    RandomBinding(const RandomBinding&) = delete;
+    RandomBinding& operator=(const RandomBinding&) = delete;
+
+private:
+    RandomSource* previous;
+};
+
+/**
+ * @class RandomMatchStream
+ * @brief Scoped common random numbers: every draw of this thread, while
+ *        the object lives, is a pure function of (seed, match, channel,
+ *        draw index).
+ *
+ * Two games played under the same (seed, match) get the same first-mover
+ * draw and, channel by channel, the same move randomness, whichever
+ * thread plays them; this pairs the games of an A/B comparison.
+ */
+class RandomMatchStream {
+public:
+    RandomMatchStream(std::uint64_t seed, std::uint64_t match);
+    ~RandomMatchStream();
+    RandomMatchStream(const RandomMatchStream&) = delete;
+    RandomMatchStream& operator=(const RandomMatchStream&) = delete;
+
+private:
+    MatchStreamState previous;  ///< Restored on destruction (streams nest)
+};
+
+#endif // RANDOM_H
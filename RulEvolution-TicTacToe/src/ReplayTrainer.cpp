@@ -0,0 +1,103 @@
+// ================================================================
+//  ReplayTrainer.cpp — Offline training from a game log (OpenMP Optional)
+//  Notes:
+//    - one block of histograms (4096 games, 28 KB) is built at a time and
+//      applied with updateFromBatch(strict), so results match live training;
+//    - shards are contiguous block ranges fixed by the shard count, not by
+//      the thread count, so the merge input is always the same.
+// ================================================================
+#include "ReplayTrainer.h"
+#include "MergeStrategy.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "ThreadContext.h"
+#include <chrono>
+#include <vector>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    double wallTime() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Learn blocks [first, last) of the log, in order.
+    void replayBlocks(const GameLogReader& log, size_t first, size_t last, LearningModule& learner) {
+        std::vector<RuleUsage> games(GameLog::BLOCK_RECORDS);
+        for (size_t b = first; b < last; ++b) {
+            GameLogBlock blk = log.block(b);
+            ReplayTrainer::usage(blk, games.data());
+            learner.updateFromBatch(games.data(), blk.count, true);
+        }
+    }
+
+} // namespace
+
+void ReplayTrainer::usage(const GameLogBlock& blk, RuleUsage* out) {
+    for (std::uint32_t i = 0; i < blk.count; ++i) {
+        RuleUsage& u = out[i];
+        for (int r = 0; r < RULE_COUNT; ++r)
+            u.count[r] = static_cast<unsigned char>(GameLog::ruleUses(blk.masks[i], r));
+        u.hasWon = GameLog::hasWon(blk.meta[i]);
+    }
+}
+
+ReplayResult ReplayTrainer::run(const GameLogReader& log, LearningModule& learner,
+    int shards, const MergeStrategy* merge) {
+    ReplayResult result;
+    double start = wallTime();
+    size_t blocks = log.blockCount();
+    if (shards < 1) shards = 1;
+    if (static_cast<size_t>(shards) > blocks) shards = blocks > 0 ? static_cast<int>(blocks) : 1;
+
+    if (shards == 1) {
+        replayBlocks(log, 0, blocks, learner);
+    }
+    else {
+        if (!merge) merge = &MergeStrategy::defaultStrategy();
+        std::vector<LearningModule> workers(shards, learner);
+
+        const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (int s = 0; s < shards; ++s) {
+            ContextBinding bindContext(context);
+            TraceSpan span(TRACE_WORKER, static_cast<std::uint32_t>(s));
+            replayBlocks(log, blocks * s / shards, blocks * (s + 1) / shards, workers[s]);
+        }
+
+        PhaseTimer mergeTimer(PHASE_MERGE);
+        TraceSpan mergeSpan(TRACE_MERGE);
+        Metrics::add(METRIC_MERGES);
+        merge->merge(learner, workers);
+    }
+
+    result.games = static_cast<long long>(log.gameCount());
+    result.shards = shards;
+    result.elapsedSeconds = wallTime() - start;
+    return result;
+}
+
+ReplayResult ReplayTrainer::runMany(const GameLogReader& log, std::vector<LearningModule>& learners) {
+    ReplayResult result;
+    double start = wallTime();
+
+    const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int i = 0; i < static_cast<int>(learners.size()); ++i) {
+        ContextBinding bindContext(context);
+        replayBlocks(log, 0, log.blockCount(), learners[i]);
+    }
+
+    result.games = static_cast<long long>(log.gameCount());
+    result.shards = 1;
+    result.elapsedSeconds = wallTime() - start;
+    return result;
+}
@@ -0,0 +1,51 @@
+#ifndef REPLAYTRAINER_H
+#define REPLAYTRAINER_H
+
+#include "LearningModule.h"
+#include "GameLog.h"
+#include <vector>
+
+class MergeStrategy;
+
+/**
+ * @struct ReplayResult
+ * @brief Summary of one replay pass.
+ */
+struct ReplayResult {
+    long long games = 0;          ///< Games replayed (per learner)
+    int shards = 0;               ///< Shards merged at the end (1 = sequential)
+    double elapsedSeconds = 0.0;  ///< Wall time of the pass
+};
+
+/**
+ * @class ReplayTrainer
+ * @brief Offline training from a recorded GameLog, without re-simulating.
+ *
+ * Every game is applied with its recorded learning outcome through
+ * LearningModule::updateFromBatch() in strict mode, i.e. with exactly the
+ * semantics of calling updateFromGame() game by game. Rule histograms are
+ * built straight from the log columns; games are never decoded.
+ */
+class ReplayTrainer {
+public:
+    /**
+     * @brief Replay a log into one learner.
+     * @param shards 1 = all games in file order on the learner itself; N > 1 =
+     *        N contiguous block ranges learned in parallel on copies of the
+     *        learner and merged in shard order (deterministic for a given N).
+     * @param merge Merge strategy for N > 1; nullptr = MergeStrategy::defaultStrategy().
+     */
+    static ReplayResult run(const GameLogReader& log, LearningModule& learner,
+        int shards = 1, const MergeStrategy* merge = nullptr);
+
+    /**
+     * @brief Replay the whole log sequentially into each learner, learners in
+     *        parallel: one pass per hyperparameter set, no merge.
+     */
+    static ReplayResult runMany(const GameLogReader& log, std::vector<LearningModule>& learners);
+
+    /// Rule histograms of every game of a block (out must hold blk.count entries).
+    static void usage(const GameLogBlock& blk, RuleUsage* out);
+};
+
+#endif // REPLAYTRAINER_H
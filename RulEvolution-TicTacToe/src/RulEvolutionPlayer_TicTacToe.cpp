@@ -1,25 +1,110 @@
 ﻿#include "RulEvolutionPlayer_TicTacToe.h"
 #include "RulEvolutionRules.h"
-#include <map>
+#include "Metrics.h"
+#include "PolicyTable.h"
+#include "Random.h"
+#include "WeightStore.h"
 #include <iostream>
 #include <algorithm>
 #include <cstdlib>
 
-RulEvolutionPlayer::RulEvolutionPlayer(char s, const LearningState& initState)
+RulEvolutionPlayer::RulEvolutionPlayer(char s, const LearningState& initState, bool verbose)
     : Player(s), state(initState) {
+    setVerbose(verbose);
     if (state.weights.empty()) {
         state.weights.resize(5, 0.5); // only 5 adaptive rules
-        std::cout << "[INIT] RulEvolutionPlayer: weights initialized (5 adaptive rules)\n";
+        if (verbose)
+            std::cout << "[INIT] RulEvolutionPlayer: weights initialized (5 adaptive rules)\n";
     }
 }
 
+void RulEvolutionPlayer::follow(const WeightStore* store) {
+    liveWeights = store;
+    liveGeneration = 0;
+    if (liveWeights) refreshWeights();
+}
+
+bool RulEvolutionPlayer::refreshWeights() {
+    if (!liveWeights || !liveWeights->refresh(state.weights, liveGeneration)) return false;
+    policyTable = nullptr;
+    if (verbose)
+        std::cout << "[RulEvolutionPlayer] adopted live weights, generation " << liveGeneration << "\n";
+    return true;
+}
+
 int RulEvolutionPlayer::chooseMove(const Board& board) {
-    std::vector<RuleType> dummy;
+    unsigned dummy = 0;
     return chooseMove(board, dummy);
 }
 
 int RulEvolutionPlayer::chooseMove(const Board& board, std::vector<RuleType>& rulesUsed) {
-    rulesUsed.clear();
+    unsigned rulesMask = 0;
+    int move = chooseMove(board, rulesMask);
+    rulesFromMask(rulesMask, rulesUsed);
+    return move;
+}
+
+int RulEvolutionPlayer::chooseMove(const Board& board, unsigned& rulesMask) {
+    rulesMask = 0;
+
+    int chosenMove = 0;
+    unsigned mask = 0;
+    bool absoluteWin = false, sampled = false;
+
+    int transform = 0;
+    const PolicyEntry* entry = policyTable ? policyTable->find(board, symbol, transform) : nullptr;
+    if (entry) {
+        // Compiled policy: one table load plus one random draw
+        absoluteWin = (entry->flags & POLICY_ABSOLUTE_WIN) != 0;
+        sampled = (entry->flags & POLICY_SAMPLED) != 0;
+        double u = sampled ? Random::unit() : 0.0;
+        chosenMove = PolicyTable::pick(*entry, transform, u);
+        mask = PolicyTable::ruleMask(*entry, transform, chosenMove);
+    }
+    else {
+        MoveDistribution dist = distribution(board, symbol, state.weights);
+        absoluteWin = dist.absoluteWin;
+        sampled = dist.sampled;
+        double u = sampled ? Random::unit() : 0.0;
+        chosenMove = dist.pick(u);
+        mask = dist.ruleMask[chosenMove];
+    }
+
+    // 1️⃣ Absolute WIN rule — always checked first
+    if (absoluteWin) {
+        rulesMask = 1u << RULE_WIN;
+        Metrics::ruleFired(RULE_WIN);
+        if (verbose)
+            std::cout << "[RulEvolutionPlayer] Absolute WIN rule applied at cell " << chosenMove << "\n";
+        return chosenMove;
+    }
+    if (!sampled)
+        return chosenMove;
+
+    // 3️⃣ Reflective-Exploration probabilistic choice
+    rulesMask = mask;
+    for (int r = RULE_WIN; r <= RULE_PREPARATION; ++r)
+        if (mask & (1u << r)) Metrics::ruleFired(static_cast<RuleType>(r));
+
+    if (verbose)
+        std::cout << "[RulEvolutionPlayer] chose cell " << chosenMove
+            << " (probabilistic selection)\n";
+    return chosenMove;
+}
+
+/**
+ * @brief Reflective-Exploration as a distribution: a score-proportional draw
+ *        r in [0, totalScore] picks the first cell (in index order) whose
+ *        cumulative score reaches r; any uncovered mass falls back to the
+ *        first empty cell, exactly like the sampled choice.
+ */
+MoveDistribution RulEvolutionPlayer::distribution(const Board& board, char symbol,
+    const std::vector<double>& weights) {
+    MoveDistribution dist;
+
+    int firstEmpty = -1;
+    for (int i = 0; i < 9; ++i)
+        if (board.isEmpty(i)) { firstEmpty = i; break; }
 
     // 1️⃣ Absolute WIN rule — always checked first
     for (int i = 0; i < 9; ++i) {
@@ -27,58 +112,62 @@ int RulEvolutionPlayer::chooseMove(const Board& board, std::vector<RuleType>& ru
             Board temp = board;
             temp.place(i, symbol);
             if (temp.winner() == symbol) {
-                rulesUsed.push_back(RULE_WIN);
-                std::cout << "[RulEvolutionPlayer] Absolute WIN rule applied at cell " << i << "\n";
-                return i;
+                dist.prob[i] = 1.0;
+                dist.ruleMask[i] = 1u << RULE_WIN;
+                dist.absoluteWin = true;
+                return dist;
             }
         }
     }
 
     // 2️⃣ Evaluate remaining adaptive rules
-    auto evals = RulEvolutionRules::evaluate(board, symbol, state.weights);
+    RuleEvaluationList evals;
+    RulEvolutionRules::evaluate(board, symbol, weights, evals);
     if (evals.empty()) {
-        for (int i = 0; i < 9; ++i)
-            if (board.isEmpty(i))
-                return i;
-        return 0;
+        dist.prob[firstEmpty >= 0 ? firstEmpty : 0] = 1.0;
+        return dist;
     }
 
-    std::map<int, double> scoreMap;
-    std::map<int, std::vector<RuleType>> ruleMap;
-
+    std::array<double, 9> score{};
+    std::array<bool, 9> scored{};
     for (const auto& e : evals) {
         if (e.moveIndex < 0 || e.moveIndex >= 9) continue;
-        scoreMap[e.moveIndex] += e.score;
-        ruleMap[e.moveIndex].push_back(e.ruleIndex);
+        score[e.moveIndex] += e.score;
+        scored[e.moveIndex] = true;
+        dist.ruleMask[e.moveIndex] |= 1u << e.ruleIndex;
     }
 
-    // 3️⃣ Reflective-Exploration probabilistic choice
     double totalScore = 0.0;
-    for (const auto& kv : scoreMap)
-        if (kv.second > 0) totalScore += kv.second;
-
-    double r = ((double)std::rand() / RAND_MAX) * totalScore;
-    double cumulative = 0.0;
-    int chosenMove = -1;
-
-    for (const auto& kv : scoreMap) {
-        cumulative += kv.second;
-        if (r <= cumulative) {
-            chosenMove = kv.first;
-            break;
+    for (int i = 0; i < 9; ++i)
+        if (scored[i] && score[i] > 0) totalScore += score[i];
+
+    dist.sampled = true;
+    int fallback = (firstEmpty >= 0) ? firstEmpty : 0;
+
+    if (totalScore <= 0.0) {
+        // r == 0: first cell whose cumulative score is >= 0
+        double cumulative = 0.0;
+        for (int i = 0; i < 9; ++i) {
+            if (!scored[i]) continue;
+            cumulative += score[i];
+            if (cumulative >= 0.0) { dist.prob[i] = 1.0; return dist; }
         }
+        dist.prob[fallback] = 1.0;
+        return dist;
     }
 
-    if (chosenMove < 0) {
-        for (int i = 0; i < 9; ++i)
-            if (board.isEmpty(i)) { chosenMove = i; break; }
+    double cumulative = 0.0, covered = 0.0;
+    for (int i = 0; i < 9; ++i) {
+        if (!scored[i]) continue;
+        cumulative += score[i];
+        double hi = std::min(cumulative, totalScore);
+        if (hi > covered) {
+            dist.prob[i] += (hi - covered) / totalScore;
+            covered = hi;
+        }
     }
+    if (covered < totalScore)
+        dist.prob[fallback] += (totalScore - covered) / totalScore;
 
-    auto it = ruleMap.find(chosenMove);
-    if (it != ruleMap.end())
-        rulesUsed = it->second;
-
-    std::cout << "[RulEvolutionPlayer] chose cell " << chosenMove
-        << " (probabilistic selection)\n";
-    return chosenMove;
-}
\ No newline at end of file
+    return dist;
+}
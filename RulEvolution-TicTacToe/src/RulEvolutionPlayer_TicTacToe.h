@@ -4,8 +4,59 @@
 #include "Player_TicTacToe.h"
 #include "LearningState.h"
 #include "RulEvolutionRules.h"   // for RuleType
+#include <array>
+#include <cstdint>
 #include <vector>
 
+class PolicyTable;
+class WeightStore;
+
+/**
+ * @brief Expand a rule bitmask (bit = 1 << RuleType) into rules, in RuleType order.
+ */
+inline void rulesFromMask(unsigned mask, std::vector<RuleType>& rules) {
+    rules.clear();
+    for (int r = RULE_WIN; r <= RULE_PREPARATION; ++r)
+        if (mask & (1u << r)) rules.push_back(static_cast<RuleType>(r));
+}
+
+/**
+ * @struct MoveDistribution
+ * @brief Exact Reflective-Exploration move distribution for one position.
+ *
+ * prob[i] is the probability of choosing cell i; ruleMask[i] has bit
+ * (1 << rule) set for every rule that supported cell i.
+ */
+struct MoveDistribution {
+    std::array<double, 9> prob{};        ///< Probability of each cell
+    std::array<unsigned, 9> ruleMask{};  ///< Rules supporting each cell
+    bool sampled = false;                ///< True if a random draw decides the move
+    bool absoluteWin = false;            ///< True if the absolute WIN rule applies
+
+    /**
+     * @brief Pick a cell from a uniform draw u in [0,1].
+     * @return First cell whose cumulative probability reaches u.
+     */
+    int pick(double u) const {
+        double cumulative = 0.0;
+        int last = -1;
+        for (int i = 0; i < 9; ++i) {
+            if (prob[i] <= 0.0) continue;
+            cumulative += prob[i];
+            last = i;
+            if (u <= cumulative) return i;
+        }
+        return (last >= 0) ? last : 0;
+    }
+
+    /**
+     * @brief Rules that supported a cell, in RuleType order.
+     */
+    void rulesFor(int cell, std::vector<RuleType>& rules) const {
+        rulesFromMask((cell >= 0 && cell < 9) ? ruleMask[cell] : 0u, rules);
+    }
+};
+
 /**
  * @class RulEvolutionPlayer
  * @brief Rule-based player that uses a LearningState to evolve decision-making.
@@ -16,8 +67,10 @@ public:
      * @brief Construct a RulEvolutionPlayer.
      * @param s Symbol ('X' or 'O')
      * @param initState Initial learning state (default: empty)
+     * @param verbose Print initialization and per-move traces (default: true)
      */
-    explicit RulEvolutionPlayer(char s, const LearningState& initState = LearningState());
+    explicit RulEvolutionPlayer(char s, const LearningState& initState = LearningState(),
+        bool verbose = true);
 
     /**
      * @brief Choose a move (standard Player interface)
@@ -34,6 +87,24 @@ public:
      */
     int chooseMove(const Board& board, std::vector<RuleType>& rulesUsed);
 
+    /**
+     * @brief Choose a move and report the rules used as a bitmask (no allocation)
+     * @param board Current board state
+     * @param rulesMask Set to the rules that influenced the decision (bit = 1 << RuleType)
+     * @return Index (08)  of the chosen move
+     */
+    int chooseMove(const Board& board, unsigned& rulesMask);
+
+    /**
+     * @brief Exact move distribution of the RulEvolution policy (no randomness consumed).
+     * @param board Current board state
+     * @param symbol Symbol of the player to move
+     * @param weights Adaptive weights as expected by RulEvolutionRules::evaluate()
+     * @return Probability and supporting rules for every cell
+     */
+    static MoveDistribution distribution(const Board& board, char symbol,
+        const std::vector<double>& weights);
+
     /**
      * @brief Accessor for the internal LearningState (read-only)
      */
@@ -44,8 +115,42 @@ public:
      */
     void setState(const LearningState& newState) { state = newState; }
 
+    /**
+     * @brief Play from a compiled policy table instead of evaluating the rules
+     *        (nullptr restores direct evaluation). The table is not owned and
+     *        positions missing from it fall back to direct evaluation.
+     */
+    void setPolicyTable(const PolicyTable* table) { policyTable = table; }
+
+    /**
+     * @brief Follow live weights: at every match boundary the player adopts
+     *        the newest generation of the store (nullptr stops following).
+     *        A policy table is dropped when the weights change, since it was
+     *        compiled for the old ones.
+     */
+    void follow(const WeightStore* store);
+
+    /**
+     * @brief Adopt a newer generation of the followed store, if any.
+     * @return true if the weights changed.
+     */
+    bool refreshWeights();
+
+    void beginMatch() override { if (liveWeights) refreshWeights(); }
+
+    /**
+     * @brief Copy with the same state, policy table and followed store
+     *        (table and store stay shared, read-only).
+     */
+    std::unique_ptr<Player> clone() const override {
+        return std::unique_ptr<Player>(new RulEvolutionPlayer(*this));
+    }
+
 private:
-    LearningState state;  ///< Current learning weights and parameters
+    LearningState state;                     ///< Current learning weights and parameters
+    const PolicyTable* policyTable = nullptr; ///< Optional compiled policy (inference only)
+    const WeightStore* liveWeights = nullptr; ///< Followed live weights (not owned)
+    std::uint64_t liveGeneration = 0;         ///< Generation of the adopted weights
 };
 
 #endif
\ No newline at end of file
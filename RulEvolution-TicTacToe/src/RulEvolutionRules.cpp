@@ -2,6 +2,8 @@
 //  RulEvolutionRules.cpp    Parallel Version (OpenMP Optional)
 // ================================================================
 #include "RulEvolutionRules.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include <iostream>
 
 #ifdef USE_OMP
@@ -17,20 +19,33 @@ bool RulEvolutionRules::isWinningMove(const Board& board, int idx, char symbol)
 std::vector<RuleEvaluation> RulEvolutionRules::evaluate(
     const Board& board, char playerSymbol, const std::vector<double>& weights
 ) {
-    std::vector<RuleEvaluation> results;
+    RuleEvaluationList results;
+    evaluate(board, playerSymbol, weights, results);
+    return std::vector<RuleEvaluation>(results.begin(), results.end());
+}
+
+void RulEvolutionRules::evaluate(
+    const Board& board, char playerSymbol, const std::vector<double>& weights,
+    RuleEvaluationList& results
+) {
+    Metrics::add(METRIC_RULE_EVALUATIONS);
+    TraceSpan span(TRACE_RULES);
+    results.clear();
     char opponent = (playerSymbol == 'X') ? 'O' : 'X';
 
     const int expectedRules = 5;
     if ((int)weights.size() < expectedRules) {
         std::cout << "[ERROR] evaluate(): weights vector too small! size="
             << weights.size() << ", expected at least " << expectedRules << "\n";
-        return results;
+        return;
     }
+    results.reserve(27);  // at most BLOCK, one position rule and PREPARATION per cell
 
 #ifdef USE_OMP
 #pragma omp parallel
     {
-        std::vector<RuleEvaluation> localResults; // thread-local buffer
+        RuleEvaluationList localResults; // thread-local buffer (the thread's own arena)
+        localResults.reserve(27);
 
 #pragma omp for nowait
         for (int i = 0; i < 9; i++) {
@@ -161,6 +176,4 @@ std::vector<RuleEvaluation> RulEvolutionRules::evaluate(
         }
     }
 #endif
-
-    return results;
 }
\ No newline at end of file
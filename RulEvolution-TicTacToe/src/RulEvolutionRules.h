@@ -3,6 +3,7 @@
 
 #include "Board_TicTacToe.h"
 #include "RuleType.h"   // Include the enum and ruleToString definition
+#include "MatchArena.h"
 #include <vector>
 #include <string>
 
@@ -16,6 +17,9 @@ struct RuleEvaluation {
     double score;        // Weighted score from that rule
 };
 
+/// Rule suggestions stored in the calling thread's MatchArena (heap if none is bound).
+typedef std::vector<RuleEvaluation, ArenaAllocator<RuleEvaluation>> RuleEvaluationList;
+
 /**
  * @class RulEvolutionRules
  * @brief Collection of RulEvolution rules for Tic-Tac-Toe.
@@ -28,6 +32,14 @@ public:
         const std::vector<double>& weights
     );
 
+    /// evaluate() into a caller-provided list (cleared first); no heap use under an arena.
+    static void evaluate(
+        const Board& board,
+        char playerSymbol,
+        const std::vector<double>& weights,
+        RuleEvaluationList& results
+    );
+
 private:
     static bool isWinningMove(const Board& board, int idx, char symbol);
 };
@@ -13,7 +13,8 @@ enum RuleType {
     RULE_CENTER,           // Center preference
     RULE_CORNER,           // Corner preference
     RULE_SIDE,             // Side preference
-    RULE_PREPARATION       // Preparing a future winning configuration
+    RULE_PREPARATION,      // Preparing a future winning configuration
+    RULE_COUNT             // Number of rules (not a rule)
 };
 
 /**
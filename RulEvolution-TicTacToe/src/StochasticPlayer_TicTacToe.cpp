@@ -1,6 +1,6 @@
 #include "StochasticPlayer_TicTacToe.h"
+#include "Random.h"
 #include <cstdlib>
-#include <vector>
 #include <iostream>
 
 /**
@@ -8,16 +8,18 @@
  * @brief Choose a random valid move from available cells.
  */
 int StochasticPlayer::chooseMove(const Board& board) {
-    std::vector<int> available;
+    int available[9];  // at most 9 empty cells: no allocation per move
+    int count = 0;
     for (int i = 0; i < 9; i++) {
-        if (board.isEmpty(i)) available.push_back(i);
+        if (board.isEmpty(i)) available[count++] = i;
     }
-    if (available.empty()) return 0;
+    if (count == 0) return 0;
 
-    int r = std::rand() % available.size();
+    int r = Random::below(count);
     int move = available[r];
 
-    std::cout << "[StochasticPlayer] chose move " << move << "\n";
+    if (verbose)
+        std::cout << "[StochasticPlayer] chose move " << move << "\n";
 
     return move;
 }
\ No newline at end of file
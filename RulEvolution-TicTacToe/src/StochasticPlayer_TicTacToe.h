@@ -11,6 +11,7 @@ class StochasticPlayer : public Player {
 public:
     explicit StochasticPlayer(char s) : Player(s) {}
     int chooseMove(const Board& board) override;
+    std::unique_ptr<Player> clone() const override { return std::unique_ptr<Player>(new StochasticPlayer(*this)); }
 };
 
 #endif // STOCHASTICPLAYER_TICTACTOE_H
\ No newline at end of file
@@ -0,0 +1,666 @@
+// ================================================================
+//  SuggestionServer.cpp — Move-suggestion daemon and load generator
+//  Notes:
+//    - POSIX only (Unix domain sockets); elsewhere open() and the load
+//      generator report an error;
+//    - workers never share a connection: accept, parse, policy lookup
+//      and write of a request all happen on one thread, and the only
+//      lock is taken once per batch to publish the counters;
+//    - latency is measured from the read() that delivered a request to
+//      the end of the write() that carried its answer.
+// ================================================================
+#include "SuggestionServer.h"
+#include "Board_TicTacToe.h"
+#include "LearningState.h"
+#include "PolicyTable.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include "WeightStore.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+unsigned long long nanosBetween(Clock::time_point from, Clock::time_point to) {
+    return static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+} // namespace
+
+// --- Latency histogram ------------------------------------------------------
+
+int LatencyHistogram::bucket(unsigned long long nanos) {
+    if (nanos < LATENCY_SUB_BUCKETS) return static_cast<int>(nanos);
+    int e = 63;
+    while (!(nanos >> e)) --e;  // e >= 4
+    int sub = static_cast<int>((nanos >> (e - 4)) & (LATENCY_SUB_BUCKETS - 1));
+    return (e - 3) * LATENCY_SUB_BUCKETS + sub;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < LATENCY_HISTOGRAM_SIZE; ++i) counts[i] += other.counts[i];
+}
+
+unsigned long long LatencyHistogram::total() const {
+    unsigned long long n = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_SIZE; ++i) n += counts[i];
+    return n;
+}
+
+double LatencyHistogram::quantile(double q) const {
+    unsigned long long n = total();
+    if (n == 0) return 0.0;
+    unsigned long long rank = static_cast<unsigned long long>(q * (n - 1)) + 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_SIZE; ++i) {
+        seen += counts[i];
+        if (seen < rank) continue;
+        if (i < LATENCY_SUB_BUCKETS) return static_cast<double>(i);
+        int e = i / LATENCY_SUB_BUCKETS + 3;
+        double width = static_cast<double>(1ULL << (e - 4));
+        return (LATENCY_SUB_BUCKETS + i % LATENCY_SUB_BUCKETS + 0.5) * width;
+    }
+    return 0.0;
+}
+
+void SuggestionServer::writeJson(std::ostream& out, const SuggestionStats& s) {
+    std::ostringstream oss;
+    oss << "{\"serve\":{\"requests\":" << s.requests
+        << ",\"errors\":" << s.errors
+        << ",\"batches\":" << s.batches
+        << ",\"meanBatch\":" << (s.batches ? static_cast<double>(s.requests) / s.batches : 0.0)
+        << ",\"connections\":" << s.connections
+        << ",\"generation\":" << s.generation
+        << ",\"p50Micros\":" << s.p50Micros
+        << ",\"p99Micros\":" << s.p99Micros
+        << ",\"elapsedSeconds\":" << s.elapsedSeconds
+        << ",\"requestsPerSec\":" << (s.elapsedSeconds > 0.0 ? s.requests / s.elapsedSeconds : 0.0)
+        << "}}\n";
+    out << oss.str();
+}
+
+void SuggestionLoadGenerator::writeJson(std::ostream& out, const LoadGeneratorConfig& config,
+    const LoadGeneratorResult& r) {
+    std::ostringstream oss;
+    oss << "{\"loadgen\":{\"connections\":" << config.connections
+        << ",\"pipeline\":" << config.pipeline
+        << ",\"seeded\":" << (config.seeded ? "true" : "false")
+        << ",\"requests\":" << r.requests
+        << ",\"errors\":" << r.errors
+        << ",\"elapsedSeconds\":" << r.elapsedSeconds
+        << ",\"requestsPerSec\":" << r.requestsPerSec
+        << ",\"p50Micros\":" << r.p50Micros
+        << ",\"p99Micros\":" << r.p99Micros
+        << "}}\n";
+    out << oss.str();
+}
+
+/// Per-thread state of the daemon; the counters are published once per batch.
+struct SuggestionServer::Worker {
+    std::thread thread;
+    std::uint64_t seed = 0;  ///< Stream of the unseeded requests
+    PolicyTable table;       ///< Compiled for the worker's current weights
+    std::mutex lock;         ///< Guards the counters below
+    long long requests = 0, errors = 0, batches = 0;
+    std::uint64_t generation = 0;
+    LatencyHistogram latency;
+};
+
+SuggestionServer::SuggestionServer(const SuggestionConfig& cfg)
+    : config(cfg) {
+    if (config.maxBatch < 1) config.maxBatch = 1;
+    if (config.latencyMicros < 0) config.latencyMicros = 0;
+}
+
+SuggestionStats SuggestionServer::stats() const {
+    SuggestionStats s;
+    LatencyHistogram merged;
+    for (const std::unique_ptr<Worker>& w : workers) {
+        std::lock_guard<std::mutex> guard(w->lock);
+        s.requests += w->requests;
+        s.errors += w->errors;
+        s.batches += w->batches;
+        s.generation = std::max(s.generation, w->generation);
+        merged.merge(w->latency);
+    }
+    s.connections = accepted.load();
+    s.p50Micros = merged.quantile(0.50) * 1e-3;
+    s.p99Micros = merged.quantile(0.99) * 1e-3;
+    s.elapsedSeconds = std::chrono::duration<double>(Clock::now().time_since_epoch()).count() - startTime;
+    return s;
+}
+
+#ifndef _WIN32
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL;  // a vanished peer is an error, not SIGPIPE
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+const std::size_t MAX_LINE = 256;       ///< Longer partial lines close the connection
+const long long IDLE_WAIT_MICROS = 100000;  ///< Stop-flag polling period when idle
+
+volatile std::sig_atomic_t signalled = 0;
+void onSignal(int) { signalled = 1; }
+
+enum RequestKind { REQUEST_SUGGEST, REQUEST_STATS, REQUEST_SHUTDOWN, REQUEST_OVER, REQUEST_BAD };
+
+struct Request {
+    int connection = 0;
+    RequestKind kind = REQUEST_BAD;
+    char cells[9];
+    char side = 'X';
+    bool seeded = false;
+    std::uint64_t seed = 0;
+    Clock::time_point arrival;
+};
+
+struct Connection {
+    int fd = -1;
+    std::string in;
+    std::string out;
+    bool closed = false;  ///< Peer gone: drop it once no request of it is pending
+};
+
+void parseRequest(const char* p, std::size_t n, Request& r) {
+    if (n > 0 && p[n - 1] == '\r') --n;
+    if (n == 5 && std::memcmp(p, "STATS", 5) == 0) { r.kind = REQUEST_STATS; return; }
+    if (n == 8 && std::memcmp(p, "SHUTDOWN", 8) == 0) { r.kind = REQUEST_SHUTDOWN; return; }
+    r.kind = REQUEST_BAD;
+    if (n < 11 || p[9] != ' ') return;
+
+    Board board;
+    for (int i = 0; i < 9; ++i) {
+        char c = p[i];
+        if (c == 'X' || c == 'x') r.cells[i] = 'X';
+        else if (c == 'O' || c == 'o') r.cells[i] = 'O';
+        else if (c == '.' || c == '-' || c == '_') r.cells[i] = ' ';
+        else return;
+        if (r.cells[i] != ' ') board.place(i, r.cells[i]);
+    }
+    char side = p[10];
+    if (side == 'x' || side == 'o') side = static_cast<char>(side - 'a' + 'A');
+    if (side != 'X' && side != 'O') return;
+    r.side = side;
+
+    r.seeded = false;
+    if (n > 11) {
+        if (p[11] != ' ' || n == 12) return;
+        std::uint64_t seed = 0;
+        for (std::size_t i = 12; i < n; ++i) {
+            if (p[i] < '0' || p[i] > '9') return;
+            seed = seed * 10 + static_cast<std::uint64_t>(p[i] - '0');
+        }
+        r.seeded = true;
+        r.seed = seed;
+    }
+    r.kind = (board.winner() != ' ' || board.isFull()) ? REQUEST_OVER : REQUEST_SUGGEST;
+}
+
+void appendAnswer(std::string& out, int move, unsigned mask) {
+    out += static_cast<char>('0' + move);
+    out += ' ';
+    if (!mask) out += '-';
+    bool first = true;
+    for (int r = RULE_WIN; r < RULE_COUNT; ++r) {
+        if (!(mask & (1u << r))) continue;
+        if (!first) out += ',';
+        out += static_cast<char>('0' + r);
+        first = false;
+    }
+    out += '\n';
+}
+
+/// Write as much of `out` as the socket takes; false on a hard error.
+bool flush(Connection& c) {
+    std::size_t sent = 0;
+    while (sent < c.out.size()) {
+        ssize_t n = ::send(c.fd, c.out.data() + sent, c.out.size() - sent, SEND_FLAGS);
+        if (n > 0) { sent += static_cast<std::size_t>(n); continue; }
+        if (n < 0 && errno == EINTR) continue;
+        bool wouldBlock = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        c.out.erase(0, sent);
+        if (!wouldBlock) { c.out.clear(); c.closed = true; return false; }
+        return true;
+    }
+    c.out.clear();
+    return true;
+}
+
+/// poll() with a microsecond timeout where the platform has one.
+int waitFor(std::vector<pollfd>& fds, long long micros) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(micros / 1000000);
+    ts.tv_nsec = static_cast<long>((micros % 1000000) * 1000);
+    return ::ppoll(fds.data(), fds.size(), &ts, nullptr);
+#else
+    return ::poll(fds.data(), fds.size(), static_cast<int>((micros + 999) / 1000));
+#endif
+}
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+bool makeAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+} // namespace
+
+SuggestionServer::~SuggestionServer() {
+    stop();
+    for (std::unique_ptr<Worker>& w : workers)
+        if (w->thread.joinable()) w->thread.join();
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(config.socketPath.c_str());
+    }
+}
+
+bool SuggestionServer::open(const std::vector<double>& w) {
+    sockaddr_un addr;
+    if (!makeAddress(config.socketPath, addr)) {
+        std::cerr << "[ERROR] Invalid socket path: " << config.socketPath << "\n";
+        return false;
+    }
+
+    // Replace a stale socket left by a previous daemon, never a regular file.
+    struct stat st;
+    if (::stat(config.socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "[ERROR] " << config.socketPath << " exists and is not a socket\n";
+            return false;
+        }
+        ::unlink(config.socketPath.c_str());
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(listenFd, SOMAXCONN) != 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "[ERROR] Cannot listen on " << config.socketPath << ": " << std::strerror(errno) << "\n";
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    weights = w;
+    std::uint64_t generation = live ? live->read(weights) : 0;
+
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    workers.clear();
+    for (int i = 0; i < std::max(1, threads); ++i) {
+        workers.emplace_back(new Worker());
+        workers.back()->seed = Random::next();
+        workers.back()->table.compile(weights);
+        workers.back()->generation = generation;
+    }
+    startTime = std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+    std::cerr << "[INFO] Serving suggestions on " << config.socketPath << " ("
+        << workers.size() << " threads, batch " << config.maxBatch << ", "
+        << config.latencyMicros << " us cap" << (live ? ", live weights" : "") << ")\n";
+    return true;
+}
+
+SuggestionStats SuggestionServer::serve() {
+    if (listenFd < 0) return stats();
+
+    signalled = 0;
+    void (*previousInt)(int) = std::signal(SIGINT, onSignal);
+    void (*previousTerm)(int) = std::signal(SIGTERM, onSignal);
+
+    const ThreadContext context = ThreadContext::current();
+    for (std::unique_ptr<Worker>& w : workers) {
+        Worker* worker = w.get();
+        worker->thread = std::thread([this, worker, context]() {
+            ContextBinding bindContext(context);  // the serving engine's metrics and trace
+            work(*worker);
+        });
+    }
+    for (std::unique_ptr<Worker>& w : workers) w->thread.join();
+
+    std::signal(SIGINT, previousInt);
+    std::signal(SIGTERM, previousTerm);
+    ::close(listenFd);
+    ::unlink(config.socketPath.c_str());
+    listenFd = -1;
+    return stats();
+}
+
+void SuggestionServer::work(Worker& worker) {
+#ifdef __linux__
+    // The default 50 us timer slack would double the batching cap.
+    ::prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+    RandomSource random(worker.seed);
+    RandomBinding bindRandom(random);
+    LearningState state;
+    state.weights = weights;
+    RulEvolutionPlayer playerX('X', state, false), playerO('O', state, false);
+    playerX.setPolicyTable(&worker.table);
+    playerO.setPolicyTable(&worker.table);
+    std::uint64_t generation = worker.generation;
+
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds;
+    std::vector<Request> batch;
+    Clock::time_point batchStart;
+    const long long cap = config.latencyMicros;
+    std::vector<char> buffer(1 << 16);
+
+    auto answer = [&]() {
+        // Batch boundary: adopt a newly published generation.
+        if (live && live->refresh(state.weights, generation)) {
+            worker.table.update(state.weights);
+            playerX.setState(state);
+            playerO.setState(state);
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.generation = generation;
+        }
+
+        long long errors = 0;
+        for (const Request& r : batch) {
+            std::string& out = connections[r.connection].out;
+            switch (r.kind) {
+            case REQUEST_SUGGEST: {
+                Board board;
+                for (int i = 0; i < 9; ++i)
+                    if (r.cells[i] != ' ') board.place(i, r.cells[i]);
+                RulEvolutionPlayer& player = (r.side == 'X') ? playerX : playerO;
+                unsigned mask = 0;
+                int move;
+                if (r.seeded) {
+                    RandomMatchStream stream(r.seed, 0);
+                    move = player.chooseMove(board, mask);
+                }
+                else {
+                    move = player.chooseMove(board, mask);
+                }
+                appendAnswer(out, move, mask);
+                break;
+            }
+            case REQUEST_STATS: {
+                std::ostringstream line;
+                writeJson(line, stats());
+                out += line.str();
+                break;
+            }
+            case REQUEST_SHUTDOWN:
+                out += "OK\n";
+                stop();
+                break;
+            case REQUEST_OVER:
+                out += "ERR game over\n";
+                ++errors;
+                break;
+            default:
+                out += "ERR bad request\n";
+                ++errors;
+                break;
+            }
+        }
+        for (Connection& c : connections)
+            if (!c.out.empty() && !c.closed) flush(c);
+
+        Clock::time_point done = Clock::now();
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.requests += static_cast<long long>(batch.size());
+        worker.errors += errors;
+        ++worker.batches;
+        for (const Request& r : batch) worker.latency.record(nanosBetween(r.arrival, done));
+        batch.clear();
+    };
+
+    while (!stopping.load(std::memory_order_relaxed) && !signalled) {
+        fds.clear();
+        pollfd listen = { listenFd, POLLIN, 0 };
+        fds.push_back(listen);
+        for (const Connection& c : connections) {
+            short events = c.closed ? 0 : static_cast<short>(POLLIN | (c.out.empty() ? 0 : POLLOUT));
+            pollfd p = { c.fd, events, 0 };
+            fds.push_back(p);
+        }
+
+        long long wait = IDLE_WAIT_MICROS;
+        if (!batch.empty()) {
+            long long waited = static_cast<long long>(nanosBetween(batchStart, Clock::now()) / 1000);
+            wait = std::max(0LL, cap - waited);
+        }
+        if (waitFor(fds, wait) < 0 && errno != EINTR) break;
+
+        if (fds[0].revents & POLLIN) {
+            // Every worker polls the listening socket; the losers get EAGAIN.
+            for (;;) {
+                int fd = ::accept(listenFd, nullptr, nullptr);
+                if (fd < 0) break;
+                setNonBlocking(fd);
+                Connection c;
+                c.fd = fd;
+                connections.push_back(c);
+                accepted.fetch_add(1);
+            }
+        }
+
+        for (std::size_t i = 0; i + 1 < fds.size(); ++i) {
+            Connection& c = connections[i];
+            short events = fds[i + 1].revents;
+            if (events & POLLOUT) flush(c);
+            if (!(events & (POLLIN | POLLHUP | POLLERR)) || c.closed) continue;
+
+            ssize_t n = ::recv(c.fd, buffer.data(), buffer.size(), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                c.closed = true;
+                continue;
+            }
+            if (n < 0) continue;
+
+            Clock::time_point arrival = Clock::now();
+            c.in.append(buffer.data(), static_cast<std::size_t>(n));
+            std::size_t start = 0, end;
+            while ((end = c.in.find('\n', start)) != std::string::npos) {
+                if (batch.empty()) batchStart = arrival;
+                batch.emplace_back();
+                Request& r = batch.back();
+                r.connection = static_cast<int>(i);
+                r.arrival = arrival;
+                parseRequest(c.in.data() + start, end - start, r);
+                start = end + 1;
+            }
+            c.in.erase(0, start);
+            if (c.in.size() > MAX_LINE) c.closed = true;
+        }
+
+        if (!batch.empty() && (static_cast<int>(batch.size()) >= config.maxBatch
+            || static_cast<long long>(nanosBetween(batchStart, Clock::now()) / 1000) >= cap))
+            answer();
+
+        // Connection indices are only stable while no request refers to them.
+        if (batch.empty()) {
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < connections.size(); ++i) {
+                if (connections[i].closed) { ::close(connections[i].fd); continue; }
+                if (kept != i) connections[kept] = std::move(connections[i]);
+                ++kept;
+            }
+            connections.resize(kept);
+        }
+    }
+
+    if (!batch.empty()) answer();
+    for (Connection& c : connections) {
+        if (!c.closed && !c.out.empty()) {
+            // Best effort for the last answers (e.g. the "OK" of SHUTDOWN).
+            int flags = ::fcntl(c.fd, F_GETFL, 0);
+            ::fcntl(c.fd, F_SETFL, flags & ~O_NONBLOCK);
+            flush(c);
+        }
+        ::close(c.fd);
+    }
+}
+
+bool SuggestionLoadGenerator::run(const LoadGeneratorConfig& config, LoadGeneratorResult& result) {
+    result = LoadGeneratorResult();
+    sockaddr_un addr;
+    if (!makeAddress(config.socketPath, addr) || config.requests <= 0 || config.connections <= 0
+        || config.pipeline <= 0) {
+        std::cerr << "[ERROR] Invalid load generator settings\n";
+        return false;
+    }
+
+    // Pool of random positions that are still in play, side to move included.
+    const int POOL = 4096;
+    std::vector<std::string> pool;
+    while (static_cast<int>(pool.size()) < POOL) {
+        Board board;
+        char side = 'X';
+        int moves = Random::below(8);
+        for (int m = 0; m < moves && board.winner() == ' '; ++m) {
+            int cell;
+            do cell = Random::below(9); while (!board.isEmpty(cell));
+            board.place(cell, side);
+            side = (side == 'X') ? 'O' : 'X';
+        }
+        if (board.winner() != ' ' || board.isFull()) continue;
+        std::string line(9, '.');
+        for (int i = 0; i < 9; ++i)
+            if (!board.isEmpty(i)) line[i] = board.at(i);
+        line += ' ';
+        line += side;
+        if (config.seeded) line += ' ' + std::to_string(pool.size());
+        line += '\n';
+        pool.push_back(line);
+    }
+
+    std::mutex lock;
+    LatencyHistogram latency;
+    std::atomic<bool> failed{ false };
+    std::vector<std::thread> clients;
+    Clock::time_point start = Clock::now();
+
+    for (int t = 0; t < config.connections; ++t) {
+        long long quota = config.requests * (t + 1) / config.connections - config.requests * t / config.connections;
+        clients.emplace_back([&, t, quota]() {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+                std::cerr << "[ERROR] Cannot connect to " << config.socketPath << ": " << std::strerror(errno) << "\n";
+                if (fd >= 0) ::close(fd);
+                failed = true;
+                return;
+            }
+            LatencyHistogram local;
+            long long errors = 0, sent = 0, received = 0;
+            std::vector<Clock::time_point> sentAt(static_cast<std::size_t>(config.pipeline));
+            std::string out;
+            std::vector<char> buffer(1 << 16);
+            bool lineStart = true;
+
+            while (received < quota && !failed) {
+                out.clear();
+                Clock::time_point now = Clock::now();
+                while (sent < quota && sent - received < config.pipeline) {
+                    out += pool[static_cast<std::size_t>((sent * config.connections + t) % POOL)];
+                    sentAt[static_cast<std::size_t>(sent % config.pipeline)] = now;
+                    ++sent;
+                }
+                std::size_t written = 0;
+                while (written < out.size()) {
+                    ssize_t n = ::send(fd, out.data() + written, out.size() - written, SEND_FLAGS);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) { failed = true; break; }
+                    written += static_cast<std::size_t>(n);
+                }
+                if (failed) break;
+
+                ssize_t n = ::recv(fd, buffer.data(), buffer.size(), 0);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) { failed = true; break; }
+                now = Clock::now();
+                for (ssize_t i = 0; i < n; ++i) {
+                    char c = buffer[static_cast<std::size_t>(i)];
+                    if (lineStart && c == 'E') ++errors;
+                    lineStart = (c == '\n');
+                    if (c == '\n') {
+                        local.record(nanosBetween(sentAt[static_cast<std::size_t>(received % config.pipeline)], now));
+                        ++received;
+                    }
+                }
+            }
+            ::close(fd);
+
+            std::lock_guard<std::mutex> guard(lock);
+            latency.merge(local);
+            result.requests += received;
+            result.errors += errors;
+        });
+    }
+    for (std::thread& c : clients) c.join();
+
+    result.elapsedSeconds = secondsSince(start);
+    result.requestsPerSec = result.elapsedSeconds > 0.0 ? result.requests / result.elapsedSeconds : 0.0;
+    result.p50Micros = latency.quantile(0.50) * 1e-3;
+    result.p99Micros = latency.quantile(0.99) * 1e-3;
+    if (failed) std::cerr << "[ERROR] Load generator stopped early: connection lost\n";
+    return !failed;
+}
+
+#else // _WIN32
+
+SuggestionServer::~SuggestionServer() {
+}
+
+bool SuggestionServer::open(const std::vector<double>&) {
+    std::cerr << "[ERROR] The suggestion daemon needs Unix domain sockets (POSIX only)\n";
+    return false;
+}
+
+SuggestionStats SuggestionServer::serve() {
+    return stats();
+}
+
+void SuggestionServer::work(Worker&) {
+}
+
+bool SuggestionLoadGenerator::run(const LoadGeneratorConfig&, LoadGeneratorResult& result) {
+    result = LoadGeneratorResult();
+    std::cerr << "[ERROR] The load generator needs Unix domain sockets (POSIX only)\n";
+    return false;
+}
+
+#endif // _WIN32
@@ -0,0 +1,167 @@
+#ifndef SUGGESTIONSERVER_H
+#define SUGGESTIONSERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class WeightStore;
+
+const int LATENCY_SUB_BUCKETS = 16;                       ///< Linear sub-buckets per power of two
+const int LATENCY_HISTOGRAM_SIZE = 64 * LATENCY_SUB_BUCKETS;
+
+/**
+ * @struct LatencyHistogram
+ * @brief Log-linear nanosecond histogram (16 sub-buckets per power of two,
+ *        about 6% resolution) for latency quantiles.
+ */
+struct LatencyHistogram {
+    unsigned long long counts[LATENCY_HISTOGRAM_SIZE] = {};
+
+    void record(unsigned long long nanos) { ++counts[bucket(nanos)]; }
+    void merge(const LatencyHistogram& other);
+    unsigned long long total() const;
+
+    /// Midpoint (ns) of the bucket holding quantile q in [0, 1]; 0 if empty.
+    double quantile(double q) const;
+
+    static int bucket(unsigned long long nanos);
+};
+
+/**
+ * @struct SuggestionConfig
+ * @brief Settings of the move-suggestion daemon.
+ */
+struct SuggestionConfig {
+    std::string socketPath;   ///< Unix domain socket (replaced if it exists)
+    int threads = 0;          ///< Worker threads (0 = hardware concurrency)
+    int maxBatch = 256;       ///< A micro-batch is answered once it holds this many requests
+    int latencyMicros = 50;   ///< ... or once its oldest request waited this long
+};
+
+/**
+ * @struct SuggestionStats
+ * @brief Counters and server-side latency (read to write) since open().
+ */
+struct SuggestionStats {
+    long long requests = 0;     ///< Lines answered (suggestions, errors and commands)
+    long long errors = 0;       ///< Malformed requests and finished games
+    long long batches = 0;      ///< Micro-batches answered
+    long long connections = 0;  ///< Connections accepted
+    std::uint64_t generation = 0;  ///< Newest live-weight generation adopted (0 = static weights)
+    double p50Micros = 0.0;
+    double p99Micros = 0.0;
+    double elapsedSeconds = 0.0;
+};
+
+/**
+ * @class SuggestionServer
+ * @brief Long-lived daemon answering "best move for this board" over a
+ *        Unix domain socket with the RulEvolution policy.
+ *
+ * Line protocol, any number of requests in flight per connection (answers
+ * come back in request order):
+ *
+ *     <board> <side> [seed]   ->  <move> <rules>     e.g. "X...O.... X 7" -> "2 3"
+ *     STATS                   ->  one JSON line (SuggestionStats)
+ *     SHUTDOWN                ->  "OK", then the daemon stops
+ *
+ * The board lists cells 0..8 as X, O or '.'; rules are the ids (RuleType)
+ * of the rules that fired, comma-separated, or '-'. A request with a seed
+ * always gets the same answer; without one the move is drawn from the
+ * engine's random stream. Errors are answered "ERR <reason>".
+ *
+ * Each worker thread accepts on the shared socket and serves its own
+ * connections: requests read from all of them gather into one micro-batch,
+ * answered from the worker's compiled PolicyTable, with one write per
+ * connection per batch. A server following a WeightStore checks it before
+ * every batch and updates its tables when a new generation is published.
+ */
+class SuggestionServer {
+public:
+    explicit SuggestionServer(const SuggestionConfig& config);
+    ~SuggestionServer();
+    SuggestionServer(const SuggestionServer&) = delete;
+    SuggestionServer& operator=(const SuggestionServer&) = delete;
+
+    /**
+     * @brief Compile the policy for a weight vector and listen on the socket.
+     * @return false (with a message on std::cerr) if the socket cannot be bound.
+     */
+    bool open(const std::vector<double>& weights);
+
+    /**
+     * @brief Follow live weights (call before open(); nullptr = static weights).
+     *        The store's current generation, if any, replaces the weights
+     *        given to open().
+     */
+    void follow(const WeightStore* store) { live = store; }
+
+    /// Serve until a SHUTDOWN request, SIGINT/SIGTERM or stop(); closes the socket.
+    SuggestionStats serve();
+
+    /// Ask serve() to return (any thread).
+    void stop() { stopping.store(true); }
+
+    /// Current counters (any thread).
+    SuggestionStats stats() const;
+
+    static void writeJson(std::ostream& out, const SuggestionStats& stats);
+
+private:
+    struct Worker;
+    void work(Worker& worker);
+
+    SuggestionConfig config;
+    std::vector<double> weights;    ///< Weights the workers start from
+    const WeightStore* live = nullptr;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping{ false };
+    std::atomic<long long> accepted{ 0 };
+    int listenFd = -1;
+    double startTime = 0.0;
+};
+
+/**
+ * @struct LoadGeneratorConfig
+ * @brief Settings of the bundled load generator.
+ */
+struct LoadGeneratorConfig {
+    std::string socketPath;
+    long long requests = 1000000;  ///< Total requests over all connections
+    int connections = 4;           ///< Client threads, one connection each
+    int pipeline = 64;             ///< Requests in flight per connection
+    bool seeded = false;           ///< Send a seed with every request
+};
+
+/**
+ * @struct LoadGeneratorResult
+ * @brief Throughput and client-side round-trip latency.
+ */
+struct LoadGeneratorResult {
+    long long requests = 0;
+    long long errors = 0;          ///< "ERR" answers
+    double elapsedSeconds = 0.0;
+    double requestsPerSec = 0.0;
+    double p50Micros = 0.0;
+    double p99Micros = 0.0;
+};
+
+/**
+ * @class SuggestionLoadGenerator
+ * @brief Local client that floods a SuggestionServer with random legal
+ *        positions, keeping `pipeline` requests in flight per connection.
+ */
+class SuggestionLoadGenerator {
+public:
+    /// @return false if a connection fails or the server closes early.
+    static bool run(const LoadGeneratorConfig& config, LoadGeneratorResult& result);
+
+    static void writeJson(std::ostream& out, const LoadGeneratorConfig& config,
+        const LoadGeneratorResult& result);
+};
+
+#endif // SUGGESTIONSERVER_H
@@ -0,0 +1,179 @@
+// ================================================================
+//  SuperTraining.cpp — Parallel Super-Training batch (OpenMP Optional)
+//  Notes:
+//    - matches are split into contiguous blocks, one per worker; each
+//      worker learns on its own LearningModule copy, in match order;
+//    - a MergeStrategy folds the worker learners back into the learner,
+//      so merge cost depends on the worker count, not the match count;
+//    - each worker plays with its own player clones (PlayerPool) and keeps
+//      the scratch state of a match in its own MatchArena, reset per match;
+//    - trajectory samples are numbered by the match index of the batch, so
+//      each worker's samples cover its own block of steps.
+// ================================================================
+#include "SuperTraining.h"
+#include "Game_TicTacToe.h"
+#include "StochasticPlayer_TicTacToe.h"
+#include "RulEvolutionPlayer_TicTacToe.h"
+#include "Metrics.h"
+#include "MergeStrategy.h"
+#include "GameLog.h"
+#include "TrainingAnalytics.h"
+#include "Trajectory.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include "PlayerPool.h"
+#include "MatchArena.h"
+#include "Trace.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <ctime>
+#include <algorithm>
+#include <memory>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+SuperTrainingResult SuperTraining::run(LearningModule& learner, int scenario,
+    int numMatches, bool verbose, const MergeStrategy* merge, int workers, GameLog* log,
+    TrainingAnalytics* analytics, Trajectory* trajectory) {
+    SuperTrainingResult result;
+    if (numMatches <= 0) return result;
+    if (!merge) merge = &MergeStrategy::defaultStrategy();
+
+    if (workers <= 0) {
+        workers = 1;
+#ifdef USE_OMP
+        workers = omp_get_max_threads();
+#endif
+    }
+    workers = std::min(workers, numMatches);
+
+    std::unique_ptr<Player> pX, pO;
+
+    if (scenario == 1) {
+        pX.reset(new StochasticPlayer('X'));
+        pO.reset(new RulEvolutionPlayer('O', LearningState(), verbose));
+    }
+    else {
+        pX.reset(new RulEvolutionPlayer('X', LearningState(), verbose));
+        pO.reset(new RulEvolutionPlayer('O', LearningState(), verbose));
+    }
+    pX->setVerbose(verbose);
+    PlayerPool players(*pX, *pO, workers);
+
+#ifdef USE_OMP
+    double startTime = omp_get_wtime();
+#else
+    auto startTime = std::clock();
+#endif
+
+    // Workers learn on copies of this snapshot; the merge starts again from it
+    // so strategies see a fixed base.
+    const LearningModule start = learner;
+    std::vector<LearningModule> learners(workers, start);
+    int winsX = 0, winsO = 0, draws = 0;
+
+    std::vector<AnalyticsShard*> shards;
+    if (analytics) shards = analytics->shards(workers);
+    const char learnerSide = (scenario == 1) ? 'O' : 'X';
+    const ThreadContext context = ThreadContext::current();
+
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static, 1) reduction(+:winsX,winsO,draws)
+#endif
+    for (int w = 0; w < workers; ++w) {
+        ContextBinding bindContext(context);
+        TraceSpan workerSpan(TRACE_WORKER, static_cast<std::uint32_t>(w));
+        MatchArena arena;
+        ArenaBinding bindArena(arena);
+        Player& x = players.x(w);
+        Player& o = players.o(w);
+        int begin = static_cast<int>(static_cast<long long>(numMatches) * w / workers);
+        int end = static_cast<int>(static_cast<long long>(numMatches) * (w + 1) / workers);
+        std::unique_ptr<GameLogWriter> writer(log ? new GameLogWriter(*log) : nullptr);
+        std::unique_ptr<TrajectoryWriter> samples(
+            trajectory ? new TrajectoryWriter(*trajectory, static_cast<std::uint32_t>(w)) : nullptr);
+        AnalyticsTotals totals;
+        if (analytics) totals = shards[w]->read();
+
+        for (int i = begin; i < end; ++i) {
+            Game g(&x, &o);
+            GameHistory history;
+            char winner = g.playAndLearn(history, false);
+            arena.reset();
+            bool rulevWon = (winner == 'X' || winner == 'O');
+            learners[w].updateFromGame(history, rulevWon);
+            if (writer) {
+                history.setResult(rulevWon);
+                writer->append(history);
+            }
+            if (samples && (i + 1) % trajectory->interval() == 0)
+                samples->sample(learners[w], trajectory->step() + static_cast<std::uint64_t>(i + 1));
+            if (analytics) {
+                totals.record(history, learnerSide);
+                if ((i - begin + 1) % TrainingAnalytics::PUBLISH_EVERY == 0 || i + 1 == end) {
+                    totals.sampleWeights(learners[w]);
+                    shards[w]->publish(totals);
+                }
+            }
+
+            if (winner == 'X') winsX++;
+            else if (winner == 'O') winsO++;
+            else draws++;
+
+            if (verbose) {
+                int tid = 0;
+#ifdef USE_OMP
+                tid = omp_get_thread_num();
+#endif
+                // The span includes the wait for the lock: a serialization point.
+                TraceSpan printSpan(TRACE_CONSOLE);
+#ifdef USE_OMP
+#pragma omp critical
+#endif
+                {
+                    std::cout << "[Thread " << tid << "] Match " << (i + 1)
+                        << " finished. Winner: "
+                        << (winner == ' ' ? "Draw" : std::string(1, winner))
+                        << "\n";
+                }
+            }
+        }
+    }
+
+    long long crossings = 0;
+    for (const LearningModule& w : learners)
+        for (int r = 0; r < RULE_COUNT; ++r)
+            crossings += static_cast<long long>(w.updateCounts()[r] - start.updateCounts()[r]);
+
+    // === MERGE STEP ===
+    {
+        PhaseTimer mergeTimer(PHASE_MERGE);
+        TraceSpan mergeSpan(TRACE_MERGE);
+        Metrics::add(METRIC_MERGES);
+        learner = start;
+        merge->merge(learner, learners);
+    }
+    if (analytics) analytics->publishWeights(learner);
+    if (trajectory) trajectory->recordLearner(learner, numMatches);
+
+    // === UPDATE TRAINING STATS ===
+    learner.incrementTrainingCount(
+        scenario == 1 ? TRAIN_STOCHASTIC_VS_RULEV : TRAIN_RULEV_VS_RULEV, numMatches);
+
+#ifdef USE_OMP
+    result.elapsedSeconds = omp_get_wtime() - startTime;
+#else
+    result.elapsedSeconds = double(std::clock() - startTime) / CLOCKS_PER_SEC;
+#endif
+    result.matches = numMatches;
+    result.workers = workers;
+    result.winsX = winsX;
+    result.winsO = winsO;
+    result.draws = draws;
+    result.thresholdCrossings = crossings;
+
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef SUPERTRAINING_H
+#define SUPERTRAINING_H
+
+#include "LearningModule.h"
+
+class MergeStrategy;
+class GameLog;
+class TrainingAnalytics;
+class Trajectory;
+
+/**
+ * @struct SuperTrainingResult
+ * @brief Outcome summary of one Super-Training batch.
+ */
+struct SuperTrainingResult {
+    int matches = 0;              ///< Matches played
+    int workers = 0;              ///< Worker learners merged at the end
+    int winsX = 0;                ///< Matches won by player X
+    int winsO = 0;                ///< Matches won by player O
+    int draws = 0;                ///< Drawn matches
+    long long thresholdCrossings = 0;  ///< Counter threshold crossings applied by all workers
+    double elapsedSeconds = 0.0;  ///< Wall time of the batch (simulation + merge)
+};
+
+/**
+ * @class SuperTraining
+ * @brief Parallel Super-Training batch: the matches are split among
+ *        workers, each learning on its own LearningModule copy, and the
+ *        workers are merged back by a MergeStrategy (default: mean).
+ *
+ * With a single worker the batch is plain sequential learning.
+ *
+ * Shared by the interactive mode and the headless batch runner so that
+ * both follow exactly the same training and merge path.
+ */
+class SuperTraining {
+public:
+    /**
+     * @brief Run a Super-Training batch and merge the result into the learner.
+     * @param learner Global learner receiving the merged weights and stats.
+     * @param scenario 1 = Stochastic vs RulEvolution, 2 = RulEvolution vs RulEvolution.
+     * @param numMatches Number of matches to play.
+     * @param verbose Print per-match and per-move traces.
+     * @param merge Merge strategy; nullptr = MergeStrategy::defaultStrategy().
+     * @param workers Worker learners; 0 = one per OpenMP thread (1 without OpenMP).
+     * @param log If not null, every game is appended to this log (one writer per worker).
+     * @param analytics If not null, every game is accounted in this worker's analytics shard.
+     * @param trajectory If not null, each worker's learner is sampled every
+     *        trajectory->interval() matches and the merged learner after the merge.
+     * @return Outcome summary of the batch.
+     */
+    static SuperTrainingResult run(LearningModule& learner, int scenario,
+        int numMatches, bool verbose = true, const MergeStrategy* merge = nullptr,
+        int workers = 0, GameLog* log = nullptr, TrainingAnalytics* analytics = nullptr,
+        Trajectory* trajectory = nullptr);
+};
+
+#endif // SUPERTRAINING_H
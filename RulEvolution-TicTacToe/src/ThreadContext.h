@@ -0,0 +1,50 @@
+#ifndef THREADCONTEXT_H
+#define THREADCONTEXT_H
+
+#include "Metrics.h"
+#include "Random.h"
+#include "Trace.h"
+
+/**
+ * @struct ThreadContext
+ * @brief The per-engine state a thread works against: random source,
+ *        metrics registry and trace session.
+ *
+ * A parallel region captures the context of the thread that starts it and
+ * binds it in every worker (ContextBinding), so an engine's draws, metrics
+ * and spans never land in another engine.
+ */
+struct ThreadContext {
+    RandomSource* random = nullptr;
+    MetricsRegistry* metrics = nullptr;
+    TraceSession* trace = nullptr;
+
+    /// Context bound to the calling thread (process defaults where nothing is).
+    static ThreadContext current() {
+        ThreadContext c;
+        c.random = &Random::source();
+        c.metrics = &Metrics::registry();
+        c.trace = &Trace::session();
+        return c;
+    }
+};
+
+/**
+ * @class ContextBinding
+ * @brief Scoped binding of a whole ThreadContext to the calling thread.
+ */
+class ContextBinding {
+public:
+    explicit ContextBinding(const ThreadContext& context)
+        : random(*context.random), metrics(*context.metrics), trace(*context.trace) {
+    }
+    ContextBinding(const ContextBinding&) = delete;
+    ContextBinding& operator=(const ContextBinding&) = delete;
+
+private:
+    RandomBinding random;
+    MetricsBinding metrics;
+    TraceBinding trace;
+};
+
+#endif // THREADCONTEXT_H
@@ -0,0 +1,331 @@
+// ================================================================
+//  Tournament.cpp — Round-robin tournament with Bradley-Terry ratings
+//  Notes:
+//    - every uncached (pairing, first mover, chunk) is one task of a
+//      single dynamic parallel loop, so small and large pairings mix;
+//    - the cache is a text file keyed by (lower hash, higher hash,
+//      games) with counts from the lower hash's side; later lines win;
+//    - ratings use the MM iteration of Hunter (2004) and the
+//      pseudo-inverse of the Fisher information for the intervals.
+// ================================================================
+#include "Tournament.h"
+#include "Checkpoint.h"
+#include "Game_TicTacToe.h"
+#include "WeightsIO.h"
+#include "Random.h"
+#include "ThreadContext.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace {
+
+const int MATCH_CHUNK = 256;  // matches per simulation task
+const double ELO_PER_NATURAL = 400.0 / std::log(10.0);
+
+typedef std::tuple<std::uint64_t, std::uint64_t, long long> CacheKey;  // lower hash, higher hash, games
+
+/// Counts of a pairing from the lower hash's side (same layout as PairingResult).
+struct CacheEntry {
+    long long counts[6] = {};
+};
+
+std::map<CacheKey, CacheEntry> loadCache(const std::string& path) {
+    std::map<CacheKey, CacheEntry> cache;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::uint64_t lo = 0, hi = 0;
+        long long games = 0;
+        CacheEntry e;
+        if (!(iss >> std::hex >> lo >> hi >> std::dec >> games)) continue;
+        bool ok = true;
+        for (long long& c : e.counts) ok = ok && static_cast<bool>(iss >> c);
+        if (ok) cache[CacheKey(lo, hi, games)] = e;
+    }
+    return cache;
+}
+
+/// Counts of p from the side of the entrant with the lower hash.
+CacheEntry toCache(const PairingResult& p, bool aIsLower) {
+    CacheEntry e;
+    if (aIsLower) {
+        long long c[6] = { p.winsFirst, p.drawsFirst, p.lossesFirst, p.winsSecond, p.drawsSecond, p.lossesSecond };
+        std::memcpy(e.counts, c, sizeof(c));
+    }
+    else {
+        long long c[6] = { p.lossesSecond, p.drawsSecond, p.winsSecond, p.lossesFirst, p.drawsFirst, p.winsFirst };
+        std::memcpy(e.counts, c, sizeof(c));
+    }
+    return e;
+}
+
+void fromCache(const CacheEntry& e, bool aIsLower, PairingResult& p) {
+    const long long* c = e.counts;
+    if (aIsLower) {
+        p.winsFirst = c[0]; p.drawsFirst = c[1]; p.lossesFirst = c[2];
+        p.winsSecond = c[3]; p.drawsSecond = c[4]; p.lossesSecond = c[5];
+    }
+    else {
+        p.winsFirst = c[5]; p.drawsFirst = c[4]; p.lossesFirst = c[3];
+        p.winsSecond = c[2]; p.drawsSecond = c[1]; p.lossesSecond = c[0];
+    }
+}
+
+/// In-place Gauss-Jordan inverse of a small dense matrix; false if singular.
+bool invert(std::vector<std::vector<double>>& m) {
+    const int n = static_cast<int>(m.size());
+    std::vector<std::vector<double>> inv(n, std::vector<double>(n, 0.0));
+    for (int i = 0; i < n; ++i) inv[i][i] = 1.0;
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < n; ++r)
+            if (std::fabs(m[r][col]) > std::fabs(m[pivot][col])) pivot = r;
+        if (std::fabs(m[pivot][col]) < 1e-12) return false;
+        std::swap(m[pivot], m[col]);
+        std::swap(inv[pivot], inv[col]);
+        double d = m[col][col];
+        for (int k = 0; k < n; ++k) { m[col][k] /= d; inv[col][k] /= d; }
+        for (int r = 0; r < n; ++r) {
+            if (r == col || m[r][col] == 0.0) continue;
+            double f = m[r][col];
+            for (int k = 0; k < n; ++k) { m[r][k] -= f * m[col][k]; inv[r][k] -= f * inv[col][k]; }
+        }
+    }
+    m = inv;
+    return true;
+}
+
+} // namespace
+
+bool Tournament::entrant(const std::string& spec, const LearningModule& learner, TournamentEntrant& out) {
+    out.label = spec;
+    if (spec == "stochastic") {
+        out.policy = PolicySpec::stochastic();
+    }
+    else if (spec == "rulevolution") {
+        out.policy = PolicySpec::rulevolution(std::vector<double>(RULE_PREPARATION, 0.5));
+    }
+    else if (spec == "learner") {
+        out.policy = PolicySpec::rulevolution(learner.exportPlayerWeights());
+    }
+    else {
+        LearningModule local = learner;
+        if (!WeightsIO::load(local, spec)) return false;
+        out.policy = PolicySpec::rulevolution(local.exportPlayerWeights());
+    }
+    out.hash = hash(out.policy);
+    return true;
+}
+
+std::uint64_t Tournament::hash(const PolicySpec& policy) {
+    std::string bytes(1, static_cast<char>(policy.kind));
+    if (policy.kind == POLICY_RULEVOLUTION)
+        bytes.append(reinterpret_cast<const char*>(policy.weights.data()), policy.weights.size() * sizeof(double));
+    return Checkpoint::hash(bytes);
+}
+
+TournamentResult Tournament::run(const std::vector<TournamentEntrant>& entrants, int games,
+    const std::string& cachePath) {
+    TournamentResult result;
+#ifdef USE_OMP
+    double startTime = omp_get_wtime();
+#else
+    auto startTime = std::clock();
+#endif
+    for (const TournamentEntrant& e : entrants) {
+        if (!e.policy.simulable()) {
+            std::cerr << "[ERROR] Tournament does not support the perfect policy\n";
+            result.ok = false;
+            return result;
+        }
+    }
+    const int n = static_cast<int>(entrants.size());
+    std::map<CacheKey, CacheEntry> cache;
+    if (!cachePath.empty()) cache = loadCache(cachePath);
+
+    // Pairings, from the cache where possible; identical policies share one simulation.
+    std::vector<int> pending;
+    std::map<CacheKey, int> scheduled;         // key -> pairing simulated for it
+    std::vector<std::pair<int, int>> aliases;  // (pairing, pairing simulated for the same key)
+    for (int a = 0; a < n; ++a) {
+        for (int b = a + 1; b < n; ++b) {
+            PairingResult p;
+            p.a = a;
+            p.b = b;
+            p.games = games;
+            bool aIsLower = entrants[a].hash <= entrants[b].hash;
+            CacheKey key(std::min(entrants[a].hash, entrants[b].hash),
+                std::max(entrants[a].hash, entrants[b].hash), games);
+            auto it = cache.find(key);
+            if (it != cache.end()) {
+                fromCache(it->second, aIsLower, p);
+                p.cached = true;
+                ++result.cached;
+            }
+            else {
+                int index = static_cast<int>(result.pairings.size());
+                auto sched = scheduled.find(key);
+                if (sched != scheduled.end()) {
+                    aliases.push_back(std::make_pair(index, sched->second));
+                }
+                else {
+                    scheduled[key] = index;
+                    pending.push_back(index);
+                }
+            }
+            result.pairings.push_back(p);
+        }
+    }
+
+    // Tasks: (pending pairing, first mover, chunk), a plays X and b plays O.
+    const int chunks = (games + MATCH_CHUNK - 1) / MATCH_CHUNK;
+    const int tasks = static_cast<int>(pending.size()) * 2 * chunks;
+    std::vector<long long> wins(tasks, 0), draws(tasks, 0), losses(tasks, 0);
+
+    const ThreadContext context = ThreadContext::current();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < tasks; ++t) {
+        ContextBinding bindContext(context);
+        const PairingResult& p = result.pairings[pending[t / (2 * chunks)]];
+        bool aFirst = (t / chunks) % 2 == 0;
+        int count = std::min(MATCH_CHUNK, games - (t % chunks) * MATCH_CHUNK);
+
+        std::unique_ptr<Player> x = entrants[p.a].policy.makePlayer('X');
+        std::unique_ptr<Player> o = entrants[p.b].policy.makePlayer('O');
+        for (int m = 0; m < count; ++m) {
+            Game g(x.get(), o.get());
+            char winner = g.play(false, aFirst ? 'X' : 'O');
+            if (winner == 'X') wins[t]++;
+            else if (winner == 'O') losses[t]++;
+            else draws[t]++;
+        }
+    }
+
+    std::ofstream cacheOut;
+    if (!cachePath.empty() && !pending.empty()) {
+        bool fresh = !std::ifstream(cachePath).good();
+        cacheOut.open(cachePath, std::ios::app);
+        if (fresh) cacheOut << "# RulEvolution tournament cache: lowHash highHash games wF dF lF wS dS lS\n";
+        if (!cacheOut.good()) std::cerr << "[WARN] Cannot write tournament cache " << cachePath << "\n";
+    }
+    for (size_t k = 0; k < pending.size(); ++k) {
+        PairingResult& p = result.pairings[pending[k]];
+        for (int c = 0; c < chunks; ++c) {
+            int first = static_cast<int>(k) * 2 * chunks + c;
+            int second = first + chunks;
+            p.winsFirst += wins[first];
+            p.drawsFirst += draws[first];
+            p.lossesFirst += losses[first];
+            p.winsSecond += wins[second];
+            p.drawsSecond += draws[second];
+            p.lossesSecond += losses[second];
+        }
+        ++result.played;
+        if (cacheOut.is_open()) {
+            bool aIsLower = entrants[p.a].hash <= entrants[p.b].hash;
+            CacheEntry e = toCache(p, aIsLower);
+            cacheOut << std::hex << std::min(entrants[p.a].hash, entrants[p.b].hash) << ' '
+                << std::max(entrants[p.a].hash, entrants[p.b].hash) << std::dec << ' ' << p.games;
+            for (long long c : e.counts) cacheOut << ' ' << c;
+            cacheOut << '\n';
+        }
+    }
+
+    for (const auto& alias : aliases) {
+        const PairingResult& source = result.pairings[alias.second];
+        PairingResult& p = result.pairings[alias.first];
+        CacheEntry e = toCache(source, entrants[source.a].hash <= entrants[source.b].hash);
+        fromCache(e, entrants[p.a].hash <= entrants[p.b].hash, p);
+        p.cached = true;
+        ++result.cached;
+    }
+
+    result.ratings = rate(result.pairings, n);
+#ifdef USE_OMP
+    result.elapsedSeconds = omp_get_wtime() - startTime;
+#else
+    result.elapsedSeconds = double(std::clock() - startTime) / CLOCKS_PER_SEC;
+#endif
+    return result;
+}
+
+std::vector<TournamentRating> Tournament::rate(const std::vector<PairingResult>& pairings, int n) {
+    std::vector<TournamentRating> ratings(n);
+    for (int i = 0; i < n; ++i) ratings[i].entrant = i;
+    if (n == 0) return ratings;
+
+    // Games and points between every two entrants, plus one virtual draw per pairing.
+    std::vector<std::vector<double>> games(n, std::vector<double>(n, 0.0));
+    std::vector<double> points(n, 0.0);
+    for (const PairingResult& p : pairings) {
+        double total = 2.0 * p.games;
+        double scoreA = p.score();
+        games[p.a][p.b] += total + 1.0;
+        games[p.b][p.a] += total + 1.0;
+        points[p.a] += scoreA + 0.5;
+        points[p.b] += total - scoreA + 0.5;
+        ratings[p.a].score += scoreA;
+        ratings[p.b].score += total - scoreA;
+        ratings[p.a].games += static_cast<long long>(total);
+        ratings[p.b].games += static_cast<long long>(total);
+    }
+
+    // MM iteration on the strengths gamma (geometric mean kept at 1).
+    std::vector<double> gamma(n, 1.0);
+    for (int iter = 0; iter < 10000; ++iter) {
+        double change = 0.0;
+        std::vector<double> next(n, 1.0);
+        for (int i = 0; i < n; ++i) {
+            double denom = 0.0;
+            for (int j = 0; j < n; ++j)
+                if (j != i && games[i][j] > 0.0) denom += games[i][j] / (gamma[i] + gamma[j]);
+            next[i] = denom > 0.0 ? points[i] / denom : gamma[i];
+        }
+        double logMean = 0.0;
+        for (double g : next) logMean += std::log(g);
+        logMean /= n;
+        for (int i = 0; i < n; ++i) {
+            next[i] /= std::exp(logMean);
+            change = std::max(change, std::fabs(std::log(next[i] / gamma[i])));
+        }
+        gamma = next;
+        if (change < 1e-10) break;
+    }
+
+    // Covariance of log-strengths under sum = 0: (H + J/n)^-1 - J/n.
+    std::vector<std::vector<double>> h(n, std::vector<double>(n, 1.0 / n));
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) {
+            if (i == j || games[i][j] <= 0.0) continue;
+            double p = gamma[i] / (gamma[i] + gamma[j]);
+            double info = games[i][j] * p * (1.0 - p);
+            h[i][j] -= info;
+            h[i][i] += info;
+        }
+    bool covariance = invert(h);
+
+    for (int i = 0; i < n; ++i) {
+        ratings[i].elo = ELO_PER_NATURAL * std::log(gamma[i]);
+        double variance = covariance ? h[i][i] - 1.0 / n : 0.0;
+        ratings[i].ci95 = 1.96 * ELO_PER_NATURAL * std::sqrt(std::max(0.0, variance));
+    }
+    std::stable_sort(ratings.begin(), ratings.end(),
+        [](const TournamentRating& x, const TournamentRating& y) { return x.elo > y.elo; });
+    return ratings;
+}
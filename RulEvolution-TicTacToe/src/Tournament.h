@@ -0,0 +1,104 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "ExactEvaluator.h"
+#include "LearningModule.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TournamentEntrant
+ * @brief One participant: a label, its policy and the hash that keys its
+ *        results in the pairing cache.
+ */
+struct TournamentEntrant {
+    std::string label;      ///< Name in the results (file name or built-in name)
+    PolicySpec policy;      ///< Stochastic or RulEvolution with its weights
+    std::uint64_t hash = 0; ///< Hash of the policy kind and the exact weight bits
+};
+
+/**
+ * @struct PairingResult
+ * @brief Outcome of one pairing from entrant a's point of view, split by
+ *        first mover.
+ */
+struct PairingResult {
+    int a = 0, b = 0;              ///< Entrant indices (a < b)
+    long long games = 0;           ///< Games per first-mover assignment
+    long long winsFirst = 0;       ///< a moved first: a wins
+    long long drawsFirst = 0;      ///< a moved first: draws
+    long long lossesFirst = 0;     ///< a moved first: b wins
+    long long winsSecond = 0;      ///< b moved first: a wins
+    long long drawsSecond = 0;     ///< b moved first: draws
+    long long lossesSecond = 0;    ///< b moved first: b wins
+    bool cached = false;           ///< Read from the cache instead of played
+
+    /// Score of a over both assignments (wins + draws / 2).
+    double score() const {
+        return winsFirst + winsSecond + 0.5 * (drawsFirst + drawsSecond);
+    }
+};
+
+/**
+ * @struct TournamentRating
+ * @brief Bradley-Terry strength of one entrant on the Elo scale.
+ */
+struct TournamentRating {
+    int entrant = 0;       ///< Index in the entrant list
+    double elo = 0.0;      ///< Rating (mean of all entrants = 0)
+    double ci95 = 0.0;     ///< Half-width of the 95% confidence interval
+    double score = 0.0;    ///< Points scored (wins + draws / 2)
+    long long games = 0;   ///< Games played
+};
+
+/**
+ * @struct TournamentResult
+ * @brief Every pairing and the ratings (sorted by decreasing Elo).
+ */
+struct TournamentResult {
+    std::vector<PairingResult> pairings;
+    std::vector<TournamentRating> ratings;
+    int played = 0;               ///< Pairings simulated by this run
+    int cached = 0;               ///< Pairings taken from the cache
+    double elapsedSeconds = 0.0;
+    bool ok = true;               ///< False if an entrant cannot be simulated (nothing played)
+};
+
+/**
+ * @class Tournament
+ * @brief Round-robin tournament between weight snapshots and built-in players.
+ *
+ * Every pairing plays `games` matches with each entrant moving first; all
+ * (pairing, first mover, chunk) tasks of the run share one parallel loop.
+ * Results are cached per pairing, keyed by the two policy hashes and the
+ * game count, so adding a snapshot only plays its own pairings. Ratings
+ * are the Bradley-Terry maximum-likelihood strengths (draws count half,
+ * one virtual draw per pairing keeps unbeaten entrants finite) with
+ * confidence intervals from the inverse Fisher information.
+ */
+class Tournament {
+public:
+    /**
+     * @brief Resolve an entrant: "stochastic", "rulevolution" (default 0.5
+     *        weights), "learner" (current weights) or a weights file.
+     * @return false if the weights file cannot be loaded.
+     */
+    static bool entrant(const std::string& spec, const LearningModule& learner, TournamentEntrant& out);
+
+    /// Cache key of a policy: FNV-1a over its kind and the bits of its weights.
+    static std::uint64_t hash(const PolicySpec& policy);
+
+    /**
+     * @brief Play (or read from the cache) every pairing and rate the entrants.
+     * @param games Matches per pairing and first-mover assignment.
+     * @param cachePath Pairing cache ("" = none); new pairings are appended.
+     */
+    static TournamentResult run(const std::vector<TournamentEntrant>& entrants, int games,
+        const std::string& cachePath);
+
+    /// Bradley-Terry ratings of n entrants from their pairings.
+    static std::vector<TournamentRating> rate(const std::vector<PairingResult>& pairings, int n);
+};
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,246 @@
+// ================================================================
+//  Trace.cpp — Per-thread span ring buffers and trace-event export
+//  Notes:
+//    - a buffer's head counts every span ever recorded; slot i % capacity
+//      holds span i, published by the release store of the head;
+//    - a dump reads the head before and after copying and keeps only the
+//      spans the writer cannot have overwritten in between;
+//    - timestamps are steady_clock ns since start(), written as µs with
+//      ns precision ("ts" / "dur" of complete "X" events);
+//    - SIGUSR1 is installed while at least one session traces; the
+//      handler only counts requests and every session's watcher compares
+//      the count with the last one it served.
+// ================================================================
+#include "Trace.h"
+#include <algorithm>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TraceBuffer {
+    std::unique_ptr<TraceRecord[]> slots;
+    std::size_t capacity = 0;
+    std::atomic<std::uint64_t> head{ 0 };
+    int thread = 0;         ///< Registration order, the "tid" of the trace
+    std::thread::id owner;  ///< Thread recording into it
+};
+
+namespace {
+
+struct Span {
+    std::uint64_t begin, end;
+    std::uint32_t kind, arg;
+};
+
+std::atomic<std::uint64_t> nextSessionId{ 1 };
+
+// SIGUSR1: counted by the handler, served by the watchers of the active sessions.
+volatile std::sig_atomic_t dumpRequests = 0;
+void onDumpSignal(int) { dumpRequests = dumpRequests + 1; }
+std::mutex signalMutex;
+int tracingSessions = 0;
+#ifdef SIGUSR1
+void (*previousHandler)(int) = SIG_DFL;
+#endif
+
+void installDumpSignal() {
+    std::lock_guard<std::mutex> lock(signalMutex);
+#ifdef SIGUSR1
+    if (tracingSessions == 0) previousHandler = std::signal(SIGUSR1, onDumpSignal);
+#endif
+    ++tracingSessions;
+}
+
+void removeDumpSignal() {
+    std::lock_guard<std::mutex> lock(signalMutex);
+    --tracingSessions;
+#ifdef SIGUSR1
+    if (tracingSessions == 0) std::signal(SIGUSR1, previousHandler);
+#endif
+}
+
+const char* kindName(std::uint32_t k) {
+    switch (k) {
+    case TRACE_JOB:      return "job";
+    case TRACE_WORKER:   return "worker";
+    case TRACE_MATCH:    return "match";
+    case TRACE_RULES:    return "rules";
+    case TRACE_LEARNING: return "learning";
+    case TRACE_MERGE:    return "merge";
+    case TRACE_IO:       return "io";
+    case TRACE_CONSOLE:  return "console";
+    default:             return "unknown";
+    }
+}
+
+const char* kindCategory(std::uint32_t k) {
+    switch (k) {
+    case TRACE_JOB:
+    case TRACE_WORKER:
+    case TRACE_MERGE:    return "training";
+    case TRACE_MATCH:
+    case TRACE_RULES:    return "simulation";
+    case TRACE_LEARNING: return "learning";
+    case TRACE_IO:
+    case TRACE_CONSOLE:  return "io";
+    default:             return "unknown";
+    }
+}
+
+void writeMicros(std::ostream& out, std::uint64_t nanos) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03u",
+        static_cast<unsigned long long>(nanos / 1000), static_cast<unsigned>(nanos % 1000));
+    out << text;
+}
+
+} // namespace
+
+TraceSession Trace::defaultSession;  // after the signal state, which its destructor may use
+
+TraceSession::TraceSession()
+    : identity(nextSessionId.fetch_add(1)), epoch(std::chrono::steady_clock::now()) {
+}
+
+TraceSession::~TraceSession() {
+    stop();
+}
+
+void TraceSession::watch() {
+    std::sig_atomic_t served = dumpRequests;
+    std::unique_lock<std::mutex> lock(watcherMutex);
+    while (watching) {
+        watcherCv.wait_for(lock, std::chrono::milliseconds(100));
+        std::sig_atomic_t requests = dumpRequests;
+        if (requests == served) continue;
+        served = requests;
+        lock.unlock();
+        if (write(outputPath))
+            std::cerr << "[INFO] Trace written to " << outputPath << "\n";
+        lock.lock();
+    }
+}
+
+TraceBuffer& TraceSession::threadBuffer() {
+    static thread_local std::uint64_t cachedId = 0;
+    static thread_local TraceBuffer* cached = nullptr;
+    if (cachedId == identity) return *cached;
+
+    std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    TraceBuffer* found = nullptr;
+    for (auto& b : buffers)
+        if (b->owner == self) found = b.get();
+    if (!found) {
+        std::unique_ptr<TraceBuffer> b(new TraceBuffer());
+        b->capacity = bufferCapacity;
+        b->slots.reset(new TraceRecord[b->capacity]);
+        b->thread = static_cast<int>(buffers.size());
+        b->owner = self;
+        buffers.push_back(std::move(b));
+        found = buffers.back().get();
+    }
+    cached = found;
+    cachedId = identity;
+    return *found;
+}
+
+void TraceSession::start(const std::string& path, std::size_t capacity) {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        bufferCapacity = (std::max)(capacity, static_cast<std::size_t>(1));
+        for (auto& b : buffers) b->head.store(0, std::memory_order_relaxed);
+        outputPath = path;
+        epoch = std::chrono::steady_clock::now();
+    }
+    installDumpSignal();
+    watching = true;
+    watcher = std::thread([this]() { watch(); });
+    active.store(true, std::memory_order_release);
+}
+
+bool TraceSession::stop() {
+    if (!active.exchange(false)) return true;
+    {
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        watching = false;
+    }
+    watcherCv.notify_all();
+    if (watcher.joinable()) watcher.join();
+    removeDumpSignal();
+    return write(outputPath);
+}
+
+void TraceSession::record(TraceKind kind, std::uint64_t begin, std::uint64_t end, std::uint32_t arg) {
+    TraceBuffer& b = threadBuffer();
+    std::uint64_t i = b.head.load(std::memory_order_relaxed);
+    TraceRecord& r = b.slots[i % b.capacity];
+    r.begin.store(begin, std::memory_order_relaxed);
+    r.end.store(end, std::memory_order_relaxed);
+    r.kind.store(static_cast<std::uint32_t>(kind), std::memory_order_relaxed);
+    r.arg.store(arg, std::memory_order_relaxed);
+    b.head.store(i + 1, std::memory_order_release);
+}
+
+bool TraceSession::write(const std::string& path) {
+    if (path.empty()) return false;
+    std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::trunc);
+    if (!out.good()) {
+        std::cerr << "[ERROR] Cannot write trace to " << path << "\n";
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"RulEvolution\"}}";
+    unsigned long long dropped = 0, spans = 0;
+    std::vector<Span> copy;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& b : buffers) {
+        std::uint64_t before = b->head.load(std::memory_order_acquire);
+        std::uint64_t first = (before > b->capacity) ? before - b->capacity : 0;
+        copy.clear();
+        for (std::uint64_t i = first; i < before; ++i) {
+            const TraceRecord& r = b->slots[i % b->capacity];
+            copy.push_back({ r.begin.load(std::memory_order_relaxed), r.end.load(std::memory_order_relaxed),
+                r.kind.load(std::memory_order_relaxed), r.arg.load(std::memory_order_relaxed) });
+        }
+        // Spans the writer may have overwritten while we copied are dropped.
+        std::uint64_t after = b->head.load(std::memory_order_acquire);
+        std::uint64_t valid = (after >= b->capacity) ? after - b->capacity + 1 : 0;
+        std::size_t skip = static_cast<std::size_t>((std::min)(before, (std::max)(valid, first)) - first);
+        dropped += (std::max)(valid, first);
+
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->thread
+            << ",\"args\":{\"name\":\"thread " << b->thread << "\"}}";
+        for (std::size_t i = skip; i < copy.size(); ++i) {
+            const Span& s = copy[i];
+            out << ",\n{\"name\":\"" << kindName(s.kind) << "\",\"cat\":\"" << kindCategory(s.kind)
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->thread << ",\"ts\":";
+            writeMicros(out, s.begin);
+            out << ",\"dur\":";
+            writeMicros(out, s.end >= s.begin ? s.end - s.begin : 0);
+            if (s.kind == TRACE_JOB || s.kind == TRACE_WORKER) out << ",\"args\":{\"n\":" << s.arg << "}";
+            out << "}";
+            ++spans;
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+    if (!out.good() || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "[ERROR] Cannot write trace to " << path << "\n";
+        std::remove(tmp.c_str());
+        return false;
+    }
+    if (dropped > 0)
+        std::cerr << "[WARN] Trace buffers wrapped: " << dropped
+            << " oldest spans dropped (raise the buffer size)\n";
+    return true;
+}
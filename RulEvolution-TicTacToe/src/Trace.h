@@ -0,0 +1,192 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum TraceKind
+ * @brief Kinds of timeline spans.
+ */
+enum TraceKind {
+    TRACE_JOB = 0,     ///< One batch job (arg = job number)
+    TRACE_WORKER,      ///< One Super-Training / replay worker's share (arg = worker)
+    TRACE_MATCH,       ///< Game::play()
+    TRACE_RULES,       ///< RulEvolutionRules::evaluate()
+    TRACE_LEARNING,    ///< LearningModule update from a game or a batch
+    TRACE_MERGE,       ///< Merge of the worker learners
+    TRACE_IO,          ///< Weights, checkpoint, game-log and trajectory file I/O
+    TRACE_CONSOLE,     ///< Console output under a lock (omp critical)
+    TRACE_KIND_COUNT
+};
+
+/**
+ * @struct TraceRecord
+ * @brief One finished span, as stored in a ring buffer slot. The fields are
+ *        relaxed atomics so a dump may read a slot while its thread writes.
+ */
+struct TraceRecord {
+    std::atomic<std::uint64_t> begin;  ///< ns since Trace::start()
+    std::atomic<std::uint64_t> end;    ///< ns since Trace::start()
+    std::atomic<std::uint32_t> kind;   ///< TraceKind
+    std::atomic<std::uint32_t> arg;    ///< Kind-specific argument
+};
+
+struct TraceBuffer;
+
+/**
+ * @class TraceSession
+ * @brief Opt-in timeline tracing into per-thread ring buffers, written as
+ *        Chrome / Perfetto trace-event JSON (load it in ui.perfetto.dev or
+ *        chrome://tracing).
+ *
+ * Each thread records into its own ring buffer of the session (registered
+ * on first use, freed with the session, like the Metrics shards), so
+ * recording takes no lock; when a buffer is full the oldest spans are
+ * overwritten. While tracing is off a span costs one relaxed load.
+ *
+ * Each Engine owns a session and binds it to its threads; a thread with no
+ * session bound records into the process default (see Trace).
+ *
+ * The file is written by stop(), by write(), and on SIGUSR1 (POSIX) while
+ * tracing: the signal only counts a request, a background thread of every
+ * active session writes its file.
+ */
+class TraceSession {
+public:
+    static const std::size_t DEFAULT_CAPACITY = 1 << 16;  ///< Spans per thread
+
+    TraceSession();
+    ~TraceSession();
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+    /**
+     * @brief Clear the buffers and start recording; `path` is the output file.
+     * @param capacity Spans kept per thread (buffers created before keep their size).
+     */
+    void start(const std::string& path, std::size_t capacity = DEFAULT_CAPACITY);
+
+    /// Stop recording and write the file. @return false if it cannot be written.
+    bool stop();
+
+    /// Write what the buffers hold now (tracing continues). @return false on I/O error.
+    bool write(const std::string& path);
+
+    bool enabled() const {
+#ifndef NO_TRACE
+        return active.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    /// Nanoseconds since start().
+    std::uint64_t now() const {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    /// Append a finished span to the calling thread's buffer.
+    void record(TraceKind kind, std::uint64_t begin, std::uint64_t end, std::uint32_t arg = 0);
+
+private:
+    TraceBuffer& threadBuffer();
+    void watch();
+
+    const std::uint64_t identity;  ///< Distinguishes sessions for the per-thread buffer cache
+    std::atomic<bool> active{ false };
+    std::chrono::steady_clock::time_point epoch;
+
+    std::mutex registryMutex;  ///< Taken at registration and dump time, never to record
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::size_t bufferCapacity = DEFAULT_CAPACITY;
+    std::string outputPath;
+
+    std::thread watcher;  ///< Writes the file on SIGUSR1
+    std::mutex watcherMutex;
+    std::condition_variable watcherCv;
+    bool watching = false;
+};
+
+/**
+ * @class Trace
+ * @brief Tracing through the session bound to the calling thread
+ *        (TraceBinding), or the process default. Define NO_TRACE to compile
+ *        recording away.
+ */
+class Trace {
+public:
+    static const std::size_t DEFAULT_CAPACITY = TraceSession::DEFAULT_CAPACITY;
+
+    static void start(const std::string& path, std::size_t capacity = DEFAULT_CAPACITY) { session().start(path, capacity); }
+    static bool stop() { return session().stop(); }
+    static bool write(const std::string& path) { return session().write(path); }
+    static bool enabled() { return session().enabled(); }
+    static std::uint64_t now() { return session().now(); }
+
+    /// Session bound to the calling thread (the process default if none).
+    static TraceSession& session() {
+        TraceSession* bound = binding();
+        return bound ? *bound : defaultSession;
+    }
+
+private:
+    friend class TraceBinding;
+
+    static TraceSession*& binding() {
+        static thread_local TraceSession* bound = nullptr;
+        return bound;
+    }
+
+    static TraceSession defaultSession;
+};
+
+/**
+ * @class TraceBinding
+ * @brief Scoped binding of a TraceSession to the calling thread.
+ */
+class TraceBinding {
+public:
+    explicit TraceBinding(TraceSession& session) : previous(Trace::binding()) { Trace::binding() = &session; }
+    ~TraceBinding() { Trace::binding() = previous; }
+    TraceBinding(const TraceBinding&) = delete;
+    TraceBinding& operator=(const TraceBinding&) = delete;
+
+private:
+    TraceSession* previous;
+};
+
+/**
+ * @class TraceSpan
+ * @brief RAII span: records the lifetime of a scope into the session bound
+ *        when it opened, while tracing is on.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(TraceKind k, std::uint32_t a = 0)
+        : session(Trace::session()), kind(k), arg(a), on(session.enabled()), begin(on ? session.now() : 0) {
+    }
+    ~TraceSpan() {
+        if (on) session.record(kind, begin, session.now(), arg);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceSession& session;
+    TraceKind kind;
+    std::uint32_t arg;
+    bool on;
+    std::uint64_t begin;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,231 @@
+// ================================================================
+//  TrainingAnalytics.cpp — Streaming training analytics
+//  Notes:
+//    - workers publish whole AnalyticsTotals values through a per-shard
+//      sequence lock, so a row never mixes two publications of a shard;
+//    - shard totals persist across batches: a worker resumes from its
+//      shard, and the time series covers the whole process;
+//    - rows are only written when the match count moved since the last one.
+// ================================================================
+#include "TrainingAnalytics.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+static_assert(std::is_trivially_copyable<AnalyticsTotals>::value, "AnalyticsTotals is published by copy");
+
+namespace {
+
+    const char* const RULE_LABELS[RULE_COUNT] = { "win", "block", "center", "corner", "side", "preparation" };
+
+    double rate(unsigned long long n, unsigned long long d) {
+        return d ? static_cast<double>(n) / static_cast<double>(d) : 0.0;
+    }
+
+    bool endsWith(const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+} // namespace
+
+// --- AnalyticsTotals ----------------------------------------------------------
+
+void AnalyticsTotals::record(const GameHistory& history, char learnerSide) {
+    ++matches;
+    char winner = history.winner;
+    bool decided = (winner == 'X' || winner == 'O');
+    double won = (winner == learnerSide) ? 1.0 : 0.0;
+
+    if (winner == learnerSide) ++wins;
+    else if (decided) ++losses;
+    else ++draws;
+
+    if (decided && history.size() > 0) {
+        if (winner == history.side(0)) ++firstMoverWins;
+        else ++secondMoverWins;
+    }
+
+    for (int i = 0; i < history.size(); ++i)
+        for (unsigned mask = history.rules[i]; mask; mask &= mask - 1) {
+            int r = 0;
+            while (!(mask & (1u << r))) ++r;
+            ++rulesFired[r];
+        }
+
+    // Plain running mean until the window is full, so early values are unbiased.
+    for (int w = 0; w < ANALYTICS_WINDOWS; ++w) {
+        double span = static_cast<double>(std::min<unsigned long long>(matches, window(w)));
+        ewmaWin[w] += (won - ewmaWin[w]) / span;
+    }
+}
+
+void AnalyticsTotals::sampleWeights(const LearningModule& learner) {
+    const RuleArray& w = learner.weights();
+    for (int i = 0; i < ANALYTICS_WEIGHTS; ++i)
+        weights[i] = w[i + 1];
+    weightSources = 1;
+}
+
+void AnalyticsTotals::merge(const AnalyticsTotals& other) {
+    unsigned long long total = matches + other.matches;
+    if (total > 0)
+        for (int w = 0; w < ANALYTICS_WINDOWS; ++w)
+            ewmaWin[w] = (ewmaWin[w] * matches + other.ewmaWin[w] * other.matches) / total;
+
+    unsigned long long sources = weightSources + other.weightSources;
+    if (sources > 0)
+        for (int i = 0; i < ANALYTICS_WEIGHTS; ++i)
+            weights[i] = (weights[i] * weightSources + other.weights[i] * other.weightSources) / sources;
+    weightSources = sources;
+
+    matches = total;
+    wins += other.wins;
+    draws += other.draws;
+    losses += other.losses;
+    firstMoverWins += other.firstMoverWins;
+    secondMoverWins += other.secondMoverWins;
+    for (int r = 0; r < RULE_COUNT; ++r)
+        rulesFired[r] += other.rulesFired[r];
+}
+
+// --- AnalyticsShard -----------------------------------------------------------
+
+AnalyticsShard::AnalyticsShard() {
+    for (auto& w : words) w.store(0, std::memory_order_relaxed);
+}
+
+void AnalyticsShard::publish(const AnalyticsTotals& totals) {
+    unsigned long long buffer[sizeof(words) / sizeof(words[0])] = {};
+    std::memcpy(buffer, &totals, sizeof(totals));
+
+    unsigned s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);  // odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); ++i)
+        words[i].store(buffer[i], std::memory_order_relaxed);
+    sequence.store(s + 2, std::memory_order_release);
+}
+
+AnalyticsTotals AnalyticsShard::read() const {
+    unsigned long long buffer[sizeof(words) / sizeof(words[0])];
+    for (;;) {
+        unsigned before = sequence.load(std::memory_order_acquire);
+        if (before & 1u) { std::this_thread::yield(); continue; }
+        for (std::size_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); ++i)
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    AnalyticsTotals totals;
+    std::memcpy(&totals, buffer, sizeof(totals));
+    return totals;
+}
+
+// --- TrainingAnalytics --------------------------------------------------------
+
+std::vector<AnalyticsShard*> TrainingAnalytics::shards(int workers) {
+    std::lock_guard<std::mutex> lock(shardsMtx);
+    while (static_cast<int>(shardList.size()) < workers)
+        shardList.emplace_back(new AnalyticsShard());
+    std::vector<AnalyticsShard*> list;
+    for (int w = 0; w < workers; ++w) list.push_back(shardList[w].get());
+    return list;
+}
+
+void TrainingAnalytics::publishWeights(const LearningModule& learner) {
+    std::lock_guard<std::mutex> lock(shardsMtx);
+    for (auto& shard : shardList) {
+        AnalyticsTotals totals = shard->read();
+        totals.sampleWeights(learner);
+        shard->publish(totals);
+    }
+}
+
+AnalyticsTotals TrainingAnalytics::snapshot() const {
+    AnalyticsTotals merged;
+    std::lock_guard<std::mutex> lock(shardsMtx);
+    for (const auto& shard : shardList)
+        merged.merge(shard->read());
+    return merged;
+}
+
+bool TrainingAnalytics::start(const std::string& path, double intervalSeconds) {
+    stop();
+    out.open(path, std::ios::app);
+    if (!out.good()) return false;
+    csv = endsWith(path, ".csv");
+    interval = (intervalSeconds > 0.0) ? intervalSeconds : 1.0;
+    startTime = std::chrono::steady_clock::now();
+    lastMatches = ~0ULL;
+
+    if (csv && out.tellp() == 0) {
+        out << "seconds,matches,win,draw,loss";
+        for (int w = 0; w < ANALYTICS_WINDOWS; ++w) out << ",ewma" << AnalyticsTotals::window(w);
+        out << ",first_mover_win,second_mover_win";
+        for (int r = 0; r < RULE_COUNT; ++r) out << ",fired_" << RULE_LABELS[r];
+        for (int i = 0; i < ANALYTICS_WEIGHTS; ++i) out << ",w_" << RULE_LABELS[i + 1];
+        out << "\n" << std::flush;
+    }
+
+    running = true;
+    worker = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (running) {
+            cv.wait_for(lock, std::chrono::duration<double>(interval), [this]() { return !running; });
+            if (!running) break;
+            lock.unlock();
+            writeRow();
+            lock.lock();
+        }
+    });
+    return true;
+}
+
+void TrainingAnalytics::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+    writeRow();
+    out.close();
+}
+
+void TrainingAnalytics::writeRow() {
+    AnalyticsTotals t = snapshot();
+    if (t.matches == lastMatches) return;
+    lastMatches = t.matches;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::ostringstream row;
+    row.precision(6);
+    if (csv) {
+        row << seconds << ',' << t.matches << ',' << rate(t.wins, t.matches) << ','
+            << rate(t.draws, t.matches) << ',' << rate(t.losses, t.matches);
+        for (int w = 0; w < ANALYTICS_WINDOWS; ++w) row << ',' << t.ewmaWin[w];
+        row << ',' << rate(t.firstMoverWins, t.matches) << ',' << rate(t.secondMoverWins, t.matches);
+        for (int r = 0; r < RULE_COUNT; ++r) row << ',' << rate(t.rulesFired[r], t.matches);
+        for (int i = 0; i < ANALYTICS_WEIGHTS; ++i) row << ',' << t.weights[i];
+    }
+    else {
+        row << "{\"seconds\":" << seconds << ",\"matches\":" << t.matches
+            << ",\"win\":" << rate(t.wins, t.matches) << ",\"draw\":" << rate(t.draws, t.matches)
+            << ",\"loss\":" << rate(t.losses, t.matches) << ",\"ewma\":{";
+        for (int w = 0; w < ANALYTICS_WINDOWS; ++w)
+            row << (w ? "," : "") << '"' << AnalyticsTotals::window(w) << "\":" << t.ewmaWin[w];
+        row << "},\"firstMoverWin\":" << rate(t.firstMoverWins, t.matches)
+            << ",\"secondMoverWin\":" << rate(t.secondMoverWins, t.matches) << ",\"firedPerMatch\":{";
+        for (int r = 0; r < RULE_COUNT; ++r)
+            row << (r ? "," : "") << '"' << RULE_LABELS[r] << "\":" << rate(t.rulesFired[r], t.matches);
+        row << "},\"weights\":{";
+        for (int i = 0; i < ANALYTICS_WEIGHTS; ++i)
+            row << (i ? "," : "") << '"' << (i + 1) << "\":" << t.weights[i];
+        row << "}}";
+    }
+    out << row.str() << "\n" << std::flush;
+    if (!out.good())
+        std::cerr << "[WARN] Cannot write training analytics\n";
+}
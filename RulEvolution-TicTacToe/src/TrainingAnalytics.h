@@ -0,0 +1,134 @@
+#ifndef TRAININGANALYTICS_H
+#define TRAININGANALYTICS_H
+
+#include "GameHistory.h"
+#include "LearningModule.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int ANALYTICS_WINDOWS = 3;                 ///< EWMA windows: 100, 1000, 10000 matches
+const int ANALYTICS_WEIGHTS = RULE_COUNT - 1;    ///< Adaptive weights (RULE_BLOCK .. RULE_PREPARATION)
+
+/**
+ * @struct AnalyticsTotals
+ * @brief Online, mergeable training statistics of one stream of matches.
+ *
+ * Fixed size whatever the number of matches: outcome counts, first-mover
+ * counts, rule firings, one exponentially weighted win rate per window and
+ * the latest weights of the learner.
+ */
+struct AnalyticsTotals {
+    unsigned long long matches = 0;
+    unsigned long long wins = 0;             ///< Won by the learning side
+    unsigned long long draws = 0;
+    unsigned long long losses = 0;
+    unsigned long long firstMoverWins = 0;   ///< Won by the player who moved first
+    unsigned long long secondMoverWins = 0;  ///< Won by the player who moved second
+    unsigned long long rulesFired[RULE_COUNT] = {};
+    double ewmaWin[ANALYTICS_WINDOWS] = {};  ///< EWMA (alpha = 1/window) of the learning side's win indicator
+    double weights[ANALYTICS_WEIGHTS] = {};  ///< Latest adaptive weights (rule - 1)
+    unsigned long long weightSources = 0;    ///< Learners averaged into weights (0 = none yet)
+
+    /// Matches covered by each EWMA window.
+    static int window(int i) { return i == 0 ? 100 : (i == 1 ? 1000 : 10000); }
+
+    /**
+     * @brief Account one finished match.
+     * @param learnerSide Side ('X' or 'O') whose wins and losses are counted.
+     */
+    void record(const GameHistory& history, char learnerSide);
+
+    /// Replace the weight sample with the learner's current weights.
+    void sampleWeights(const LearningModule& learner);
+
+    /**
+     * @brief Fold another stream in: counts add up, EWMAs are averaged
+     *        weighted by matches and weights by the number of learners.
+     */
+    void merge(const AnalyticsTotals& other);
+};
+
+/**
+ * @struct AnalyticsShard
+ * @brief One worker's published totals behind a sequence lock: the owner
+ *        publishes without blocking, readers retry on a torn copy.
+ */
+struct alignas(64) AnalyticsShard {
+    std::atomic<unsigned> sequence{ 0 };
+    std::atomic<unsigned long long> words[(sizeof(AnalyticsTotals) + 7) / 8];
+
+    AnalyticsShard();
+
+    /// Publish a new value (single writer: the shard owner).
+    void publish(const AnalyticsTotals& totals);
+
+    /// Consistent copy of the last published value.
+    AnalyticsTotals read() const;
+};
+
+/**
+ * @class TrainingAnalytics
+ * @brief Streaming training analytics with O(1) memory.
+ *
+ * Every Super-Training worker accumulates an AnalyticsTotals privately and
+ * publishes it to its own shard every PUBLISH_EVERY matches; a background
+ * thread merges the shards each interval and appends one row to a time
+ * series (CSV if the file name ends in ".csv", JSON lines otherwise). The
+ * match loop never takes a lock and memory does not grow with the run.
+ */
+class TrainingAnalytics {
+public:
+    static const int PUBLISH_EVERY = 256;
+
+    TrainingAnalytics() = default;
+    ~TrainingAnalytics() { stop(); }
+    TrainingAnalytics(const TrainingAnalytics&) = delete;
+    TrainingAnalytics& operator=(const TrainingAnalytics&) = delete;
+
+    /**
+     * @brief Start appending rows to a file.
+     * @return false if the file cannot be opened.
+     */
+    bool start(const std::string& path, double intervalSeconds);
+
+    /// Stop the thread and write a final row.
+    void stop();
+
+    /**
+     * @brief Make sure shards 0..workers-1 exist (call before the workers start).
+     * @return The shards, indexed by worker.
+     */
+    std::vector<AnalyticsShard*> shards(int workers);
+
+    /// Publish the merged learner's weights to every shard (call after the workers joined).
+    void publishWeights(const LearningModule& learner);
+
+    /// Merge of all shards (lock-free for the workers).
+    AnalyticsTotals snapshot() const;
+
+private:
+    void writeRow();
+
+    std::vector<std::unique_ptr<AnalyticsShard>> shardList;
+    mutable std::mutex shardsMtx;  ///< Guards the shard list only, never the shard contents
+
+    std::ofstream out;
+    bool csv = false;
+    double interval = 1.0;
+    bool running = false;
+    unsigned long long lastMatches = ~0ULL;
+    std::chrono::steady_clock::time_point startTime;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+#endif // TRAININGANALYTICS_H
@@ -0,0 +1,563 @@
+// ================================================================
+//  Trajectory.cpp — Compressed weight-trajectory store
+//  Notes:
+//    - every chunk restarts its deltas from zero, so a range query
+//      decodes only the chunks it overlaps, in any order;
+//    - chunks are reserved with one atomic add and written with
+//      positional I/O, header (with the payload checksum) last;
+//    - the reader skips a torn or never-written chunk by looking for the
+//      next valid header on the 8-byte grid;
+//    - integers use the host byte order, like the other binary files.
+// ================================================================
+#include "Trajectory.h"
+#include "Checkpoint.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const char FILE_MAGIC[8] = { 'R', 'U', 'L', 'E', 'V', 'T', 'R', 'J' };
+    const std::uint32_t CHUNK_MAGIC = 0x4B484354;  // "TCHK"
+
+    struct TrajectoryFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t ruleCount;
+        std::uint32_t reserved[12];
+    };
+    static_assert(sizeof(TrajectoryFileHeader) == 64, "TrajectoryFileHeader layout");
+
+    struct ChunkHeader {
+        std::uint32_t magic;
+        std::uint32_t count;
+        std::uint32_t source;
+        std::uint32_t bytes;
+        std::uint64_t firstStep;
+        std::uint64_t lastStep;
+        std::uint64_t firstMicros;
+        std::uint64_t lastMicros;
+        std::uint64_t checksum;  ///< FNV-1a 64 of the payload
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(ChunkHeader) == 64, "ChunkHeader layout");
+
+    const std::uint32_t WEIGHT_BITS = RULE_COUNT;       // change mask: counters first, weights above,
+    const std::uint32_t RATE_BIT = 2 * RULE_COUNT;      // then the learning rate
+    const unsigned char RAW_COUNTER = 1;                // tag of a counter stored as a double XOR
+    const unsigned char ZERO_XOR = 7 << 3 | 7;          // shape byte of an exact prediction
+
+    std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~static_cast<std::size_t>(7); }
+
+    std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+    std::int64_t unzigzag(std::uint64_t v) {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    std::uint64_t bitsOf(double d) {
+        std::uint64_t b;
+        std::memcpy(&b, &d, sizeof(b));
+        return b;
+    }
+    double fromBits(std::uint64_t b) {
+        double d;
+        std::memcpy(&d, &b, sizeof(d));
+        return d;
+    }
+
+    /// Integral and exactly representable as a difference of two int64.
+    bool integral(double d) {
+        return std::floor(d) == d && std::fabs(d) < 4.0e15;
+    }
+
+    /// Predictions of a new weight: unchanged, one step up, one step down.
+    enum Prediction { KEEP = 0, STEP_UP, STEP_DOWN, PREDICTIONS };
+
+    /// Old weight moved by one learning step (clamped like LearningModule).
+    double moved(double old, double rate, int kind) {
+        if (kind == STEP_UP) return std::min(1.0, old + rate);
+        if (kind == STEP_DOWN) return std::max(0.0, old - rate);
+        return old;
+    }
+
+    /**
+     * Prediction of every weight after one update: the old weights moved by
+     * their kind (2 bits per rule in `kinds`), then normalized to sum 1 in
+     * rule order, as LearningModule::normalizeWeights() does.
+     */
+    RuleArray predictWeights(const RuleArray& old, unsigned changed, std::uint64_t kinds, double rate) {
+        RuleArray p = old;
+        double sum = 0.0;
+        for (int r = 0; r < RULE_COUNT; ++r) {
+            if ((changed >> r) & 1) p[r] = moved(old[r], rate, static_cast<int>((kinds >> (2 * r)) & 3));
+            sum += p[r];
+        }
+        if (sum > 0.0)
+            for (int r = 0; r < RULE_COUNT; ++r)
+                if ((changed >> r) & 1) p[r] /= sum;
+        return p;
+    }
+
+    /// XOR of two doubles without its zero leading and trailing bytes: a shape
+    /// byte (leading and trailing byte counts), then the rest.
+    void putXor(std::string& out, std::uint64_t x) {
+        if (x == 0) {
+            out.push_back(static_cast<char>(ZERO_XOR));
+            return;
+        }
+        int lead = 0, trail = 0;
+        while (lead < 7 && !((x >> (8 * (7 - lead))) & 0xFF)) ++lead;
+        while (trail < 7 - lead && !((x >> (8 * trail)) & 0xFF)) ++trail;
+        out.push_back(static_cast<char>(lead << 3 | trail));
+        for (int b = trail; b < 8 - lead; ++b) out.push_back(static_cast<char>(x >> (8 * b)));
+    }
+
+    void putVarint(std::string& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    /// Bounds-checked cursor over an encoded chunk.
+    struct Cursor {
+        const unsigned char* p;
+        const unsigned char* end;
+        bool ok = true;
+
+        std::uint64_t varint() {
+            std::uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p == end) break;
+                unsigned char b = *p++;
+                v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            ok = false;
+            return 0;
+        }
+
+        unsigned char byte() {
+            if (p == end) { ok = false; return 0; }
+            return *p++;
+        }
+
+        std::uint64_t xorBits() {
+            unsigned char shape = byte();
+            if (shape == ZERO_XOR) return 0;
+            int lead = (shape >> 3) & 7, trail = shape & 7;
+            if (lead + trail > 7 || (shape >> 6) != 0) { ok = false; return 0; }
+            std::uint64_t x = 0;
+            for (int b = trail; b < 8 - lead; ++b) x |= static_cast<std::uint64_t>(byte()) << (8 * b);
+            return x;
+        }
+    };
+
+    bool validChunk(const unsigned char* base, std::size_t size, std::size_t off, ChunkHeader& h) {
+        std::memcpy(&h, base + off, sizeof(h));
+        if (h.magic != CHUNK_MAGIC || h.count == 0 || h.count > Trajectory::CHUNK_SAMPLES) return false;
+        if (h.firstStep > h.lastStep || off + sizeof(h) + h.bytes > size) return false;
+        const char* payload = reinterpret_cast<const char*>(base + off + sizeof(h));
+        return Checkpoint::hash(std::string(payload, h.bytes)) == h.checksum;
+    }
+
+} // namespace
+
+// --- Trajectory ---------------------------------------------------------------
+
+Trajectory::Trajectory()
+    : learnerSamples(new TrajectoryWriter(*this, LEARNER)) {
+}
+
+Trajectory::~Trajectory() {
+    close();
+}
+
+std::uint64_t Trajectory::nowMicros() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool Trajectory::open(const std::string& filename, int interval) {
+    close();
+    every = std::max(interval, 1);
+    std::uint64_t size = 0;
+#ifdef _WIN32
+    HANDLE h = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    handle = h;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(h, &sz)) { close(); return false; }
+    size = static_cast<std::uint64_t>(sz.QuadPart);
+#else
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+    size = static_cast<std::uint64_t>(st.st_size);
+#endif
+
+    stepBase = 0;
+    learnerWeight.fill(0.0);
+    learnerCounter.fill(0.0);
+    learnerRate = 0.0;
+    if (size == 0) {
+        TrajectoryFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = VERSION;
+        header.ruleCount = RULE_COUNT;
+        if (!writeAt(0, &header, sizeof(header))) { close(); return false; }
+        end.store(sizeof(header));
+        return true;
+    }
+
+    // Continue after the last chunk, at the last recorded step and learner state.
+    TrajectoryReader existing;
+    if (!existing.open(filename)) {
+        std::cerr << "[ERROR] " << filename << " is not a trajectory of this version\n";
+        close();
+        return false;
+    }
+    stepBase = existing.lastStep();
+    std::vector<TrajectorySample> last;
+    if (existing.query(TRAJECTORY_STEP, stepBase, stepBase, last, LEARNER) > 0) {
+        learnerWeight = last.back().weight;
+        learnerCounter = last.back().counter;
+        learnerRate = last.back().learningRate;
+    }
+    end.store(padded(static_cast<std::size_t>(size)));
+    return true;
+}
+
+void Trajectory::close() {
+    if (isOpen()) flush();
+#ifdef _WIN32
+    if (handle) CloseHandle(static_cast<HANDLE>(handle));
+    handle = nullptr;
+#else
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+}
+
+bool Trajectory::isOpen() const {
+#ifdef _WIN32
+    return handle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+void Trajectory::recordLearner(const LearningModule& learner, long long matches) {
+    if (!isOpen()) return;
+    if (matches > 0) stepBase += static_cast<std::uint64_t>(matches);
+    learnerSamples->sample(learner, stepBase);
+    learnerWeight = learner.weights();
+    learnerCounter = learner.counters();
+    learnerRate = learner.getLearningRate();
+}
+
+bool Trajectory::learnerChanged(const LearningModule& learner) const {
+    return learner.weights() != learnerWeight || learner.counters() != learnerCounter
+        || learner.getLearningRate() != learnerRate;
+}
+
+bool Trajectory::flush() {
+    return learnerSamples->flush();
+}
+
+bool Trajectory::writeAt(std::uint64_t offset, const void* data, std::size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(offset);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD put = 0;
+        if (!WriteFile(static_cast<HANDLE>(handle), p, static_cast<DWORD>(size), &put, &ov) || put == 0)
+            return false;
+#else
+        ssize_t put = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (put <= 0) return false;
+#endif
+        p += put;
+        offset += static_cast<std::uint64_t>(put);
+        size -= static_cast<std::size_t>(put);
+    }
+    return true;
+}
+
+bool Trajectory::appendChunk(std::uint32_t source, std::uint32_t count,
+    std::uint64_t firstStep, std::uint64_t lastStep,
+    std::uint64_t firstMicros, std::uint64_t lastMicros, const std::string& payload) {
+    if (!isOpen() || count == 0 || count > CHUNK_SAMPLES) return false;
+    TraceSpan span(TRACE_IO);
+    std::uint64_t base = end.fetch_add(sizeof(ChunkHeader) + padded(payload.size()));
+
+    ChunkHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = CHUNK_MAGIC;
+    header.count = count;
+    header.source = source;
+    header.bytes = static_cast<std::uint32_t>(payload.size());
+    header.firstStep = firstStep;
+    header.lastStep = lastStep;
+    header.firstMicros = firstMicros;
+    header.lastMicros = lastMicros;
+    header.checksum = Checkpoint::hash(payload);
+    return writeAt(base + sizeof(header), payload.data(), payload.size())
+        && writeAt(base, &header, sizeof(header));
+}
+
+// --- TrajectoryWriter -----------------------------------------------------------
+
+TrajectoryWriter::TrajectoryWriter(Trajectory& target, std::uint32_t src)
+    : trajectory(target), source(src) {
+    payload.reserve(Trajectory::CHUNK_SAMPLES * 8);
+}
+
+void TrajectoryWriter::sample(const LearningModule& learner, std::uint64_t step) {
+    if (count == Trajectory::CHUNK_SAMPLES) flush();
+    std::uint64_t micros = Trajectory::nowMicros();
+    if (count == 0) {
+        firstStep = step;
+        firstMicros = micros;
+    }
+
+    putVarint(payload, zigzag(static_cast<std::int64_t>(step - lastStep)));
+    putVarint(payload, zigzag(static_cast<std::int64_t>(micros - lastMicros)));
+    lastStep = step;
+    lastMicros = micros;
+
+    const RuleArray& w = learner.weights();
+    const RuleArray& c = learner.counters();
+    const double eta = learner.getLearningRate();
+    std::uint64_t mask = 0;
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (bitsOf(c[r]) != bitsOf(counter[r])) mask |= 1ull << r;
+        if (bitsOf(w[r]) != bitsOf(weight[r])) mask |= 1ull << (WEIGHT_BITS + r);
+    }
+    if (bitsOf(eta) != bitsOf(rate)) mask |= 1ull << RATE_BIT;
+    putVarint(payload, mask);
+    if ((mask >> RATE_BIT) & 1) {
+        putXor(payload, bitsOf(eta) ^ bitsOf(rate));
+        rate = eta;
+    }
+
+    for (int r = 0; r < RULE_COUNT; ++r) {
+        if (!((mask >> r) & 1)) continue;
+        if (integral(c[r]) && integral(counter[r])) {
+            std::int64_t diff = static_cast<std::int64_t>(c[r]) - static_cast<std::int64_t>(counter[r]);
+            putVarint(payload, zigzag(diff) << 1);
+        }
+        else {
+            std::uint64_t x = bitsOf(c[r]) ^ bitsOf(counter[r]);
+            payload.push_back(static_cast<char>(RAW_COUNTER));
+            for (int b = 0; b < 8; ++b) payload.push_back(static_cast<char>(x >> (8 * b)));
+        }
+        counter[r] = c[r];
+    }
+
+    // Weights change by threshold crossings followed by a normalization: the
+    // sample stores which rules moved up or down one learning step, and each
+    // weight as the XOR with the weight that replaying that update predicts
+    // (zero, i.e. one byte, when the replay is exact).
+    unsigned changed = static_cast<unsigned>((mask >> WEIGHT_BITS) & ((1u << RULE_COUNT) - 1));
+    if (changed) {
+        // The kinds come from the scale of the normalization, estimated with
+        // the changed weight that explains the most others unmoved.
+        double scale = 0.0;
+        int bestHits = -1;
+        for (int k = 0; k < RULE_COUNT; ++k) {
+            if (!((changed >> k) & 1) || !(weight[k] > 0.0)) continue;
+            double ratio = w[k] / weight[k];
+            int hits = 0;
+            for (int r = 0; r < RULE_COUNT; ++r)
+                if (((changed >> r) & 1) && std::fabs(weight[r] * ratio - w[r]) <= 1e-12) ++hits;
+            if (hits > bestHits) { bestHits = hits; scale = ratio; }
+        }
+        std::uint64_t kinds = 0;
+        for (int r = 0; r < RULE_COUNT; ++r) {
+            if (!((changed >> r) & 1) || !(scale > 0.0)) continue;
+            int best = KEEP;
+            for (int kind = STEP_UP; kind < PREDICTIONS; ++kind)
+                if (std::fabs(moved(weight[r], rate, kind) * scale - w[r])
+                    < std::fabs(moved(weight[r], rate, best) * scale - w[r]))
+                    best = kind;
+            kinds |= static_cast<std::uint64_t>(best) << (2 * r);
+        }
+        RuleArray predicted = predictWeights(weight, changed, kinds, rate);
+        bool exact = true;
+        for (int r = 0; r < RULE_COUNT; ++r)
+            if (((changed >> r) & 1) && bitsOf(w[r]) != bitsOf(predicted[r])) exact = false;
+        putVarint(payload, kinds << 1 | (exact ? 1u : 0u));
+        if (!exact)
+            for (int r = 0; r < RULE_COUNT; ++r)
+                if ((changed >> r) & 1) putXor(payload, bitsOf(w[r]) ^ bitsOf(predicted[r]));
+        weight = w;
+    }
+    ++count;
+}
+
+bool TrajectoryWriter::flush() {
+    if (count == 0) return true;
+    bool ok = trajectory.appendChunk(source, count, firstStep, lastStep, firstMicros, lastMicros, payload);
+    if (!ok) std::cerr << "[WARN] Cannot write " << count << " samples to the trajectory\n";
+    payload.clear();
+    count = 0;
+    lastStep = lastMicros = 0;
+    weight.fill(0.0);
+    counter.fill(0.0);
+    rate = 0.0;
+    return ok;
+}
+
+// --- TrajectoryReader -----------------------------------------------------------
+
+bool TrajectoryReader::open(const std::string& filename) {
+    chunks.clear();
+    samples = 0;
+    maxStep = 0;
+    if (!file.open(filename) || file.size() < sizeof(TrajectoryFileHeader)) return false;
+
+    TrajectoryFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || header.version != Trajectory::VERSION || header.ruleCount != RULE_COUNT) {
+        file.close();
+        return false;
+    }
+
+    // Walk the chunk headers; a slot that holds no valid chunk is skipped on the 8-byte grid.
+    std::size_t off = sizeof(TrajectoryFileHeader);
+    while (off + sizeof(ChunkHeader) <= file.size()) {
+        ChunkHeader h;
+        if (!validChunk(file.data(), file.size(), off, h)) {
+            off += 8;
+            continue;
+        }
+        TrajectoryChunk c;
+        c.offset = off;
+        c.source = h.source;
+        c.count = h.count;
+        c.bytes = h.bytes;
+        c.firstStep = h.firstStep;
+        c.lastStep = h.lastStep;
+        c.firstMicros = h.firstMicros;
+        c.lastMicros = h.lastMicros;
+        chunks.push_back(c);
+        samples += h.count;
+        maxStep = std::max(maxStep, h.lastStep);
+        off += sizeof(ChunkHeader) + padded(h.bytes);
+    }
+    buildIndex(TRAJECTORY_STEP);
+    buildIndex(TRAJECTORY_TIME);
+    return true;
+}
+
+void TrajectoryReader::buildIndex(TrajectoryAxis axis) {
+    AxisIndex& ix = index[axis];
+    auto first = [&](std::uint32_t i) { return axis == TRAJECTORY_STEP ? chunks[i].firstStep : chunks[i].firstMicros; };
+    auto last = [&](std::uint32_t i) { return axis == TRAJECTORY_STEP ? chunks[i].lastStep : chunks[i].lastMicros; };
+
+    ix.order.resize(chunks.size());
+    for (std::uint32_t i = 0; i < ix.order.size(); ++i) ix.order[i] = i;
+    std::stable_sort(ix.order.begin(), ix.order.end(),
+        [&](std::uint32_t a, std::uint32_t b) { return first(a) < first(b); });
+
+    ix.first.resize(chunks.size());
+    ix.maxLast.resize(chunks.size());
+    std::uint64_t running = 0;
+    for (std::size_t k = 0; k < ix.order.size(); ++k) {
+        ix.first[k] = first(ix.order[k]);
+        running = std::max(running, last(ix.order[k]));
+        ix.maxLast[k] = running;
+    }
+}
+
+bool TrajectoryReader::decode(std::size_t i, std::vector<TrajectorySample>& out) const {
+    const TrajectoryChunk& c = chunks[i];
+    Cursor in;
+    in.p = file.data() + c.offset + sizeof(ChunkHeader);
+    in.end = in.p + c.bytes;
+
+    TrajectorySample s;
+    s.source = c.source;
+    for (std::uint32_t k = 0; k < c.count && in.ok; ++k) {
+        s.step += static_cast<std::uint64_t>(unzigzag(in.varint()));
+        s.micros += static_cast<std::uint64_t>(unzigzag(in.varint()));
+        std::uint64_t mask = in.varint();
+        if (mask >> (RATE_BIT + 1)) { in.ok = false; break; }
+        if ((mask >> RATE_BIT) & 1)
+            s.learningRate = fromBits(bitsOf(s.learningRate) ^ in.xorBits());
+
+        for (int r = 0; r < RULE_COUNT; ++r) {
+            if (!((mask >> r) & 1)) continue;
+            std::uint64_t v = in.varint();
+            if (v & RAW_COUNTER) {
+                std::uint64_t x = 0;
+                for (int b = 0; b < 8; ++b) x |= static_cast<std::uint64_t>(in.byte()) << (8 * b);
+                s.counter[r] = fromBits(bitsOf(s.counter[r]) ^ x);
+            }
+            else {
+                s.counter[r] = static_cast<double>(static_cast<std::int64_t>(s.counter[r]) + unzigzag(v >> 1));
+            }
+        }
+        unsigned changed = static_cast<unsigned>((mask >> WEIGHT_BITS) & ((1u << RULE_COUNT) - 1));
+        if (changed) {
+            std::uint64_t kinds = in.varint();
+            RuleArray predicted = predictWeights(s.weight, changed, kinds >> 1, s.learningRate);
+            for (int r = 0; r < RULE_COUNT; ++r)
+                if ((changed >> r) & 1)
+                    s.weight[r] = (kinds & 1) ? predicted[r] : fromBits(bitsOf(predicted[r]) ^ in.xorBits());
+        }
+        if (in.ok) out.push_back(s);
+    }
+    return in.ok && in.p == in.end;
+}
+
+std::size_t TrajectoryReader::query(TrajectoryAxis axis, std::uint64_t from, std::uint64_t to,
+    std::vector<TrajectorySample>& out, long long source) const {
+    if (from > to) return 0;
+    const AxisIndex& ix = index[axis];
+
+    // Candidates: chunks starting at or before `to` whose range (or an earlier one) reaches `from`.
+    std::size_t lo = std::lower_bound(ix.maxLast.begin(), ix.maxLast.end(), from) - ix.maxLast.begin();
+    std::size_t hi = std::upper_bound(ix.first.begin(), ix.first.end(), to) - ix.first.begin();
+
+    std::vector<TrajectorySample> found, decoded;
+    for (std::size_t k = lo; k < hi; ++k) {
+        const TrajectoryChunk& c = chunks[ix.order[k]];
+        std::uint64_t last = axis == TRAJECTORY_STEP ? c.lastStep : c.lastMicros;
+        if (last < from) continue;
+        if (source >= 0 && c.source != static_cast<std::uint32_t>(source)) continue;
+        decoded.clear();
+        decode(ix.order[k], decoded);
+        for (const TrajectorySample& s : decoded) {
+            std::uint64_t v = axis == TRAJECTORY_STEP ? s.step : s.micros;
+            if (v >= from && v <= to) found.push_back(s);
+        }
+    }
+    std::stable_sort(found.begin(), found.end(), [](const TrajectorySample& a, const TrajectorySample& b) {
+        return a.step != b.step ? a.step < b.step : a.source < b.source;
+    });
+    out.insert(out.end(), found.begin(), found.end());
+    return found.size();
+}
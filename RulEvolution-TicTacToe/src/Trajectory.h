@@ -0,0 +1,218 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "LearningModule.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TrajectorySample
+ * @brief Learner state at one point of a run.
+ */
+struct TrajectorySample {
+    std::uint64_t step = 0;    ///< Matches (or replayed games) learned before the sample
+    std::uint64_t micros = 0;  ///< Wall clock, microseconds since the Unix epoch
+    std::uint32_t source = 0;  ///< Worker index, or Trajectory::LEARNER for the merged learner
+    RuleArray weight{};        ///< Weight of every rule (0 for unused rules)
+    RuleArray counter{};       ///< Evidence counter of every rule
+    double learningRate = 0.0; ///< Step applied at a threshold crossing
+};
+
+/**
+ * @enum TrajectoryAxis
+ * @brief Axis of a trajectory range query.
+ */
+enum TrajectoryAxis {
+    TRAJECTORY_STEP = 0,  ///< TrajectorySample::step
+    TRAJECTORY_TIME       ///< TrajectorySample::micros
+};
+
+class TrajectoryWriter;
+
+/**
+ * @class Trajectory
+ * @brief Append-only, compressed time series of learner states.
+ *
+ * The file is a 64-byte header followed by self-contained chunks of up to
+ * CHUNK_SAMPLES samples of one source: a 64-byte chunk header (source,
+ * sample count, step and time range, checksum) and the samples, each
+ * delta-encoded against the previous one of the chunk:
+ *  - step and time as zigzag varints;
+ *  - a varint bitmask of the counters (bits 0-5), weights (bits 6-11) and
+ *    learning rate (bit 12) that changed;
+ *  - per changed counter, the integral difference as a varint (or the
+ *    XOR of the two doubles when either is not integral);
+ *  - if weights changed, which ones moved one learning step up or down
+ *    and whether replaying that update (steps, then normalization)
+ *    predicts every weight exactly; if not, per changed weight the XOR
+ *    with its prediction without its zero leading and trailing bytes.
+ * A sample is about 8 bytes, one after a threshold crossing included.
+ *
+ * Writers reserve a chunk with one atomic add and write it at its offset,
+ * header last, like GameLog; the chunk headers form the time index that
+ * TrajectoryReader builds when it maps the file.
+ */
+class Trajectory {
+public:
+    static const std::uint32_t VERSION = 1;
+    static const std::uint32_t CHUNK_SAMPLES = 4096;   ///< Samples per chunk at most
+    static const std::uint32_t LEARNER = 0xFFFFFFFFu;  ///< Source of the merged learner's samples
+
+    Trajectory();
+    ~Trajectory();
+    Trajectory(const Trajectory&) = delete;
+    Trajectory& operator=(const Trajectory&) = delete;
+
+    /**
+     * @brief Open a trajectory for appending, creating it if needed. An
+     *        existing file continues at its last step.
+     * @param interval Matches between two worker samples.
+     * @return false if the file cannot be opened or is not a trajectory.
+     */
+    bool open(const std::string& filename, int interval);
+
+    /// Flush the learner samples and close the file (worker writers must be flushed first).
+    void close();
+
+    bool isOpen() const;
+
+    int interval() const { return every; }
+
+    /// Step of the latest learner sample: the matches a worker sample counts from.
+    std::uint64_t step() const { return stepBase; }
+
+    /**
+     * @brief Advance the step by `matches` and sample the learner (after a
+     *        merge or any other change of the learner; main thread only).
+     */
+    void recordLearner(const LearningModule& learner, long long matches = 0);
+
+    /// True if the learner differs from its latest sample.
+    bool learnerChanged(const LearningModule& learner) const;
+
+    /// Write the buffered learner samples. @return false on I/O error.
+    bool flush();
+
+    /**
+     * @brief Write one encoded chunk at the next free offset (thread-safe).
+     * @return false on I/O error.
+     */
+    bool appendChunk(std::uint32_t source, std::uint32_t count,
+        std::uint64_t firstStep, std::uint64_t lastStep,
+        std::uint64_t firstMicros, std::uint64_t lastMicros, const std::string& payload);
+
+    /// Wall clock in microseconds since the Unix epoch.
+    static std::uint64_t nowMicros();
+
+private:
+    bool writeAt(std::uint64_t offset, const void* data, std::size_t size);
+
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+    std::atomic<std::uint64_t> end{ 0 };  ///< Next free byte
+    int every = 1;                        ///< Matches between two worker samples
+    std::uint64_t stepBase = 0;           ///< Step of the latest learner sample
+    RuleArray learnerWeight{};            ///< Latest learner sample
+    RuleArray learnerCounter{};
+    double learnerRate = 0.0;
+    std::unique_ptr<TrajectoryWriter> learnerSamples;
+};
+
+/**
+ * @class TrajectoryWriter
+ * @brief Per-thread encoder in front of a Trajectory: samples of one source
+ *        are delta-encoded into a private chunk, written when it is full.
+ */
+class TrajectoryWriter {
+public:
+    TrajectoryWriter(Trajectory& trajectory, std::uint32_t source);
+    ~TrajectoryWriter() { flush(); }
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /// Record the state of `learner` at `step`.
+    void sample(const LearningModule& learner, std::uint64_t step);
+
+    /// Write the partial chunk (if any).
+    bool flush();
+
+private:
+    Trajectory& trajectory;
+    std::uint32_t source;
+    std::string payload;                      ///< Encoded samples of the open chunk
+    std::uint32_t count = 0;                  ///< Samples in the open chunk
+    std::uint64_t firstStep = 0, firstMicros = 0;
+    std::uint64_t lastStep = 0, lastMicros = 0;
+    RuleArray weight{};                       ///< Previous sample (zero at chunk start)
+    RuleArray counter{};
+    double rate = 0.0;
+};
+
+/**
+ * @struct TrajectoryChunk
+ * @brief Index entry of one chunk of a mapped trajectory.
+ */
+struct TrajectoryChunk {
+    std::size_t offset = 0;      ///< Offset of the chunk header
+    std::uint32_t source = 0;    ///< Worker index or Trajectory::LEARNER
+    std::uint32_t count = 0;     ///< Samples
+    std::uint32_t bytes = 0;     ///< Encoded size of the samples
+    std::uint64_t firstStep = 0, lastStep = 0;
+    std::uint64_t firstMicros = 0, lastMicros = 0;
+};
+
+/**
+ * @class TrajectoryReader
+ * @brief Memory-mapped reader with a step and a time index over the chunks:
+ *        a range query decodes only the chunks that overlap the range.
+ */
+class TrajectoryReader {
+public:
+    /**
+     * @brief Map a trajectory and index its valid chunks.
+     * @return false if the file is missing or is not a trajectory.
+     */
+    bool open(const std::string& filename);
+
+    std::size_t chunkCount() const { return chunks.size(); }
+    std::uint64_t sampleCount() const { return samples; }
+    const TrajectoryChunk& chunk(std::size_t i) const { return chunks[i]; }
+    std::uint64_t lastStep() const { return maxStep; }
+    std::size_t byteSize() const { return file.size(); }
+
+    /// Decode chunk `i`, appending its samples to `out`. @return false if it is corrupt.
+    bool decode(std::size_t i, std::vector<TrajectorySample>& out) const;
+
+    /**
+     * @brief Samples with `from <= step (or micros) <= to`, ordered by step
+     *        then source (the learner sample of a step comes last).
+     * @param source Only this source; Trajectory::LEARNER, a worker, or -1 for all.
+     * @return Number of samples appended to `out`.
+     */
+    std::size_t query(TrajectoryAxis axis, std::uint64_t from, std::uint64_t to,
+        std::vector<TrajectorySample>& out, long long source = -1) const;
+
+private:
+    /// Chunks sorted by first value, with the running maximum of the last value.
+    struct AxisIndex {
+        std::vector<std::uint32_t> order;
+        std::vector<std::uint64_t> first;
+        std::vector<std::uint64_t> maxLast;
+    };
+    void buildIndex(TrajectoryAxis axis);
+
+    MappedFile file;
+    std::vector<TrajectoryChunk> chunks;
+    AxisIndex index[2];
+    std::uint64_t samples = 0;
+    std::uint64_t maxStep = 0;
+};
+
+#endif // TRAJECTORY_H
@@ -0,0 +1,283 @@
+// ================================================================
+//  WeightStore.cpp — Shared live weights with hot reload
+//  Notes:
+//    - the seqlock words are std::atomic<uint64_t>, address-free when
+//      lock-free, so the same protocol works across processes;
+//    - a zero-filled (new) file is a valid empty store: readers may map
+//      it before the first publish;
+//    - nothing waits forever on another process: an odd sequence or a
+//      claimed magic unchanged for STALE_AFTER is taken over.
+// ================================================================
+#include "WeightStore.h"
+#include "LearningModule.h"
+#include "WeightsIO.h"
+#include "ThreadContext.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "the shared segment needs lock-free 64-bit atomics");
+
+namespace {
+
+const std::uint64_t SEGMENT_MAGIC = 0x5354574C56454C52ull;  // "RLEVLWTS"
+const std::uint64_t SEGMENT_CLAIMED = 1;                     // magic while a creator writes the header
+const std::uint32_t SEGMENT_VERSION = 1;
+const std::chrono::milliseconds STALE_AFTER(500);            // a publish takes well under a microsecond
+const int READ_ATTEMPTS = 1024;                               // copies tried before read() gives up
+
+/// Wait until `word` leaves `value`; false if it still holds it after STALE_AFTER.
+bool waitForChange(const std::atomic<std::uint64_t>& word, std::uint64_t value) {
+    auto deadline = std::chrono::steady_clock::now() + STALE_AFTER;
+    while (word.load(std::memory_order_acquire) == value) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void initialize(WeightSegment& s) {
+    s.version = SEGMENT_VERSION;
+    s.capacity = WEIGHT_STORE_CAPACITY;
+    s.magic.store(SEGMENT_MAGIC, std::memory_order_release);
+}
+
+/**
+ * @brief Initialize a zero-filled segment once: the creator that claims the
+ *        magic writes the header, concurrent creators wait for it (and write
+ *        the same constants themselves if it died).
+ */
+void initializeOnce(WeightSegment& s) {
+    std::uint64_t expected = 0;
+    if (s.magic.compare_exchange_strong(expected, SEGMENT_CLAIMED, std::memory_order_acquire)
+        || (expected == SEGMENT_CLAIMED && !waitForChange(s.magic, SEGMENT_CLAIMED)))
+        initialize(s);
+}
+
+/**
+ * @brief Close a publish abandoned at odd sequence `odd`. Its words may be
+ *        torn, so it becomes an empty generation that readers skip.
+ * @return false if someone else moved the sequence first.
+ */
+bool abandon(WeightSegment& s, std::uint64_t odd) {
+    if (!s.sequence.compare_exchange_strong(odd, odd + 2, std::memory_order_acquire, std::memory_order_relaxed))
+        return false;
+    s.count.store(0, std::memory_order_relaxed);
+    s.sequence.store(odd + 3, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t toBits(double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+bool WeightStore::open(const std::string& path) {
+    segment = nullptr;
+    local.reset();
+    if (!mapping.openShared(path, sizeof(WeightSegment))) {
+        std::cerr << "[ERROR] Cannot map weight store " << path << "\n";
+        return false;
+    }
+    WeightSegment* s = reinterpret_cast<WeightSegment*>(mapping.mutableData());
+    initializeOnce(*s);
+    if (s->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC
+        || s->version != SEGMENT_VERSION || s->capacity != WEIGHT_STORE_CAPACITY) {
+        std::cerr << "[ERROR] " << path << " is not a weight store (or another version)\n";
+        mapping.close();
+        return false;
+    }
+
+    // An odd sequence that does not move is a publisher that died mid-publish.
+    std::uint64_t seq = s->sequence.load(std::memory_order_acquire);
+    if ((seq & 1u) && !waitForChange(s->sequence, seq) && abandon(*s, seq))
+        std::cerr << "[WARN] " << path << ": discarded a publish interrupted at generation "
+            << seq / 2 + 1 << "\n";
+    segment = s;
+    return true;
+}
+
+void WeightStore::openLocal() {
+    mapping.close();
+    local.reset(new WeightSegment());
+    local->magic.store(0);
+    local->sequence.store(0);
+    local->count.store(0);
+    for (auto& w : local->words) w.store(0);
+    initialize(*local);
+    segment = local.get();
+}
+
+std::uint64_t WeightStore::publish(const std::vector<double>& weights) {
+    if (!segment) return 0;
+    std::size_t n = std::min(weights.size(), static_cast<std::size_t>(WEIGHT_STORE_CAPACITY));
+
+    // Claim the sequence: even -> odd marks a publish in progress.
+    std::uint64_t s = segment->sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if (s & 1u) {
+            if (!waitForChange(segment->sequence, s)) abandon(*segment, s);
+            s = segment->sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (segment->sequence.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            break;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    segment->count.store(n, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n; ++i)
+        segment->words[i].store(toBits(weights[i]), std::memory_order_relaxed);
+
+    // A CAS rather than a store: if this publish stalled past STALE_AFTER and
+    // was abandoned, the sequence has moved on and must not go back.
+    std::uint64_t claimed = s + 1;
+    if (!segment->sequence.compare_exchange_strong(claimed, s + 2, std::memory_order_release, std::memory_order_relaxed))
+        return 0;
+    return (s + 2) / 2;
+}
+
+std::uint64_t WeightStore::generation() const {
+    if (!segment) return 0;
+    return segment->sequence.load(std::memory_order_acquire) / 2;
+}
+
+std::uint64_t WeightStore::read(std::vector<double>& weights) const {
+    if (!segment) return 0;
+    std::uint64_t words[WEIGHT_STORE_CAPACITY];
+    std::uint64_t before, n;
+    for (int attempt = 0;; ++attempt) {
+        if (attempt == READ_ATTEMPTS) return 0;  // publish stuck or copies always torn
+        before = segment->sequence.load(std::memory_order_acquire);
+        if (before & 1u) { std::this_thread::yield(); continue; }
+        n = segment->count.load(std::memory_order_relaxed);
+        if (n > static_cast<std::uint64_t>(WEIGHT_STORE_CAPACITY)) n = WEIGHT_STORE_CAPACITY;
+        for (std::uint64_t i = 0; i < n; ++i)
+            words[i] = segment->words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    if (before == 0 || n == 0) return 0;
+    weights.resize(static_cast<std::size_t>(n));
+    for (std::uint64_t i = 0; i < n; ++i) weights[i] = fromBits(words[i]);
+    return before / 2;
+}
+
+bool WeightStore::refresh(std::vector<double>& weights, std::uint64_t& current) const {
+    if (generation() == current) return false;
+    std::uint64_t g = read(weights);
+    if (g == 0 || g == current) return false;
+    current = g;
+    return true;
+}
+
+// --- File watcher ---------------------------------------------------------------
+
+bool WeightFileWatcher::publishFile(const std::string& file, WeightStore& target) {
+    LearningModule learner(0.02);
+    learner.setDefaultParameters();
+    if (!WeightsIO::load(learner, file)) return false;
+    target.publish(learner.exportPlayerWeights());
+    return true;
+}
+
+bool WeightFileWatcher::start(const std::string& file, WeightStore& target, double seconds) {
+    stop();
+    if (!publishFile(file, target)) {
+        std::cerr << "[ERROR] Cannot load weights from " << file << "\n";
+        return false;
+    }
+    filename = file;
+    store = &target;
+    pollSeconds = (seconds > 0.0) ? seconds : 1.0;
+    running = true;
+    const ThreadContext context = ThreadContext::current();
+    worker = std::thread([this, context]() {
+        ContextBinding bindContext(context);
+        watch();
+    });
+    return true;
+}
+
+void WeightFileWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void WeightFileWatcher::watch() {
+#ifdef __linux__
+    // Watch the directory: editors and atomic writers replace the file.
+    std::string dir = ".", name = filename;
+    std::size_t slash = filename.find_last_of('/');
+    if (slash != std::string::npos) {
+        dir = (slash == 0) ? "/" : filename.substr(0, slash);
+        name = filename.substr(slash + 1);
+    }
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!running) break;
+            }
+            pollfd p = { fd, POLLIN, 0 };
+            if (::poll(&p, 1, 200) <= 0) continue;
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            bool changed = false;
+            for (ssize_t off = 0; off < n;) {
+                const inotify_event* e = reinterpret_cast<const inotify_event*>(buffer + off);
+                if (e->len > 0 && name == e->name) changed = true;
+                off += static_cast<ssize_t>(sizeof(inotify_event) + e->len);
+            }
+            if (changed && publishFile(filename, *store))
+                std::cerr << "[INFO] Reloaded weights from " << filename
+                    << " (generation " << store->generation() << ")\n";
+        }
+        ::close(fd);
+        return;
+    }
+    if (fd >= 0) ::close(fd);
+    std::cerr << "[WARN] inotify unavailable, polling " << filename << "\n";
+#endif
+
+    // Portable fallback: poll the modification time.
+    struct stat st;
+    long long lastTime = (::stat(filename.c_str(), &st) == 0) ? static_cast<long long>(st.st_mtime) : 0;
+    long long lastSize = (lastTime != 0) ? static_cast<long long>(st.st_size) : 0;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (running) {
+        cv.wait_for(lock, std::chrono::duration<double>(pollSeconds));
+        if (!running) break;
+        if (::stat(filename.c_str(), &st) != 0) continue;
+        if (static_cast<long long>(st.st_mtime) == lastTime && static_cast<long long>(st.st_size) == lastSize)
+            continue;
+        lastTime = static_cast<long long>(st.st_mtime);
+        lastSize = static_cast<long long>(st.st_size);
+        if (publishFile(filename, *store))
+            std::cerr << "[INFO] Reloaded weights from " << filename
+                << " (generation " << store->generation() << ")\n";
+    }
+}
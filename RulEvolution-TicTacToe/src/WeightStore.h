@@ -0,0 +1,141 @@
+#ifndef WEIGHTSTORE_H
+#define WEIGHTSTORE_H
+
+#include "MappedFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int WEIGHT_STORE_CAPACITY = 8;  ///< Weights per generation (exportPlayerWeights() uses 5)
+
+/**
+ * @struct WeightSegment
+ * @brief Layout of a weight store, identical in memory and in the mapped
+ *        file (native byte order).
+ *
+ * `sequence` is a seqlock: odd while a publish is in progress, and
+ * sequence / 2 is the generation (0 = nothing published yet). `magic` is
+ * claimed with a compare-and-swap by the process that initializes a new
+ * (zero-filled) file.
+ */
+struct WeightSegment {
+    std::atomic<std::uint64_t> magic;
+    std::uint32_t version;
+    std::uint32_t capacity;
+    alignas(64) std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> count;                          ///< Weights in the generation
+    std::atomic<std::uint64_t> words[WEIGHT_STORE_CAPACITY];   ///< Bit patterns of the weights
+};
+
+/**
+ * @class WeightStore
+ * @brief Live weights shared by any number of processes and threads.
+ *
+ * A trainer publish()es a weight vector as a new generation; readers check
+ * generation() (one load of a cache line nobody writes between publishes)
+ * and copy a new generation with read(), lock-free: a copy torn by a
+ * concurrent publish is detected by the sequence number and retried.
+ * Publishers claim the sequence with a compare-and-swap, so several
+ * trainers may share a store. A sequence left odd for longer than half a
+ * second belongs to a publisher that died mid-publish: open() and the
+ * next publish() close it with an empty generation, and readers give up
+ * after a bounded number of retries, keeping the weights they have.
+ *
+ * open() maps a file shared between processes (e.g. under /dev/shm);
+ * openLocal() keeps the segment in process memory, for a WeightFileWatcher
+ * feeding threads of one process.
+ */
+class WeightStore {
+public:
+    WeightStore() = default;
+    WeightStore(const WeightStore&) = delete;
+    WeightStore& operator=(const WeightStore&) = delete;
+
+    /**
+     * @brief Map a shared segment, creating it (empty) if missing, and close
+     *        a publish interrupted by a dead publisher.
+     * @return false if the file cannot be mapped or holds something else.
+     */
+    bool open(const std::string& path);
+
+    /// Use a process-private segment.
+    void openLocal();
+
+    bool isOpen() const { return segment != nullptr; }
+
+    /**
+     * @brief Publish a new generation.
+     * @return Its generation number (0 if the store is not open, or if this
+     *         publish stalled so long that another process discarded it).
+     */
+    std::uint64_t publish(const std::vector<double>& weights);
+
+    /// Last published generation (0 = none); cheap enough to call every match.
+    std::uint64_t generation() const;
+
+    /**
+     * @brief Consistent copy of the last generation.
+     * @return Its generation number; 0 if no weights are published or no
+     *         consistent copy was obtained within the retry bound. `weights`
+     *         is then untouched, so the caller keeps its last good copy.
+     */
+    std::uint64_t read(std::vector<double>& weights) const;
+
+    /**
+     * @brief Copy the last generation only if it is newer than `generation`.
+     * @return true if `weights` and `generation` were updated.
+     */
+    bool refresh(std::vector<double>& weights, std::uint64_t& generation) const;
+
+private:
+    MappedFile mapping;
+    std::unique_ptr<WeightSegment> local;
+    WeightSegment* segment = nullptr;
+};
+
+/**
+ * @class WeightFileWatcher
+ * @brief File-based fallback: republishes a weights file (WeightsIO format)
+ *        into a WeightStore whenever it is rewritten.
+ *
+ * Uses inotify on Linux (close-after-write and rename into place) and
+ * modification-time polling elsewhere.
+ */
+class WeightFileWatcher {
+public:
+    WeightFileWatcher() = default;
+    ~WeightFileWatcher() { stop(); }
+    WeightFileWatcher(const WeightFileWatcher&) = delete;
+    WeightFileWatcher& operator=(const WeightFileWatcher&) = delete;
+
+    /**
+     * @brief Publish the file now, then watch it from a background thread.
+     * @param pollSeconds Polling period where inotify is not available.
+     * @return false if the file cannot be loaded.
+     */
+    bool start(const std::string& filename, WeightStore& store, double pollSeconds = 1.0);
+
+    /// Stop watching (no-op if not started).
+    void stop();
+
+    /// Load the file and publish it; false if it holds no valid weight.
+    static bool publishFile(const std::string& filename, WeightStore& store);
+
+private:
+    void watch();
+
+    std::string filename;
+    WeightStore* store = nullptr;
+    double pollSeconds = 1.0;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool running = false;
+};
+
+#endif // WEIGHTSTORE_H
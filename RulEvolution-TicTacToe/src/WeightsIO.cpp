@@ -1,5 +1,6 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "WeightsIO.h"
+#include "Trace.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
@@ -16,6 +17,7 @@ static std::string nowStamp() {
 }
 
 bool WeightsIO::load(LearningModule& learner, const std::string& filename) {
+    TraceSpan span(TRACE_IO);
     std::ifstream in(filename);
     if (!in.good()) return false;
 
@@ -38,11 +40,10 @@ bool WeightsIO::load(LearningModule& learner, const std::string& filename) {
     return (loaded > 0);
 }
 
-void WeightsIO::save(const LearningModule& learner, const std::string& filename) {
-    auto weights = learner.getWeights();
-
+bool WeightsIO::save(const LearningModule& learner, const std::string& filename) {
+    TraceSpan span(TRACE_IO);
     std::ofstream out(filename, std::ios::trunc);
-    if (!out.good()) return;
+    if (!out.good()) return false;
 
     out << "# RulEvolution TicTacToe Weights v1\n";
     out << "# Saved: " << nowStamp() << "\n";
@@ -50,9 +51,8 @@ void WeightsIO::save(const LearningModule& learner, const std::string& filename)
     out << "# RULE_WIN (0) is absolute and not saved\n";
 
     auto emit = [&](RuleType rule) {
-        auto it = weights.find(rule);
-        if (it != weights.end())
-            out << (int)rule << " " << std::fixed << std::setprecision(3) << it->second << "\n";
+        if (learner.hasRule(rule))
+            out << (int)rule << " " << std::fixed << std::setprecision(3) << learner.getWeight(rule) << "\n";
         };
 
     emit(RULE_BLOCK);
@@ -60,4 +60,6 @@ void WeightsIO::save(const LearningModule& learner, const std::string& filename)
     emit(RULE_CENTER);
     emit(RULE_CORNER);
     emit(RULE_SIDE);
+    out.close();
+    return !out.fail();
 }
\ No newline at end of file
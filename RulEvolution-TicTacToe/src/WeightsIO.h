@@ -9,8 +9,8 @@ public:
     // Load weights from file (returns true if successful)
     static bool load(LearningModule& learner, const std::string& filename);
 
-    // Save current weights to file
-    static void save(const LearningModule& learner, const std::string& filename);
+    // Save current weights to file (returns true if every line was written)
+    static bool save(const LearningModule& learner, const std::string& filename);
 
 private:
     static bool isValidRuleId(int id) {